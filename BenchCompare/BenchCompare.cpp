@@ -0,0 +1,597 @@
+/*
+ * ============================================================================
+ * SmartWatch 3D - Benchmark Baseline Store and Regression Check
+ * ============================================================================
+ * Keeps benchmark results (the JSON written by --benchmark-out) in a single
+ * baseline file, keyed by scenario and machine fingerprint, and compares new
+ * runs against it.
+ *
+ * The machine fingerprint is "<host name> | <GL_RENDERER>", so results from
+ * different computers or drivers are never compared with each other.
+ *
+ * Comparison:
+ *   frame/CPU time    Mann-Whitney U test on the raw per-frame samples. A
+ *                     metric regresses when the median got slower by more
+ *                     than --threshold percent AND the difference is
+ *                     significant (p < --alpha).
+ *   GL call counters  Deterministic, so any increase above --threshold
+ *                     percent is a regression.
+ *   startup time      One sample per run; regresses above --startup-threshold.
+ *   GPU pass times    Means only (no samples); reported as WARN, never fail.
+ *   config            Settings that differ from the baseline's are WARN.
+ *
+ * USAGE (run from the SmartWatch3D directory):
+ *   BenchCompare record  RESULT.json... [--baseline FILE] [--machine NAME]
+ *   BenchCompare compare RESULT.json... [--baseline FILE] [--machine NAME]
+ *                        [--threshold PCT] [--startup-threshold PCT] [--alpha P]
+ *   BenchCompare list [--baseline FILE]
+ *
+ * Exit code: 0 = no regression, 1 = regression, 2 = usage error or
+ * missing baseline entry.
+ * ============================================================================
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>  // gethostname
+#endif
+
+// ==================== JSON ====================
+/*
+ * Just enough JSON for benchmark results and the baseline file: objects keep
+ * their key order so rewritten baselines stay diff-friendly.
+ */
+
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* get(const std::string& key) const {
+        for (const auto& m : members) {
+            if (m.first == key) return &m.second;
+        }
+        return NULL;
+    }
+
+    void set(const std::string& key, const JsonValue& value) {
+        for (auto& m : members) {
+            if (m.first == key) { m.second = value; return; }
+        }
+        members.push_back(std::make_pair(key, value));
+    }
+
+    double numberOr(const std::string& key, double fallback) const {
+        const JsonValue* v = get(key);
+        return v != NULL && v->type == NUMBER ? v->number : fallback;
+    }
+
+    std::string stringOr(const std::string& key, const std::string& fallback) const {
+        const JsonValue* v = get(key);
+        return v != NULL && v->type == STRING ? v->string : fallback;
+    }
+};
+
+static JsonValue makeString(const std::string& s) {
+    JsonValue v;
+    v.type = JsonValue::STRING;
+    v.string = s;
+    return v;
+}
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text(text), pos(0), failed(false) {}
+
+    bool parse(JsonValue& out) {
+        out = parseValue();
+        skipSpace();
+        return !failed && pos == text.size();
+    }
+
+private:
+    const std::string& text;
+    size_t pos;
+    bool failed;
+
+    void skipSpace() {
+        while (pos < text.size() && isspace((unsigned char)text[pos])) pos++;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) { pos++; return true; }
+        return false;
+    }
+
+    JsonValue fail() {
+        failed = true;
+        pos = text.size();
+        return JsonValue();
+    }
+
+    std::string parseString() {
+        std::string s;
+        pos++;  // Opening quote
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\' && pos < text.size()) {
+                char e = text[pos++];
+                if (e == 'n') c = '\n';
+                else if (e == 't') c = '\t';
+                else if (e == 'u') { c = '?'; pos += 4; }
+                else c = e;
+            }
+            s += c;
+        }
+        if (pos >= text.size()) { failed = true; return s; }
+        pos++;  // Closing quote
+        return s;
+    }
+
+    JsonValue parseValue() {
+        skipSpace();
+        if (pos >= text.size()) return fail();
+        JsonValue v;
+        char c = text[pos];
+
+        if (c == '{') {
+            pos++;
+            v.type = JsonValue::OBJECT;
+            if (consume('}')) return v;
+            do {
+                skipSpace();
+                if (pos >= text.size() || text[pos] != '"') return fail();
+                std::string key = parseString();
+                if (!consume(':')) return fail();
+                v.members.push_back(std::make_pair(key, parseValue()));
+            } while (consume(','));
+            if (!consume('}')) return fail();
+        }
+        else if (c == '[') {
+            pos++;
+            v.type = JsonValue::ARRAY;
+            if (consume(']')) return v;
+            do {
+                v.items.push_back(parseValue());
+            } while (consume(','));
+            if (!consume(']')) return fail();
+        }
+        else if (c == '"') {
+            v = makeString(parseString());
+        }
+        else if (text.compare(pos, 4, "true") == 0) { v.type = JsonValue::BOOL; v.boolean = true; pos += 4; }
+        else if (text.compare(pos, 5, "false") == 0) { v.type = JsonValue::BOOL; pos += 5; }
+        else if (text.compare(pos, 4, "null") == 0) { pos += 4; }
+        else {
+            char* end = NULL;
+            v.type = JsonValue::NUMBER;
+            v.number = strtod(text.c_str() + pos, &end);
+            if (end == text.c_str() + pos) return fail();
+            pos = end - text.c_str();
+        }
+        return v;
+    }
+};
+
+static void writeJson(std::ostream& out, const JsonValue& v, int indent) {
+    std::string pad(indent * 2, ' ');
+    switch (v.type) {
+    case JsonValue::NUL: out << "null"; break;
+    case JsonValue::BOOL: out << (v.boolean ? "true" : "false"); break;
+    case JsonValue::NUMBER: {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.6g", v.number);
+        out << buf;
+        break;
+    }
+    case JsonValue::STRING:
+        out << '"';
+        for (char c : v.string) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+        break;
+    case JsonValue::ARRAY: {
+        // Number arrays (samples) stay on one line
+        bool flat = std::all_of(v.items.begin(), v.items.end(),
+            [](const JsonValue& i) { return i.type == JsonValue::NUMBER; });
+        out << "[";
+        for (size_t i = 0; i < v.items.size(); i++) {
+            if (i) out << ",";
+            if (flat) out << (i ? " " : "");
+            else out << "\n" << pad << "  ";
+            writeJson(out, v.items[i], indent + 1);
+        }
+        if (!flat && !v.items.empty()) out << "\n" << pad;
+        out << "]";
+        break;
+    }
+    case JsonValue::OBJECT:
+        out << "{";
+        for (size_t i = 0; i < v.members.size(); i++) {
+            out << (i ? ",\n" : "\n") << pad << "  \"" << v.members[i].first << "\": ";
+            writeJson(out, v.members[i].second, indent + 1);
+        }
+        if (!v.members.empty()) out << "\n" << pad;
+        out << "}";
+        break;
+    }
+}
+
+static bool loadJson(const std::string& path, JsonValue& out) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream ss;
+    ss << file.rdbuf();
+    std::string text = ss.str();
+    JsonParser parser(text);
+    if (!parser.parse(out)) {
+        std::cout << "Error: \"" << path << "\" is not valid JSON" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ==================== STATISTICS ====================
+
+static std::vector<double> numbers(const JsonValue* array) {
+    std::vector<double> out;
+    if (array == NULL) return out;
+    for (const JsonValue& v : array->items) {
+        if (v.type == JsonValue::NUMBER) out.push_back(v.number);
+    }
+    return out;
+}
+
+static double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/**
+ * Two-sided Mann-Whitney U test (normal approximation with tie correction)
+ * Good enough for the 60+ samples a benchmark run records
+ *
+ * @return p-value that both sample sets come from the same distribution
+ */
+static double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    size_t n1 = a.size(), n2 = b.size();
+    if (n1 < 2 || n2 < 2) return 1.0;
+
+    std::vector<std::pair<double, int>> all;
+    for (double v : a) all.push_back(std::make_pair(v, 0));
+    for (double v : b) all.push_back(std::make_pair(v, 1));
+    std::sort(all.begin(), all.end());
+
+    // Average ranks over ties; collect the tie correction term
+    double rankSumA = 0.0, tieTerm = 0.0;
+    size_t n = all.size();
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && all[j].first == all[i].first) j++;
+        double rank = 0.5 * (i + 1 + j);  // Mean of ranks i+1 .. j
+        for (size_t k = i; k < j; k++) {
+            if (all[k].second == 0) rankSumA += rank;
+        }
+        double t = (double)(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSumA - n1 * (n1 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / ((double)n * (n - 1)));
+    if (variance <= 0.0) return 1.0;
+
+    double z = (fabs(u - mean) - 0.5) / sqrt(variance);  // Continuity correction
+    if (z < 0.0) z = 0.0;
+    return erfc(z / sqrt(2.0));
+}
+
+// ==================== BASELINE ====================
+
+struct Options {
+    std::string command;
+    std::vector<std::string> results;
+    std::string baselinePath = "benchmark_baseline.json";
+    std::string machine;
+    double thresholdPct = 5.0;
+    double startupThresholdPct = 25.0;
+    double alpha = 0.01;
+};
+
+static std::string hostName() {
+    char name[256] = "";
+#ifdef _WIN32
+    const char* env = getenv("COMPUTERNAME");
+    if (env != NULL) snprintf(name, sizeof(name), "%s", env);
+#else
+    gethostname(name, sizeof(name) - 1);
+#endif
+    return name[0] ? name : "unknown-host";
+}
+
+static std::string fingerprint(const Options& options, const JsonValue& result) {
+    if (!options.machine.empty()) return options.machine;
+    return hostName() + " | " + result.stringOr("renderer", "unknown-renderer");
+}
+
+static JsonValue* findEntry(JsonValue& baseline, const std::string& scenario, const std::string& machine) {
+    JsonValue* entries = NULL;
+    for (auto& m : baseline.members) {
+        if (m.first == "entries") entries = &m.second;
+    }
+    if (entries == NULL) return NULL;
+    for (JsonValue& e : entries->items) {
+        if (e.stringOr("scenario", "") == scenario && e.stringOr("machine", "") == machine) return &e;
+    }
+    return NULL;
+}
+
+static int recordResults(const Options& options) {
+    // A fresh baseline only when there is none yet: one that does not parse
+    // holds recorded history, so it is reported instead of overwritten
+    JsonValue baseline;
+    baseline.type = JsonValue::OBJECT;
+    if (std::ifstream(options.baselinePath)) {
+        if (!loadJson(options.baselinePath, baseline) || baseline.type != JsonValue::OBJECT) {
+            std::cout << "Error: baseline \"" << options.baselinePath << "\" is unreadable; fix or move it, nothing recorded"
+                << std::endl;
+            return 2;
+        }
+    }
+    if (baseline.get("entries") == NULL) {
+        JsonValue entries;
+        entries.type = JsonValue::ARRAY;
+        baseline.set("entries", entries);
+    }
+
+    for (const std::string& path : options.results) {
+        JsonValue result;
+        if (!loadJson(path, result)) {
+            std::cout << "Error: cannot read \"" << path << "\"" << std::endl;
+            return 2;
+        }
+        std::string scenario = result.stringOr("scenario", "default");
+        std::string machine = fingerprint(options, result);
+
+        char date[32];
+        time_t now = time(NULL);
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+        JsonValue entry;
+        entry.type = JsonValue::OBJECT;
+        entry.set("scenario", makeString(scenario));
+        entry.set("machine", makeString(machine));
+        entry.set("recorded", makeString(date));
+        entry.set("result", result);
+
+        JsonValue* existing = findEntry(baseline, scenario, machine);
+        if (existing != NULL) *existing = entry;
+        else {
+            for (auto& m : baseline.members) {
+                if (m.first == "entries") m.second.items.push_back(entry);
+            }
+        }
+        std::cout << "Recorded " << scenario << " for " << machine << std::endl;
+    }
+
+    std::ofstream out(options.baselinePath);
+    writeJson(out, baseline, 0);
+    out << "\n";
+    return 0;
+}
+
+// ==================== COMPARISON ====================
+
+enum Verdict { VERDICT_OK, VERDICT_WARN, VERDICT_REGRESSION };
+
+static const char* verdictName(Verdict v) {
+    return v == VERDICT_OK ? "ok" : (v == VERDICT_WARN ? "WARN" : "REGRESSION");
+}
+
+static double percentChange(double base, double now) {
+    if (base == 0.0) return now == 0.0 ? 0.0 : 100.0;
+    return (now - base) / base * 100.0;
+}
+
+static void printRow(const std::string& metric, double base, double now, double p, Verdict v) {
+    char pText[16] = "-";
+    if (p >= 0.0) snprintf(pText, sizeof(pText), "%.4f", p);
+    printf("  %-28s %10.3f %10.3f %+8.1f%% %8s  %s\n", metric.c_str(), base, now,
+        percentChange(base, now), pText, verdictName(v));
+}
+
+/**
+ * Compares one result with its baseline entry
+ * @return worst verdict over all metrics
+ */
+static Verdict compareResult(const Options& options, const JsonValue& base, const JsonValue& now) {
+    Verdict worst = VERDICT_OK;
+    auto note = [&](Verdict v) { if (v > worst) worst = v; };
+
+    // Runs with different settings (the "config" member) measure different work
+    const JsonValue* baseConfig = base.get("config");
+    const JsonValue* nowConfig = now.get("config");
+    if (baseConfig != NULL && nowConfig != NULL) {
+        for (const auto& m : baseConfig->members) {
+            std::ostringstream a, b;
+            writeJson(a, m.second, 0);
+            const JsonValue* value = nowConfig->get(m.first);
+            if (value != NULL) writeJson(b, *value, 0);
+            if (a.str() == b.str()) continue;
+            std::cout << "  WARN config." << m.first << " differs: " << a.str() << " -> "
+                << (value != NULL ? b.str() : "missing") << std::endl;
+            note(VERDICT_WARN);
+        }
+    }
+
+    printf("  %-28s %10s %10s %9s %8s  %s\n", "METRIC", "BASELINE", "NEW", "DELTA", "P", "STATUS");
+
+    // Sampled metrics: significance test on the raw samples, compared by median
+    const char* sampled[][2] = {
+        { "frame_time_samples_ms", "frame_time_ms (median)" },
+        { "cpu_time_samples_ms", "cpu_time_ms (median)" },
+    };
+    for (const auto& s : sampled) {
+        std::vector<double> a = numbers(base.get(s[0]));
+        std::vector<double> b = numbers(now.get(s[0]));
+        if (a.empty() || b.empty()) continue;
+
+        double p = mannWhitneyP(a, b);
+        double medA = median(a), medB = median(b);
+        Verdict v = VERDICT_OK;
+        if (percentChange(medA, medB) > options.thresholdPct && p < options.alpha) v = VERDICT_REGRESSION;
+        note(v);
+        printRow(s[1], medA, medB, p, v);
+    }
+
+    // Percentiles for context only, the test above decides
+    const JsonValue* baseFrame = base.get("frame_time_ms");
+    const JsonValue* nowFrame = now.get("frame_time_ms");
+    if (baseFrame != NULL && nowFrame != NULL) {
+        printRow("frame_time_ms (p99)", baseFrame->numberOr("p99", 0.0), nowFrame->numberOr("p99", 0.0), -1.0, VERDICT_OK);
+    }
+
+    double baseStartup = base.numberOr("startup_ms", 0.0);
+    double nowStartup = now.numberOr("startup_ms", 0.0);
+    if (baseStartup > 0.0 && nowStartup > 0.0) {
+        Verdict v = percentChange(baseStartup, nowStartup) > options.startupThresholdPct ? VERDICT_REGRESSION : VERDICT_OK;
+        note(v);
+        printRow("startup_ms", baseStartup, nowStartup, -1.0, v);
+    }
+
+    // Deterministic counters: more GL calls per frame is a regression
+    const JsonValue* baseCounters = base.get("gl_counters");
+    const JsonValue* nowCounters = now.get("gl_counters");
+    if (baseCounters != NULL && nowCounters != NULL) {
+        for (const auto& m : baseCounters->members) {
+            double a = m.second.number;
+            double b = nowCounters->numberOr(m.first, a);
+            Verdict v = (percentChange(a, b) > options.thresholdPct && b - a >= 0.5) ? VERDICT_REGRESSION : VERDICT_OK;
+            note(v);
+            printRow("gl." + m.first, a, b, -1.0, v);
+        }
+    }
+
+    // GPU pass means have no samples, so they can only warn
+    const JsonValue* baseGpu = base.get("gpu_pass_ms");
+    const JsonValue* nowGpu = now.get("gpu_pass_ms");
+    if (baseGpu != NULL && nowGpu != NULL) {
+        for (const auto& m : baseGpu->members) {
+            double a = m.second.number;
+            double b = nowGpu->numberOr(m.first, a);
+            Verdict v = percentChange(a, b) > options.thresholdPct && b - a > 0.01 ? VERDICT_WARN : VERDICT_OK;
+            note(v);
+            printRow("gpu." + m.first, a, b, -1.0, v);
+        }
+    }
+    return worst;
+}
+
+static int compareResults(const Options& options) {
+    JsonValue baseline;
+    if (!loadJson(options.baselinePath, baseline)) {
+        std::cout << "Error: no baseline at \"" << options.baselinePath << "\" (run 'record' first)" << std::endl;
+        return 2;
+    }
+
+    int regressions = 0, missing = 0;
+    for (const std::string& path : options.results) {
+        JsonValue result;
+        if (!loadJson(path, result)) {
+            std::cout << "Error: cannot read \"" << path << "\"" << std::endl;
+            return 2;
+        }
+        std::string scenario = result.stringOr("scenario", "default");
+        std::string machine = fingerprint(options, result);
+        std::cout << scenario << " on " << machine << std::endl;
+
+        JsonValue* entry = findEntry(baseline, scenario, machine);
+        const JsonValue* base = entry != NULL ? entry->get("result") : NULL;
+        if (base == NULL) {
+            std::cout << "  No baseline for this scenario and machine" << std::endl;
+            missing++;
+            continue;
+        }
+        std::cout << "  Baseline recorded " << entry->stringOr("recorded", "?") << std::endl;
+        if (compareResult(options, *base, result) == VERDICT_REGRESSION) regressions++;
+    }
+
+    if (regressions > 0) {
+        std::cout << regressions << " scenario(s) regressed." << std::endl;
+        return 1;
+    }
+    if (missing > 0) return 2;
+    std::cout << "No regressions." << std::endl;
+    return 0;
+}
+
+static int listEntries(const Options& options) {
+    JsonValue baseline;
+    if (!loadJson(options.baselinePath, baseline) || baseline.get("entries") == NULL) {
+        std::cout << "No baseline at \"" << options.baselinePath << "\"" << std::endl;
+        return 2;
+    }
+    for (const JsonValue& e : baseline.get("entries")->items) {
+        printf("%-20s %-19s %s\n", e.stringOr("scenario", "?").c_str(),
+            e.stringOr("recorded", "?").c_str(), e.stringOr("machine", "?").c_str());
+    }
+    return 0;
+}
+
+// ==================== MAIN ====================
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    if (argc < 2) return false;
+    options.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--baseline" && hasValue) options.baselinePath = argv[++i];
+        else if (arg == "--machine" && hasValue) options.machine = argv[++i];
+        else if (arg == "--threshold" && hasValue) options.thresholdPct = atof(argv[++i]);
+        else if (arg == "--startup-threshold" && hasValue) options.startupThresholdPct = atof(argv[++i]);
+        else if (arg == "--alpha" && hasValue) options.alpha = atof(argv[++i]);
+        else if (arg.compare(0, 2, "--") == 0) {
+            std::cout << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+        else options.results.push_back(arg);
+    }
+    if (options.command == "list") return true;
+    return (options.command == "record" || options.command == "compare") && !options.results.empty();
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::cout << "Usage: BenchCompare record|compare RESULT.json... [--baseline FILE] [--machine NAME]" << std::endl;
+        std::cout << "                    [--threshold PCT] [--startup-threshold PCT] [--alpha P]" << std::endl;
+        std::cout << "       BenchCompare list [--baseline FILE]" << std::endl;
+        return 2;
+    }
+
+    if (options.command == "record") return recordResults(options);
+    if (options.command == "compare") return compareResults(options);
+    return listEntries(options);
+}
@@ -0,0 +1,613 @@
+/*
+ * ============================================================================
+ * SmartWatch 3D - CPU Microbenchmarks
+ * ============================================================================
+ * Google Benchmark suite for the CPU hot paths of the simulator. Only the
+ * pure CPU halves are measured here (TextureGen.cpp, Canvas.cpp, Scene.cpp,
+ * Entities.cpp, Hierarchy.cpp, WatchUi.cpp, SoftRaster.cpp, DisplayFormat.cpp,
+ * DisplayLink.cpp and VertexPull.cpp never call OpenGL); the matching GL uploads
+ * are measured in the running app by the profiler (texture_uploads /
+ * buffer_bytes counters and GPU pass timers).
+ *
+ * Benchmarks:
+ *   BM_DigitImage/N        generateDigitImage for strings of N characters
+ *                          (2 = BPM, 3 = battery, 8 = HH:MM:SS clock)
+ *   BM_EKGImage            generateEKGImage
+ *   BM_GroundImage         generateGroundImage
+ *   BM_RoadImage           generateRoadImage
+ *   BM_BuildingFacades     generateBuildingFacades (the texture array layers)
+ *   BM_StudentInfoImage    generateStudentInfoImage (background fill + glyphs)
+ *   BM_BlitString/scale    blitString of one 16 character line
+ *   BM_Clear{PerPixel,Canvas}/channels
+ *                          256x256 clear: per-pixel loop vs canvasClear
+ *   BM_FillRect{PerPixel,Canvas}/size
+ *                          8x8 grid of size x size rectangles, the outer
+ *                          ones clipped: setPixel lambda vs canvasFillRect
+ *   BM_Glyphs{PerPixel,Canvas}/scale
+ *                          16 glyphs: setPixel lambda vs canvasDrawString
+ *   BM_GenerateBuildings   generateSceneEntities (buildings and watch rig)
+ *   BM_SceneTransforms/m   buildSceneTransforms (m: 0 = wrist, 1 = watch view)
+ *   BM_RigTransforms/d     transformUpdate of the watch rig (d: 0 = nothing
+ *                          changed, 1 = camera moved, all nodes dirty);
+ *                          fails if the rig's pose differs from the
+ *                          per-entity formulas it replaced
+ *   BM_EntityCull          entityCull of the scene against the camera frustum
+ *   BM_SceneInstances      the vertex_pull instance array of one scene pass
+ *                          (ground, road, visible buildings); bytes is what
+ *                          each pass uploads
+ *   BM_VertexPoolAddMesh/l vertexPoolAddMesh of an indexed 64x64 quad grid
+ *                          in layout l (0 = position/normal/texcoord, 1 = 2D
+ *                          position and texcoord, no normal); fails if a
+ *                          mixed-format mesh is expanded wrongly
+ *   BM_SoftWatchUi/s/t     softWatchUiRender of watch screen s (0 = clock,
+ *                          1 = heart rate, 2 = battery, 3 = performance) at
+ *                          512x512 on t threads; the GL path it replaces is
+ *                          the watch_ui GPU pass of a watch_ui=gl run
+ *   BM_DisplayConvert/f/d  displayConvert of the heart rate screen at 512x512
+ *                          to format f (1 = RGB565, 2 = RGB444) with dither
+ *                          d (0 = none, 1 = ordered, 2 = blue noise)
+ *   BM_DisplayLink/s/f     displayLinkPush of screen s while it animates
+ *                          (clock ticking, EKG scrolling), 512x512, frames
+ *                          in format f (0 = RGBA, 1/2 as above); counters
+ *                          give the bytes and changed tiles per frame
+ *
+ * USAGE:
+ *   Benchmarks [--benchmark_filter=REGEX] [--benchmark_repetitions=N]
+ *              [--benchmark_format=json] [--benchmark_out=FILE]
+ * Build in Release; Debug numbers are meaningless for comparisons.
+ * ============================================================================
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TextureGen.h"
+#include "Canvas.h"
+#include "DisplayFormat.h"
+#include "DisplayLink.h"
+#include "Scene.h"
+#include "SoftRaster.h"
+#include "VertexPull.h"
+#include "WatchUi.h"
+
+// ==================== TEXTURE GENERATION ====================
+
+static void BM_DigitImage(benchmark::State& state) {
+    // Same character mix the clock uses: digits with a colon every third char
+    std::string str;
+    for (int i = 0; i < state.range(0); i++) {
+        str += (i % 3 == 2) ? ':' : (char)('0' + (i * 7) % 10);
+    }
+
+    Image image;
+    for (auto _ : state) {
+        generateDigitImage(image, str.c_str());
+        benchmark::DoNotOptimize(image.pixels.data());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)image.pixels.size());
+}
+BENCHMARK(BM_DigitImage)->Arg(1)->Arg(2)->Arg(3)->Arg(5)->Arg(8);
+
+// Benchmark for generators without parameters; bytes = size of the generated image
+static void runImageBenchmark(benchmark::State& state, void (*generate)(Image&)) {
+    Image image;
+    for (auto _ : state) {
+        generate(image);
+        benchmark::DoNotOptimize(image.pixels.data());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)image.pixels.size());
+}
+
+static void BM_EKGImage(benchmark::State& state) { runImageBenchmark(state, generateEKGImage); }
+static void BM_GroundImage(benchmark::State& state) { runImageBenchmark(state, generateGroundImage); }
+static void BM_RoadImage(benchmark::State& state) { runImageBenchmark(state, generateRoadImage); }
+static void generateFacades(Image& image) { generateBuildingFacades(image, BUILDING_FACADES); }
+static void BM_BuildingFacades(benchmark::State& state) { runImageBenchmark(state, generateFacades); }
+static void BM_StudentInfoImage(benchmark::State& state) { runImageBenchmark(state, generateStudentInfoImage); }
+BENCHMARK(BM_EKGImage);
+BENCHMARK(BM_GroundImage);
+BENCHMARK(BM_RoadImage);
+BENCHMARK(BM_BuildingFacades);
+BENCHMARK(BM_StudentInfoImage);
+
+static void BM_BlitString(benchmark::State& state) {
+    const int width = 256;
+    const int height = 64;
+    const int scale = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)width * height * 4, 0);
+
+    for (auto _ : state) {
+        blitString(data.data(), width, height, "Nikola Bandulaja", 10, 50, scale, 255, 255, 255);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 16);  // Glyphs
+}
+BENCHMARK(BM_BlitString)->Arg(1)->Arg(2)->Arg(4);
+
+// ==================== CANVAS VS PER-PIXEL ====================
+// The *PerPixel variants are the bounds-checked setPixel lambdas the
+// generators used before Canvas, kept here as the baseline
+
+static void BM_ClearPerPixel(benchmark::State& state) {
+    const int size = 256;
+    const int channels = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)size * size * channels);
+    const unsigned char color[4] = { 30, 30, 50, 180 };
+
+    for (auto _ : state) {
+        for (int i = 0; i < size * size * channels; i += channels) {
+            for (int c = 0; c < channels; c++) data[i + c] = color[c];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)data.size());
+}
+BENCHMARK(BM_ClearPerPixel)->Arg(3)->Arg(4);
+
+static void BM_ClearCanvas(benchmark::State& state) {
+    const int size = 256;
+    const int channels = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)size * size * channels);
+    Canvas canvas = makeCanvas(data.data(), size, size, channels);
+    const CanvasColor color = { 30, 30, 50, 180 };
+
+    for (auto _ : state) {
+        canvasClear(canvas, color);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)data.size());
+}
+BENCHMARK(BM_ClearCanvas)->Arg(3)->Arg(4);
+
+// A grid of rectangles stepping across a 256x256 RGBA canvas and past its edges
+static const int RECT_GRID = 8;
+static const int RECT_STEP = 40;
+
+static void BM_FillRectPerPixel(benchmark::State& state) {
+    const int width = 256;
+    const int height = 256;
+    const int size = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)width * height * 4);
+
+    auto setPixel = [&](int x, int y) {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            int idx = (y * width + x) * 4;
+            data[idx] = 200;
+            data[idx + 1] = 230;
+            data[idx + 2] = 255;
+            data[idx + 3] = 255;
+        }
+    };
+
+    for (auto _ : state) {
+        for (int gy = 0; gy < RECT_GRID; gy++) {
+            for (int gx = 0; gx < RECT_GRID; gx++) {
+                for (int y = 0; y < size; y++) {
+                    for (int x = 0; x < size; x++) {
+                        setPixel(gx * RECT_STEP + x, gy * RECT_STEP + y);
+                    }
+                }
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * RECT_GRID * RECT_GRID);
+}
+BENCHMARK(BM_FillRectPerPixel)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_FillRectCanvas(benchmark::State& state) {
+    const int width = 256;
+    const int height = 256;
+    const int size = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)width * height * 4);
+    Canvas canvas = makeCanvas(data.data(), width, height, 4);
+    const CanvasColor color = { 200, 230, 255, 255 };
+
+    for (auto _ : state) {
+        for (int gy = 0; gy < RECT_GRID; gy++) {
+            for (int gx = 0; gx < RECT_GRID; gx++) {
+                canvasFillRect(canvas, gx * RECT_STEP, gy * RECT_STEP, size, size, color);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * RECT_GRID * RECT_GRID);
+}
+BENCHMARK(BM_FillRectCanvas)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_GlyphsPerPixel(benchmark::State& state) {
+    const int width = 256;
+    const int height = 64;
+    const int scale = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)width * height * 4, 0);
+
+    auto setPixel = [&](int x, int y) {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            int idx = (y * width + x) * 4;
+            data[idx] = 255;
+            data[idx + 1] = 255;
+            data[idx + 2] = 255;
+            data[idx + 3] = 255;
+        }
+    };
+
+    for (auto _ : state) {
+        int x = 10;
+        for (const char* str = "Nikola Bandulaja"; *str; str++) {
+            unsigned char c = (unsigned char)*str;
+            for (int row = 0; row < 7; row++) {
+                for (int col = 0; col < 5; col++) {
+                    if (FONT_DATA[c][row] & (0x10 >> col)) {
+                        for (int sy = 0; sy < scale; sy++) {
+                            for (int sx = 0; sx < scale; sx++) {
+                                setPixel(x + col * scale + sx, 50 - row * scale - sy);
+                            }
+                        }
+                    }
+                }
+            }
+            x += 6 * scale;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_GlyphsPerPixel)->Arg(1)->Arg(2)->Arg(4);
+
+static void BM_GlyphsCanvas(benchmark::State& state) {
+    const int width = 256;
+    const int height = 64;
+    const int scale = (int)state.range(0);
+    std::vector<unsigned char> data((size_t)width * height * 4, 0);
+    Canvas canvas = makeCanvas(data.data(), width, height, 4);
+    const CanvasColor color = { 255, 255, 255, 255 };
+
+    for (auto _ : state) {
+        canvasDrawString(canvas, "Nikola Bandulaja", 10, 50, scale, color);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_GlyphsCanvas)->Arg(1)->Arg(2)->Arg(4);
+
+// ==================== SCENE ====================
+
+static void BM_GenerateBuildings(benchmark::State& state) {
+    SceneEntities scene;
+    for (auto _ : state) {
+        generateSceneEntities(scene);
+        benchmark::DoNotOptimize(scene.store.posX.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * buildingsPerSide);
+}
+BENCHMARK(BM_GenerateBuildings);
+
+static void BM_SceneTransforms(benchmark::State& state) {
+    SceneEntities scene;
+    generateSceneEntities(scene);
+    SceneTransforms transforms;
+    bool watchView = state.range(0) != 0;
+
+    // Advance the scroll offset like a running frame so the wrap loops are exercised
+    float groundOffset = 0.0f;
+    for (auto _ : state) {
+        groundOffset += 0.15f;
+        if (groundOffset > GROUND_SEGMENT_LENGTH) groundOffset -= GROUND_SEGMENT_LENGTH;
+        buildSceneTransforms(transforms, scene, glm::vec3(0.0f, 1.6f, 0.0f), watchView, groundOffset, 0.02f);
+        benchmark::DoNotOptimize(scene.store.model.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)(2 * groundSegmentCount + entityCount(scene.store)));
+}
+BENCHMARK(BM_SceneTransforms)->Arg(0)->Arg(1);
+
+// An entity's model matrix as the rig computed it before the hierarchy: camera-space offset, rotation, scale
+static glm::mat4 baselinePose(const EntityStore& store, EntityId id, const glm::vec3& position, float rotX, float rotY) {
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), position);
+    if (rotX != 0.0f) m = glm::rotate(m, glm::radians(rotX), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (rotY != 0.0f) m = glm::rotate(m, glm::radians(rotY), glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::scale(m, glm::vec3(store.scaleX[id], store.scaleY[id], store.scaleZ[id]));
+}
+
+static bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            if (fabsf(a[c][r] - b[c][r]) > 1.0e-5f) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Whether the hierarchy poses the rig exactly (to float rounding) as the
+ * per-entity formulas did, in both view modes, bobbing or not
+ */
+static bool rigMatchesBaseline(SceneEntities& scene) {
+    const EntityStore& store = scene.store;
+    SceneTransforms transforms;
+    for (int watchView = 0; watchView < 2; watchView++) {
+        for (float bob : { 0.0f, 0.03f, -0.05f }) {
+            glm::vec3 viewPos(0.3f, 1.6f + bob, 2.0f);
+            buildSceneTransforms(transforms, scene, viewPos, watchView != 0, 0.0f, bob);
+
+            glm::mat4 hand, frame, screen;
+            glm::vec3 light;
+            if (watchView) {
+                hand = baselinePose(store, scene.hand, viewPos + glm::vec3(0.0f, -0.3f, -0.6f), -30.0f, 0.0f);
+                frame = baselinePose(store, scene.watchFrame, viewPos + glm::vec3(0.0f, 0.0f, -0.5f), 0.0f, 0.0f);
+                screen = baselinePose(store, scene.watchScreen, viewPos + glm::vec3(0.0f, 0.0f, -0.48f), 0.0f, 0.0f);
+                light = viewPos + glm::vec3(0.0f, 0.0f, -0.5f);
+            }
+            else {
+                hand = baselinePose(store, scene.hand, viewPos + glm::vec3(0.4f, -0.4f + bob * 0.5f, -0.3f), -45.0f, 30.0f);
+                frame = baselinePose(store, scene.watchFrame, viewPos + glm::vec3(0.4f, -0.3f + bob, -0.3f), -45.0f, 30.0f);
+                screen = baselinePose(store, scene.watchScreen, viewPos + glm::vec3(0.4f, -0.3f + bob, -0.28f), -45.0f, 30.0f);
+                light = viewPos + glm::vec3(0.4f, -0.3f + bob, -0.3f);
+            }
+            if (!nearlyEqual(store.model[scene.hand], hand) || !nearlyEqual(store.model[scene.watchFrame], frame) ||
+                !nearlyEqual(store.model[scene.watchScreen], screen) ||
+                glm::length(transforms.watchLightPos - light) > 1.0e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void BM_RigTransforms(benchmark::State& state) {
+    SceneEntities scene;
+    generateSceneEntities(scene);
+    if (!rigMatchesBaseline(scene)) {
+        state.SkipWithError("rig pose differs from the per-entity formulas");
+        return;
+    }
+    bool moving = state.range(0) != 0;
+    glm::vec3 viewPos(0.0f, 1.6f, 0.0f);
+    transformUpdate(scene.rig, scene.store);
+
+    int updated = 0;
+    for (auto _ : state) {
+        if (moving) {
+            viewPos.y = viewPos.y > 1.7f ? 1.6f : viewPos.y + 0.001f;
+            transformSetLocal(scene.rig, scene.cameraNode, viewPos, 0.0f, 0.0f);
+        }
+        updated = transformUpdate(scene.rig, scene.store);
+        benchmark::DoNotOptimize(scene.store.model.data());
+    }
+    state.counters["updated"] = (double)updated;
+}
+BENCHMARK(BM_RigTransforms)->Arg(0)->Arg(1);
+
+static void BM_EntityCull(benchmark::State& state) {
+    SceneEntities scene;
+    generateSceneEntities(scene);
+    SceneTransforms transforms;
+    glm::vec3 viewPos(0.0f, 1.6f, 0.0f);
+    buildSceneTransforms(transforms, scene, viewPos, false, 0.0f, 0.0f);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(viewPos, viewPos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+
+    int visible = 0;
+    for (auto _ : state) {
+        visible = entityCull(scene.store, viewProjection);
+        benchmark::DoNotOptimize(scene.store.flags.data());
+    }
+    state.counters["visible"] = (double)visible;
+    state.SetItemsProcessed(state.iterations() * (int64_t)entityCount(scene.store));
+}
+BENCHMARK(BM_EntityCull);
+
+static void BM_SceneInstances(benchmark::State& state) {
+    SceneEntities scene;
+    generateSceneEntities(scene);
+    SceneTransforms transforms;
+    glm::vec3 viewPos(0.0f, 1.6f, 0.0f);
+    buildSceneTransforms(transforms, scene, viewPos, false, 0.0f, 0.0f);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(viewPos, viewPos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    entityCull(scene.store, projection * view);
+
+    VertexPool pool;
+    const EntityStore& entities = scene.store;
+    for (auto _ : state) {
+        vertexPoolClearInstances(pool);
+        DrawBatch ground = vertexPoolBeginBatch(pool);
+        for (const glm::mat4& model : transforms.ground) vertexPoolAddInstance(pool, ground, model, glm::vec3(1.0f));
+        DrawBatch road = vertexPoolBeginBatch(pool);
+        for (const glm::mat4& model : transforms.road) vertexPoolAddInstance(pool, road, model, glm::vec3(1.0f));
+        DrawBatch buildings = vertexPoolBeginBatch(pool);
+        for (int i = 0; i < scene.buildingCount; i++) {
+            if (!(entities.flags[i] & ENTITY_VISIBLE)) continue;
+            vertexPoolAddInstance(pool, buildings, entities.model[i], entities.color[i], (float)entities.variant[i]);
+        }
+        benchmark::DoNotOptimize(pool.instances.data());
+    }
+    state.counters["bytes"] = (double)(pool.instances.size() * sizeof(glm::vec4));
+    state.SetItemsProcessed(state.iterations() * (int64_t)(pool.instances.size() / PULL_TEXELS_PER_INSTANCE));
+}
+BENCHMARK(BM_SceneInstances);
+
+// The screen quad's format: 2D position and texcoord, no normal
+const VertexLayout VERTEX_LAYOUT_2D_UV = { 4, 2, -1, 2 };
+
+// An n x n grid of quads on z = 0 in layout, as triangle list indices
+static void buildGrid(int n, const VertexLayout& layout, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    vertices.assign((size_t)(n + 1) * (n + 1) * layout.stride, 0.0f);
+    for (int y = 0; y <= n; y++) {
+        for (int x = 0; x <= n; x++) {
+            float* v = &vertices[(size_t)(y * (n + 1) + x) * layout.stride];
+            v[0] = (float)x / n;
+            v[1] = (float)y / n;
+            if (layout.normalOffset >= 0) v[layout.normalOffset + 2] = 1.0f;
+            v[layout.texCoordOffset] = v[0];
+            v[layout.texCoordOffset + 1] = v[1];
+        }
+    }
+    indices.clear();
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            unsigned int i = (unsigned int)(y * (n + 1) + x);
+            unsigned int quad[6] = { i, i + 1, i + n + 2, i, i + n + 2, i + n + 1 };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+/**
+ * Whether a 2D, normal-less quad pooled after a PNT triangle comes out in
+ * the common layout: z = 0, normal (0, 0, 1), texcoord in the w components
+ */
+static bool mixedLayoutExpands() {
+    const float triangle[] = {
+        0.0f, 0.0f, 0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
+        1.0f, 0.0f, 0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
+        0.0f, 1.0f, 0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
+    };
+    const float quad[] = {
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f,
+        -1.0f,  1.0f,  0.0f, 1.0f,
+    };
+    const unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    VertexPool pool;
+    vertexPoolAddMesh(pool, triangle, VERTEX_LAYOUT_PNT, NULL, 3);
+    PulledMesh mesh = vertexPoolAddMesh(pool, quad, VERTEX_LAYOUT_2D_UV, indices, 6);
+    if (mesh.first != 3 || mesh.count != 6 || pool.vertices.size() != (size_t)9 * PULL_TEXELS_PER_VERTEX) return false;
+
+    for (int i = 0; i < mesh.count; i++) {
+        const float* v = quad + indices[i] * 4;
+        const glm::vec4& a = pool.vertices[(size_t)(mesh.first + i) * PULL_TEXELS_PER_VERTEX];
+        const glm::vec4& b = pool.vertices[(size_t)(mesh.first + i) * PULL_TEXELS_PER_VERTEX + 1];
+        if (a != glm::vec4(v[0], v[1], 0.0f, v[2]) || b != glm::vec4(0.0f, 0.0f, 1.0f, v[3])) return false;
+    }
+    // The triangle before it keeps its own normal
+    return pool.vertices[1] == glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+static void BM_VertexPoolAddMesh(benchmark::State& state) {
+    if (!mixedLayoutExpands()) {
+        state.SkipWithError("2D normal-less mesh expanded wrongly");
+        return;
+    }
+    const VertexLayout& layout = state.range(0) == 0 ? VERTEX_LAYOUT_PNT : VERTEX_LAYOUT_2D_UV;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    buildGrid(64, layout, vertices, indices);
+
+    VertexPool pool;
+    for (auto _ : state) {
+        pool.vertices.clear();
+        vertexPoolAddMesh(pool, vertices.data(), layout, indices.data(), (int)indices.size());
+        benchmark::DoNotOptimize(pool.vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)indices.size());
+}
+BENCHMARK(BM_VertexPoolAddMesh)->Arg(0)->Arg(1);
+
+// ==================== WATCH UI ====================
+
+static void BM_SoftWatchUi(benchmark::State& state) {
+    SoftWatchUi ui;
+    softWatchUiInit(ui, (int)state.range(1));
+
+    // BPM over 200 (warning overlay on the heart rate screen), cursor over the screen
+    WatchUiFrame frame = {};
+    frame.screen = (int)state.range(0);
+    watchUiSetText(frame, 12, 34, 56, 210.0f, 15);
+    frame.bpm = 210.0f;
+    frame.ekgScale = 0.8f;
+    frame.ekgOffset = 0.3f;
+    frame.batteryPercent = 15;
+    frame.showCursor = true;
+    frame.cursorX = 0.2f;
+    frame.cursorY = -0.3f;
+
+    // Performance screen images at their app sizes, filled like a busy graph
+    Image perfText = { 256, 160, 4, std::vector<unsigned char>((size_t)256 * 160 * 4, 0) };
+    Image perfGraph = { 240, 48, 4, std::vector<unsigned char>((size_t)240 * 48 * 4, 200) };
+    blitString(perfText.pixels.data(), 256, 160, "FRAME 13.33 MS", 4, 154, 2, 255, 255, 255);
+
+    for (auto _ : state) {
+        const Image& screen = softWatchUiRender(ui, frame, 512, &perfText, &perfGraph);
+        benchmark::DoNotOptimize(screen.pixels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 512 * 512);
+}
+BENCHMARK(BM_SoftWatchUi)->ArgsProduct({ {0, 1, 2, 3}, {1, 4} })->UseRealTime();
+
+// Panel format conversion of the heart rate screen (EKG gradients and blended edges)
+static void BM_DisplayConvert(benchmark::State& state) {
+    SoftWatchUi ui;
+    softWatchUiInit(ui, 1);
+
+    WatchUiFrame frame = {};
+    frame.screen = 1;
+    watchUiSetText(frame, 12, 34, 56, 92.0f, 64);
+    frame.bpm = 92.0f;
+    frame.ekgScale = 1.0f;
+    frame.ekgOffset = 0.3f;
+    const Image& screen = softWatchUiRender(ui, frame, 512, NULL, NULL);
+
+    DisplayPixelFormat format = (DisplayPixelFormat)state.range(0);
+    DisplayDither dither = (DisplayDither)state.range(1);
+    Image out;
+    for (auto _ : state) {
+        displayConvert(screen, format, dither, out);
+        benchmark::DoNotOptimize(out.pixels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 512 * 512);
+    state.SetBytesProcessed(state.iterations() * 512 * 512 * 4);
+}
+BENCHMARK(BM_DisplayConvert)->ArgsProduct({ {DISPLAY_RGB565, DISPLAY_RGB444}, {DITHER_NONE, DITHER_ORDERED, DITHER_BLUE_NOISE} });
+
+static void BM_DisplayLink(benchmark::State& state) {
+    SoftWatchUi ui;
+    softWatchUiInit(ui, 1);
+
+    WatchUiFrame frame = {};
+    frame.screen = (int)state.range(0);
+    frame.bpm = 92.0f;
+    frame.ekgScale = 1.0f;
+    frame.batteryPercent = 64;
+
+    // Two seconds of frames at 75 FPS, composed (and converted to the panel
+    // format, ordered dither) up front so only the link is timed
+    DisplayPixelFormat format = (DisplayPixelFormat)state.range(1);
+    const int frameCount = 150;
+    std::vector<Image> frames(frameCount);
+    for (int i = 0; i < frameCount; i++) {
+        watchUiSetText(frame, 12, 34, i / 75, frame.bpm, frame.batteryPercent);
+        frame.ekgOffset = i * 0.01f;
+        const Image& screen = softWatchUiRender(ui, frame, 512, NULL, NULL);
+        if (format == DISPLAY_RGB888) frames[i] = screen;
+        else displayConvert(screen, format, DITHER_ORDERED, frames[i]);
+    }
+
+    DisplayLink link;
+    displayLinkInit(link, 512, format == DISPLAY_RGB888 ? 4 : 2, 32.0);
+    displayLinkPush(link, frames[frameCount - 1], frame.screen);  // Panel starts filled
+    displayLinkResetStats(link);
+
+    int i = 0;
+    for (auto _ : state) {
+        DisplayLinkFrame sent = displayLinkPush(link, frames[i], frame.screen);
+        benchmark::DoNotOptimize(sent.bytes);
+        i = (i + 1) % frameCount;
+    }
+    const DisplayScreenStats& s = link.screens[frame.screen];
+    state.counters["bytes"] = s.bytes / s.frames;
+    state.counters["tiles"] = s.changedTiles / s.frames;
+    state.counters["bus_ms"] = s.busMs / s.frames;
+    state.SetItemsProcessed(state.iterations() * 512 * 512);
+}
+BENCHMARK(BM_DisplayLink)->ArgsProduct({ {0, 1, 2}, {DISPLAY_RGB888, DISPLAY_RGB565, DISPLAY_RGB444} });
+
+BENCHMARK_MAIN();
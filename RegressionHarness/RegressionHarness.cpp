@@ -0,0 +1,278 @@
+/*
+ * ============================================================================
+ * SmartWatch 3D - Golden Image Regression Harness
+ * ============================================================================
+ * Renders fixed scenarios headlessly with the software rasterizer (Mesa
+ * llvmpipe) and compares them against stored golden PNGs.
+ *
+ * For every scenario the harness runs the simulator as
+ *     SmartWatch3D --scenario NAME --capture OUT.png --benchmark-out OUT.json
+ * which advances the simulation with a fixed timestep and saves the last
+ * measured frame. The capture is compared with golden/NAME.png using the
+ * CIE76 color difference (delta E in L*a*b*), so rasterizer noise on edges
+ * passes while real visual changes fail. Frame-time percentiles from the same
+ * run are recorded next to the image result, so an optimization can be
+ * checked for correctness and speed in one go.
+ *
+ * USAGE (run from the SmartWatch3D directory, where the shaders live):
+ *   RegressionHarness [--app PATH] [--golden DIR] [--out DIR] [--update]
+ *                     [--allow-missing]
+ *                     [--max-mean-de X] [--max-bad-fraction X] [--bad-de X]
+ *
+ *   --update         Overwrite the golden images with the current renders
+ *   --allow-missing  A scenario without a golden image (MISSING) does not
+ *                    fail the run; only for bootstrapping a new scenario
+ *
+ * Exit code is 0 when every scenario matches its golden image.
+ * ============================================================================
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "ImageIO.h"
+
+// Must match SCENARIOS in Main.cpp
+const char* SCENARIO_NAMES[] = {
+    "clock",
+    "heartrate_running",
+    "battery",
+    "wrist_view",
+};
+
+struct HarnessOptions {
+    std::string app = "../x64/Release/SmartWatch3D.exe";
+    std::string goldenDir = "../RegressionHarness/golden";
+    std::string outDir = "regression_out";
+    bool update = false;
+    bool allowMissing = false;
+    double maxMeanDeltaE = 1.0;       // Average color difference allowed
+    double maxBadFraction = 0.002;    // Share of pixels allowed above badDeltaE
+    double badDeltaE = 10.0;          // Clearly visible per-pixel difference
+};
+
+struct ImageDiff {
+    bool sizeMatches;
+    double meanDeltaE;
+    double badFraction;
+};
+
+// ==================== COLOR DIFFERENCE ====================
+
+static double srgbToLinear(double c) {
+    c /= 255.0;
+    return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+static double labF(double t) {
+    return t > 0.008856 ? cbrt(t) : 7.787 * t + 16.0 / 116.0;
+}
+
+static void rgbToLab(const unsigned char* rgb, double& L, double& a, double& b) {
+    double r = srgbToLinear(rgb[0]);
+    double g = srgbToLinear(rgb[1]);
+    double bl = srgbToLinear(rgb[2]);
+
+    // sRGB -> XYZ (D65), normalized by the white point
+    double x = (0.4124 * r + 0.3576 * g + 0.1805 * bl) / 0.95047;
+    double y = (0.2126 * r + 0.7152 * g + 0.0722 * bl);
+    double z = (0.0193 * r + 0.1192 * g + 0.9505 * bl) / 1.08883;
+
+    double fx = labF(x), fy = labF(y), fz = labF(z);
+    L = 116.0 * fy - 16.0;
+    a = 500.0 * (fx - fy);
+    b = 200.0 * (fy - fz);
+}
+
+/**
+ * Compares two RGB images and optionally writes a heat map of the differences
+ */
+static ImageDiff compareImages(const unsigned char* actual, const unsigned char* golden, int width, int height,
+    double badDeltaE, const std::string& diffPath) {
+    ImageDiff diff = { true, 0.0, 0.0 };
+    std::vector<unsigned char> heat((size_t)width * height * 3);
+
+    double total = 0.0;
+    long long bad = 0;
+    for (long long i = 0; i < (long long)width * height; i++) {
+        double L1, a1, b1, L2, a2, b2;
+        rgbToLab(actual + i * 3, L1, a1, b1);
+        rgbToLab(golden + i * 3, L2, a2, b2);
+        double dE = sqrt((L1 - L2) * (L1 - L2) + (a1 - a2) * (a1 - a2) + (b1 - b2) * (b1 - b2));
+        total += dE;
+        if (dE > badDeltaE) bad++;
+
+        // Gray copy of the golden image with differences in red
+        unsigned char gray = (unsigned char)(golden[i * 3 + 1] / 3);
+        unsigned char red = (unsigned char)(std::min)(255.0, dE * 10.0);
+        heat[i * 3] = (std::max)(gray, red);
+        heat[i * 3 + 1] = gray;
+        heat[i * 3 + 2] = gray;
+    }
+
+    diff.meanDeltaE = total / ((double)width * height);
+    diff.badFraction = (double)bad / ((double)width * height);
+    if (!diffPath.empty()) writePng(diffPath.c_str(), width, height, 3, heat.data(), false);
+    return diff;
+}
+
+// ==================== BENCHMARK JSON ====================
+
+/**
+ * Reads one statistic of the "frame_time_ms" object written by writeBenchmarkJson
+ */
+static double readFrameTimeStat(const std::string& json, const char* key) {
+    size_t section = json.find("\"frame_time_ms\"");
+    if (section == std::string::npos) return -1.0;
+    std::string needle = std::string("\"") + key + "\":";
+    size_t pos = json.find(needle, section);
+    if (pos == std::string::npos) return -1.0;
+    return atof(json.c_str() + pos + needle.size());
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+// ==================== MAIN ====================
+
+static void useSoftwareRasterizer() {
+    // Mesa: force llvmpipe so renders are identical across GPUs
+#ifdef _WIN32
+    _putenv("GALLIUM_DRIVER=llvmpipe");
+    _putenv("LIBGL_ALWAYS_SOFTWARE=1");
+#else
+    setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+#endif
+}
+
+static bool parseArguments(int argc, char** argv, HarnessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--app" && hasValue) options.app = argv[++i];
+        else if (arg == "--golden" && hasValue) options.goldenDir = argv[++i];
+        else if (arg == "--out" && hasValue) options.outDir = argv[++i];
+        else if (arg == "--update") options.update = true;
+        else if (arg == "--allow-missing") options.allowMissing = true;
+        else if (arg == "--max-mean-de" && hasValue) options.maxMeanDeltaE = atof(argv[++i]);
+        else if (arg == "--max-bad-fraction" && hasValue) options.maxBadFraction = atof(argv[++i]);
+        else if (arg == "--bad-de" && hasValue) options.badDeltaE = atof(argv[++i]);
+        else {
+            std::cout << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    HarnessOptions options;
+    if (!parseArguments(argc, argv, options)) return 2;
+
+    std::filesystem::create_directories(options.outDir);
+    std::filesystem::create_directories(options.goldenDir);
+    useSoftwareRasterizer();
+
+    std::ofstream csv(options.outDir + "/results.csv");
+    csv << "scenario,status,mean_delta_e,bad_fraction,frame_ms_mean,frame_ms_p50,frame_ms_p99\n";
+
+    int failures = 0;
+    int missing = 0;
+    printf("%-20s %-8s %10s %10s %10s %10s\n", "SCENARIO", "STATUS", "MEAN dE", "BAD %", "P50 ms", "P99 ms");
+
+    for (const char* name : SCENARIO_NAMES) {
+        std::string capture = options.outDir + "/" + name + ".png";
+        std::string json = options.outDir + "/" + name + ".json";
+        std::string golden = options.goldenDir + "/" + name + ".png";
+        std::string diffPath = options.outDir + "/" + name + "_diff.png";
+
+        std::string command = "\"" + options.app + "\" --scenario " + name +
+            " --capture \"" + capture + "\" --benchmark-out \"" + json + "\"";
+#ifdef _WIN32
+        // cmd.exe strips the outer pair of quotes when the command starts with one
+        command = "\"" + command + "\"";
+#endif
+        std::filesystem::remove(capture);
+        int exitCode = std::system(command.c_str());
+
+        std::string results = readFile(json);
+        double frameMean = readFrameTimeStat(results, "mean");
+        double frameP50 = readFrameTimeStat(results, "p50");
+        double frameP99 = readFrameTimeStat(results, "p99");
+
+        const char* status = "PASS";
+        ImageDiff diff = { true, 0.0, 0.0 };
+
+        int w = 0, h = 0, channels = 0;
+        unsigned char* actual = stbi_load(capture.c_str(), &w, &h, &channels, 3);
+        if (exitCode != 0 || actual == NULL) {
+            status = "ERROR";
+        }
+        else if (options.update) {
+            std::filesystem::copy_file(capture, golden, std::filesystem::copy_options::overwrite_existing);
+            status = "UPDATED";
+        }
+        else {
+            int gw = 0, gh = 0, gc = 0;
+            unsigned char* expected = stbi_load(golden.c_str(), &gw, &gh, &gc, 3);
+            if (expected == NULL) {
+                status = "MISSING";
+            }
+            else if (gw != w || gh != h) {
+                status = "SIZE";
+                diff.sizeMatches = false;
+            }
+            else {
+                diff = compareImages(actual, expected, w, h, options.badDeltaE, diffPath);
+                if (diff.meanDeltaE > options.maxMeanDeltaE || diff.badFraction > options.maxBadFraction) {
+                    status = "FAIL";
+                }
+                else {
+                    std::filesystem::remove(diffPath);
+                }
+            }
+            if (expected != NULL) stbi_image_free(expected);
+        }
+        if (actual != NULL) stbi_image_free(actual);
+
+        bool ok = strcmp(status, "PASS") == 0 || strcmp(status, "UPDATED") == 0;
+        if (strcmp(status, "MISSING") == 0) missing++;
+        else if (!ok) failures++;
+
+        printf("%-20s %-8s %10.3f %10.3f %10.3f %10.3f\n", name, status,
+            diff.meanDeltaE, diff.badFraction * 100.0, frameP50, frameP99);
+        csv << name << "," << status << "," << diff.meanDeltaE << "," << diff.badFraction << ","
+            << frameMean << "," << frameP50 << "," << frameP99 << "\n";
+    }
+
+    if (missing > 0) {
+        std::cout << missing << " scenario(s) have no golden image in " << options.goldenDir
+            << ". Render them on llvmpipe with --update, check the captures and commit the PNGs"
+            << (options.allowMissing ? " (ignored: --allow-missing)." : ".") << std::endl;
+    }
+    if (failures > 0) {
+        std::cout << failures << " scenario(s) failed. Diff images are in " << options.outDir << std::endl;
+        return 1;
+    }
+    if (missing > 0 && !options.allowMissing) return 1;
+    if (missing == 0) std::cout << "All scenarios match." << std::endl;
+    return 0;
+}
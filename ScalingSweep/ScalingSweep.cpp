@@ -0,0 +1,316 @@
+/*
+ * ============================================================================
+ * SmartWatch 3D - Scene Scaling Sweep
+ * ============================================================================
+ * Runs the same fixed replay headlessly while growing one scene parameter at
+ * a time, and fits how frame cost scales with it. An exponent near 1 means
+ * cost grows linearly with the parameter, near 0 means it hardly matters,
+ * and clearly above 1 means the engine goes superlinear there.
+ *
+ * For every sweep point the simulator runs as
+ *     SmartWatch3D --scenario NAME --headless --benchmark-frames N
+ *                  --benchmark-out OUT.json <parameter flag> VALUE
+ *
+ * Axes (the "load" column is what the exponent is fitted against):
+ *   buildings          --buildings        load = buildings per side
+ *   ground_segments    --ground-segments  load = segments
+ *   watch_screen_size  --watch-size       load = watch texture pixels
+ *   lights             --lights           load = street lights + sun + screen
+ *   resolution         --size             load = framebuffer pixels
+ *   watch_ui_threads   --set watch_ui_threads (with watch_ui=cpu)
+ *                                         load = CPU watch UI threads
+ *   instances          --instances        load = engines running side by side
+ *
+ * The two thread axes are expected to fit exponents at or below 0: more
+ * watch UI threads should make frames cheaper, and with instances the
+ * frame cost of one engine (instance 0 is read) should stay flat while
+ * cores are free.
+ *
+ * Output (in --out):
+ *   sweep.csv      one row per point: frame/CPU/GPU times and GL counters
+ *   exponents.csv  per axis and metric: log-log least-squares exponent over
+ *                  all points, and the local exponent of the last two points
+ *
+ * USAGE (run from the SmartWatch3D directory, where the shaders live):
+ *   ScalingSweep [--app PATH] [--out DIR] [--scenario NAME] [--frames N]
+ *                [--axis NAME] [--software]
+ *
+ *   --axis      Only sweep this axis (default: all)
+ *   --software  Force Mesa llvmpipe, like RegressionHarness
+ * ============================================================================
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct SweepPoint {
+    std::string flagValue;  // Passed after the axis flag
+    double load;            // What cost is fitted against
+};
+
+struct SweepAxis {
+    const char* name;
+    const char* flag;       // A flag ending in '=' takes the value without a space
+    std::vector<SweepPoint> points;
+    const char* extra = "";     // Fixed flags the axis needs
+    bool perInstance = false;   // --instances: every engine writes OUT.<i>.json
+};
+
+struct SweepOptions {
+    std::string app = "../x64/Release/SmartWatch3D.exe";
+    std::string outDir = "sweep_out";
+    std::string scenario = "wrist_view";  // Looks down the street, so the whole scene is on screen
+    int frames = 120;
+    std::string axis;
+    bool software = false;
+};
+
+// One measured point; -1 = missing from the benchmark JSON
+struct SweepResult {
+    double frameP50;
+    double frameP99;
+    double cpuP50;
+    double gpuMs;           // Sum of the GPU pass means
+    double drawCalls;
+    double vertices;
+};
+
+const int METRIC_COUNT = 3;
+const char* METRIC_NAMES[METRIC_COUNT] = { "frame_p50", "cpu_p50", "gpu_ms" };
+
+// Exponents above this on the last segment are reported as superlinear
+const double SUPERLINEAR_EXPONENT = 1.15;
+
+static std::vector<SweepAxis> buildAxes() {
+    std::vector<SweepAxis> axes;
+
+    SweepAxis buildings = { "buildings", "--buildings", {} };
+    for (int n : { 6, 12, 25, 50, 100, 200, 400 }) buildings.points.push_back({ std::to_string(n), (double)n });
+    axes.push_back(buildings);
+
+    SweepAxis ground = { "ground_segments", "--ground-segments", {} };
+    for (int n : { 5, 10, 20, 40, 80, 160 }) ground.points.push_back({ std::to_string(n), (double)n });
+    axes.push_back(ground);
+
+    SweepAxis watch = { "watch_screen_size", "--watch-size", {} };
+    for (int n : { 128, 256, 512, 1024, 2048 }) watch.points.push_back({ std::to_string(n), (double)n * n });
+    axes.push_back(watch);
+
+    SweepAxis lights = { "lights", "--lights", {} };
+    for (int n : { 0, 2, 4, 8, 16, 32 }) lights.points.push_back({ std::to_string(n), (double)(n + 2) });
+    axes.push_back(lights);
+
+    SweepAxis resolution = { "resolution", "--size", {} };
+    const int sizes[][2] = { { 320, 180 }, { 640, 360 }, { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+    for (const auto& s : sizes) {
+        resolution.points.push_back({ std::to_string(s[0]) + "x" + std::to_string(s[1]), (double)s[0] * s[1] });
+    }
+    axes.push_back(resolution);
+
+    SweepAxis threads = { "watch_ui_threads", "--set watch_ui_threads=", {} };
+    for (int n : { 1, 2, 4, 8 }) threads.points.push_back({ std::to_string(n), (double)n });
+    threads.extra = "--set watch_ui=cpu";
+    axes.push_back(threads);
+
+    SweepAxis instances = { "instances", "--instances", {} };
+    for (int n : { 1, 2, 4, 8 }) instances.points.push_back({ std::to_string(n), (double)n });
+    instances.perInstance = true;
+    axes.push_back(instances);
+
+    return axes;
+}
+
+// ==================== RESULTS ====================
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * Reads "key" inside the "section" object written by writeBenchmarkJson
+ */
+static double readStat(const std::string& json, const char* section, const char* key) {
+    size_t start = json.find(std::string("\"") + section + "\"");
+    if (start == std::string::npos) return -1.0;
+    std::string needle = std::string("\"") + key + "\":";
+    size_t pos = json.find(needle, start);
+    if (pos == std::string::npos || pos > json.find('}', start)) return -1.0;
+    return atof(json.c_str() + pos + needle.size());
+}
+
+static SweepResult readResult(const std::string& json) {
+    SweepResult r;
+    r.frameP50 = readStat(json, "frame_time_ms", "p50");
+    r.frameP99 = readStat(json, "frame_time_ms", "p99");
+    r.cpuP50 = readStat(json, "cpu_time_ms", "p50");
+    r.gpuMs = 0.0;
+    for (const char* pass : { "watch_ui", "scene", "overlay" }) {
+        double ms = readStat(json, "gpu_pass_ms", pass);
+        if (ms > 0.0) r.gpuMs += ms;
+    }
+    r.drawCalls = readStat(json, "gl_counters", "draw_calls");
+    r.vertices = readStat(json, "gl_counters", "vertices");
+    return r;
+}
+
+static double metric(const SweepResult& r, int m) {
+    switch (m) {
+    case 0: return r.frameP50;
+    case 1: return r.cpuP50;
+    default: return r.gpuMs;
+    }
+}
+
+// ==================== FITTING ====================
+
+/**
+ * Least-squares slope of log(y) over log(x), i.e. k in y ~ x^k
+ * Points with a non-positive value are skipped; NAN if fewer than two remain
+ */
+static double fitExponent(const std::vector<double>& x, const std::vector<double>& y) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    int n = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i] <= 0.0 || y[i] <= 0.0) continue;
+        double lx = log(x[i]), ly = log(y[i]);
+        sx += lx;
+        sy += ly;
+        sxx += lx * lx;
+        sxy += lx * ly;
+        n++;
+    }
+    double denominator = n * sxx - sx * sx;
+    if (n < 2 || denominator == 0.0) return NAN;
+    return (n * sxy - sx * sy) / denominator;
+}
+
+// ==================== MAIN ====================
+
+static void useSoftwareRasterizer() {
+#ifdef _WIN32
+    _putenv("GALLIUM_DRIVER=llvmpipe");
+    _putenv("LIBGL_ALWAYS_SOFTWARE=1");
+#else
+    setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+#endif
+}
+
+static bool parseArguments(int argc, char** argv, SweepOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--app" && hasValue) options.app = argv[++i];
+        else if (arg == "--out" && hasValue) options.outDir = argv[++i];
+        else if (arg == "--scenario" && hasValue) options.scenario = argv[++i];
+        else if (arg == "--frames" && hasValue) options.frames = atoi(argv[++i]);
+        else if (arg == "--axis" && hasValue) options.axis = argv[++i];
+        else if (arg == "--software") options.software = true;
+        else {
+            std::cout << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SweepOptions options;
+    if (!parseArguments(argc, argv, options)) return 2;
+
+    std::vector<SweepAxis> axes = buildAxes();
+    if (!options.axis.empty()) {
+        std::vector<SweepAxis> selected;
+        for (const SweepAxis& axis : axes) {
+            if (options.axis == axis.name) selected.push_back(axis);
+        }
+        if (selected.empty()) {
+            std::cout << "Unknown axis: " << options.axis << std::endl;
+            return 2;
+        }
+        axes = selected;
+    }
+
+    std::filesystem::create_directories(options.outDir);
+    if (options.software) useSoftwareRasterizer();
+
+    std::ofstream csv(options.outDir + "/sweep.csv");
+    csv << "axis,value,load,frame_ms_p50,frame_ms_p99,cpu_ms_p50,gpu_ms,draw_calls,vertices\n";
+    std::ofstream exponents(options.outDir + "/exponents.csv");
+    exponents << "axis,metric,exponent_fit,exponent_tail,points\n";
+
+    int errors = 0;
+    for (const SweepAxis& axis : axes) {
+        printf("\n%s\n%-12s %12s %10s %10s %10s %10s %12s\n", axis.name,
+            "VALUE", "LOAD", "P50 ms", "P99 ms", "CPU ms", "GPU ms", "DRAW CALLS");
+
+        std::vector<double> loads;
+        std::vector<SweepResult> results;
+        for (const SweepPoint& point : axis.points) {
+            std::string json = options.outDir + "/" + axis.name + "_" + point.flagValue + ".json";
+            std::string flag = axis.flag;
+            std::string argument = flag.back() == '=' ? flag + point.flagValue : flag + " " + point.flagValue;
+            std::string command = "\"" + options.app + "\" --scenario " + options.scenario +
+                " --headless --benchmark-frames " + std::to_string(options.frames) +
+                " --benchmark-out \"" + json + "\" " + axis.extra + " " + argument;
+            // Several engines name their results after the instance (run.json -> run.0.json)
+            std::string resultJson = json;
+            if (axis.perInstance && point.load > 1.0) resultJson = json.substr(0, json.size() - 5) + ".0.json";
+#ifdef _WIN32
+            // cmd.exe strips the outer pair of quotes when the command starts with one
+            command = "\"" + command + "\"";
+#endif
+            std::filesystem::remove(resultJson);
+            int exitCode = std::system(command.c_str());
+
+            SweepResult r = readResult(readFile(resultJson));
+            if (exitCode != 0 || r.frameP50 < 0.0) {
+                printf("%-12s ERROR (exit code %d)\n", point.flagValue.c_str(), exitCode);
+                errors++;
+                continue;
+            }
+
+            loads.push_back(point.load);
+            results.push_back(r);
+            printf("%-12s %12.0f %10.3f %10.3f %10.3f %10.3f %12.0f\n", point.flagValue.c_str(), point.load,
+                r.frameP50, r.frameP99, r.cpuP50, r.gpuMs, r.drawCalls);
+            csv << axis.name << "," << point.flagValue << "," << point.load << "," << r.frameP50 << ","
+                << r.frameP99 << "," << r.cpuP50 << "," << r.gpuMs << "," << r.drawCalls << "," << r.vertices << "\n";
+        }
+
+        // Fixed per-frame costs flatten the overall fit, so the last segment
+        // shows best where growth is heading
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            std::vector<double> values;
+            for (const SweepResult& r : results) values.push_back(metric(r, m));
+            double fit = fitExponent(loads, values);
+
+            double tail = NAN;
+            size_t n = loads.size();
+            if (n >= 2) {
+                std::vector<double> lastX(loads.end() - 2, loads.end());
+                std::vector<double> lastY(values.end() - 2, values.end());
+                tail = fitExponent(lastX, lastY);
+            }
+
+            printf("  %-10s exponent %6.3f (last segment %6.3f)%s\n", METRIC_NAMES[m], fit, tail,
+                tail > SUPERLINEAR_EXPONENT ? "  SUPERLINEAR" : "");
+            exponents << axis.name << "," << METRIC_NAMES[m] << "," << fit << "," << tail << "," << n << "\n";
+        }
+    }
+
+    std::cout << "\nResults written to " << options.outDir << std::endl;
+    return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "Benchmark.h"
+#include "Config.h"
+#include "DisplayLink.h"
+#include "FrameArena.h"
+#include "GpuResources.h"
+#include "Startup.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[(std::min)(idx, sorted.size() - 1)];
+}
+
+TimeSummary summarizeTimes(std::vector<double> samples) {
+    TimeSummary s = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (samples.empty()) return s;
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double v : samples) total += v;
+
+    s.mean = total / samples.size();
+    s.p50 = percentile(samples, 0.50);
+    s.p90 = percentile(samples, 0.90);
+    s.p99 = percentile(samples, 0.99);
+    s.max = samples.back();
+    return s;
+}
+
+static void writeSummary(FILE* f, const char* name, const TimeSummary& s) {
+    fprintf(f, "  \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+        name, s.mean, s.p50, s.p90, s.p99, s.max);
+}
+
+static void writeSamples(FILE* f, const char* name, const std::vector<double>& samples, bool last) {
+    fprintf(f, "  \"%s\": [", name);
+    for (size_t i = 0; i < samples.size(); i++) {
+        fprintf(f, "%s%.4f", i ? ", " : "", samples[i]);
+    }
+    fprintf(f, "]%s\n", last ? "" : ",");
+}
+
+bool writeBenchmarkJson(const char* path, const BenchmarkRunInfo& info, const std::vector<FrameStats>& frames) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        std::cout << "Error writing benchmark results to \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    std::vector<double> frameTimes, cpuTimes;
+    double gpuTotals[GPU_PASS_COUNT] = {};
+    double counterTotals[COUNTER_COUNT] = {};
+    for (const FrameStats& fs : frames) {
+        frameTimes.push_back(fs.frameTimeMs);
+        cpuTimes.push_back(fs.cpuTimeMs);
+        for (int p = 0; p < GPU_PASS_COUNT; p++) gpuTotals[p] += fs.gpuPassMs[p];
+        for (int c = 0; c < COUNTER_COUNT; c++) counterTotals[c] += fs.counters[c];
+    }
+    double n = frames.empty() ? 1.0 : (double)frames.size();
+
+    // The renderer string comes from the driver; keep it valid JSON
+    std::string renderer;
+    for (const char* c = info.renderer; c != NULL && *c; c++) {
+        if (*c == '"' || *c == '\\') renderer += '\\';
+        renderer += *c;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"scenario\": \"%s\",\n", info.scenario);
+    fprintf(f, "  \"renderer\": \"%s\",\n", renderer.c_str());
+    fprintf(f, "  \"frames\": %d,\n", (int)frames.size());
+    fprintf(f, "  \"startup_ms\": %.3f,\n", info.startupMs);
+    fprintf(f, "  \"ground_shading\": \"%s\",\n", info.groundShading);
+    if (info.config != NULL) configWriteJson(f, *info.config);
+    if (info.display != NULL) displayLinkWriteJson(f, *info.display);
+
+    const std::vector<StartupPhase>& phases = startupPhases();
+    fprintf(f, "  \"startup_phases_ms\": {");
+    for (size_t i = 0; i < phases.size(); i++) {
+        fprintf(f, "%s \"%s\": %.3f", i ? "," : "", phases[i].name, phases[i].ms);
+    }
+    fprintf(f, " },\n");
+    writeSummary(f, "frame_time_ms", summarizeTimes(frameTimes));
+    writeSummary(f, "cpu_time_ms", summarizeTimes(cpuTimes));
+
+    fprintf(f, "  \"gpu_pass_ms\": {");
+    for (int p = 0; p < GPU_PASS_COUNT; p++) {
+        fprintf(f, "%s \"%s\": %.4f", p ? "," : "", profilerGpuPassName((ProfilerGpuPass)p), gpuTotals[p] / n);
+    }
+    fprintf(f, " },\n");
+    // The CPU renderer's counterpart of gpu_pass_ms.watch_ui in a watch_ui = gl run
+    if (info.watchUiCpuMs >= 0.0) fprintf(f, "  \"watch_ui_cpu_ms\": %.4f,\n", info.watchUiCpuMs);
+
+    fprintf(f, "  \"gl_counters\": {");
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        fprintf(f, "%s \"%s\": %.2f", c ? "," : "", profilerCounterName((ProfilerCounter)c), counterTotals[c] / n);
+    }
+    fprintf(f, " },\n");
+
+    // GPU memory at the time of writing (end of the run) and the peak over the run
+    fprintf(f, "  \"gpu_memory_kb\": {");
+    for (int t = 0; t < GPU_RES_TYPE_COUNT; t++) {
+        GpuResourceStats rs = gpuResourceStats((GpuResourceType)t);
+        fprintf(f, "%s \"%s\": { \"live\": %.1f, \"peak\": %.1f }", t ? "," : "",
+            gpuResourceTypeName((GpuResourceType)t), rs.liveBytes / 1024.0, rs.peakBytes / 1024.0);
+    }
+    fprintf(f, " },\n");
+
+    // Frame arena use over the whole run (overflows mean FRAME_ARENA_SIZE is too small)
+    FrameArenaStats arena = frameArenaStats();
+    fprintf(f, "  \"frame_arena\": { \"capacity_kb\": %.1f, \"peak_kb\": %.1f, \"overflows\": %u, \"overflow_kb\": %.1f },\n",
+        arena.capacity / 1024.0, arena.peak / 1024.0, arena.overflows, arena.overflowBytes / 1024.0);
+
+    writeSamples(f, "frame_time_samples_ms", frameTimes, false);
+    writeSamples(f, "cpu_time_samples_ms", cpuTimes, true);
+    fprintf(f, "}\n");
+
+    fclose(f);
+    std::cout << "Wrote benchmark results (" << frames.size() << " frames) to \"" << path << "\"" << std::endl;
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Profiler.h"
+#include <vector>
+
+struct DisplayLink;
+struct RuntimeConfig;
+
+/*
+ * Benchmark result output
+ * -----------------------
+ * Summarizes the frames recorded by the profiler during a benchmark run
+ * into a small JSON document: frame/CPU time percentiles, mean GPU pass
+ * times, mean GL call counters per frame, startup time (total and per
+ * phase) and the raw frame/CPU time samples (so later runs can be compared
+ * statistically by BenchCompare, not just by their means) plus live/peak
+ * GPU memory per object type from the resource registry and frame arena use.
+ * The runtime config the run used is included so results are self-describing,
+ * and with display_link on, the simulated panel traffic per watch screen.
+ */
+
+struct TimeSummary {
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+};
+
+// Run-level information written next to the frame statistics
+struct BenchmarkRunInfo {
+    const char* scenario;
+    const char* renderer;  // GL_RENDERER string, part of the machine fingerprint
+    double startupMs;      // main() entry -> first frame presented
+    const RuntimeConfig* config;  // Resolved settings of the run (may be NULL)
+    const DisplayLink* display;   // Panel bus statistics per watch screen (NULL without display_link)
+    const char* groundShading;    // Ground path in use, after ground_shading = auto is resolved
+    double watchUiCpuMs;          // Mean softWatchUiRender time per frame (watch_ui = cpu), < 0 otherwise
+};
+
+TimeSummary summarizeTimes(std::vector<double> samples);
+
+// Returns false if the file could not be written
+bool writeBenchmarkJson(const char* path, const BenchmarkRunInfo& info, const std::vector<FrameStats>& frames);
@@ -0,0 +1,151 @@
+#include "Canvas.h"
+#include "TextureGen.h"  // FONT_DATA
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CANVAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+Canvas makeCanvas(unsigned char* pixels, int width, int height, int channels) {
+    Canvas canvas = { pixels, width, height, channels };
+    return canvas;
+}
+
+// ==================== SPAN FILL ====================
+
+/*
+ * RGBA rows are filled with one 32-bit pixel, 4 pixels per 16-byte store.
+ * RGB pixels do not fit a register lane, so wide RGB rows copy a 48-byte
+ * (16 pixel) run of the color instead; it is only built when a row is at
+ * least that wide, because building it costs more than a short span.
+ */
+
+static void fillRowRGBA(unsigned char* dst, int count, uint32_t pixel) {
+    int i = 0;
+#ifdef CANVAS_SSE2
+    __m128i quad = _mm_set1_epi32((int)pixel);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i * 4), quad);
+    }
+#endif
+    for (; i < count; i++) memcpy(dst + i * 4, &pixel, 4);
+}
+
+static void fillRowRGB(unsigned char* dst, int count, const unsigned char* rgb, const unsigned char* run) {
+    int i = 0;
+    if (run != NULL) {
+#ifdef CANVAS_SSE2
+        __m128i p0 = _mm_loadu_si128((const __m128i*)run);
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(run + 16));
+        __m128i p2 = _mm_loadu_si128((const __m128i*)(run + 32));
+        for (; i + 16 <= count; i += 16) {
+            _mm_storeu_si128((__m128i*)(dst + i * 3), p0);
+            _mm_storeu_si128((__m128i*)(dst + i * 3 + 16), p1);
+            _mm_storeu_si128((__m128i*)(dst + i * 3 + 32), p2);
+        }
+#else
+        for (; i + 16 <= count; i += 16) memcpy(dst + i * 3, run, 48);
+#endif
+    }
+    for (; i < count; i++) memcpy(dst + i * 3, rgb, 3);
+}
+
+// Fills rows y0 <= y < y1 between x0 and x1, already clipped to the canvas
+static void fillClipped(const Canvas& canvas, int x0, int y0, int x1, int y1, CanvasColor color) {
+    int count = x1 - x0;
+    size_t stride = (size_t)canvas.width * canvas.channels;
+    unsigned char* row = canvas.pixels + (size_t)y0 * stride + (size_t)x0 * canvas.channels;
+
+    if (canvas.channels == 4) {
+        uint32_t pixel;
+        memcpy(&pixel, &color, 4);
+        for (int y = y0; y < y1; y++, row += stride) fillRowRGBA(row, count, pixel);
+        return;
+    }
+
+    const unsigned char rgb[3] = { color.r, color.g, color.b };
+    unsigned char run[48];
+    if (count >= 16) {
+        for (int i = 0; i < 48; i += 3) memcpy(run + i, rgb, 3);
+    }
+    for (int y = y0; y < y1; y++, row += stride) fillRowRGB(row, count, rgb, count >= 16 ? run : NULL);
+}
+
+void canvasClear(const Canvas& canvas, CanvasColor color) {
+    // Rows are contiguous, so the whole canvas is one long row
+    Canvas flat = makeCanvas(canvas.pixels, canvas.width * canvas.height, 1, canvas.channels);
+    fillClipped(flat, 0, 0, flat.width, 1, color);
+}
+
+void canvasFillSpan(const Canvas& canvas, int x0, int x1, int y, CanvasColor color) {
+    canvasFillRect(canvas, x0, y, x1 - x0, 1, color);
+}
+
+void canvasFillRect(const Canvas& canvas, int x, int y, int w, int h, CanvasColor color) {
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + w > canvas.width ? canvas.width : x + w;
+    int y1 = y + h > canvas.height ? canvas.height : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+    fillClipped(canvas, x0, y0, x1, y1, color);
+}
+
+// ==================== LINES AND GLYPHS ====================
+
+void canvasDrawLine(const Canvas& canvas, int x0, int y0, int x1, int y1, int thickness, CanvasColor color) {
+    int dx = x1 - x0;
+    int dy = y1 - y0;
+    int steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    int half = thickness / 2;
+
+    for (int i = 0; i <= steps; i++) {
+        // Round to the nearest pixel; exact for horizontal, vertical and 45 degree lines
+        int offsetX = steps == 0 ? 0 : (2 * dx * i + (dx < 0 ? -steps : steps)) / (2 * steps);
+        int offsetY = steps == 0 ? 0 : (2 * dy * i + (dy < 0 ? -steps : steps)) / (2 * steps);
+        if (abs(dx) >= abs(dy)) {
+            canvasFillRect(canvas, x0 + offsetX, y0 + offsetY - half, 1, thickness, color);
+        }
+        else {
+            canvasFillRect(canvas, x0 + offsetX - half, y0 + offsetY, thickness, 1, color);
+        }
+    }
+}
+
+int canvasDrawString(const Canvas& canvas, const char* str, int x, int topY, int scale, CanvasColor color) {
+    for (; *str; str++) {
+        unsigned char c = (unsigned char)*str;
+        if (c < 128) {
+            // Clip the glyph box once; runs of glyphs fully inside skip per-run clipping
+            bool inside = x >= 0 && x + 5 * scale <= canvas.width &&
+                topY - 7 * scale + 1 >= 0 && topY < canvas.height;
+
+            for (int row = 0; row < 7; row++) {
+                unsigned char bits = FONT_DATA[c][row];
+                int y = topY - row * scale - (scale - 1);
+
+                // One rectangle per run of set bits in the glyph row
+                int col = 0;
+                while (col < 5) {
+                    if (!(bits & (0x10 >> col))) {
+                        col++;
+                        continue;
+                    }
+                    int start = col;
+                    while (col < 5 && (bits & (0x10 >> col))) col++;
+                    if (inside) {
+                        fillClipped(canvas, x + start * scale, y, x + col * scale, y + scale, color);
+                    }
+                    else {
+                        canvasFillRect(canvas, x + start * scale, y, (col - start) * scale, scale, color);
+                    }
+                }
+            }
+        }
+        x += 6 * scale;
+    }
+    return x;
+}
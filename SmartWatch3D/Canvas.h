@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+ * CPU raster canvas
+ * -----------------
+ * Drawing primitives shared by the procedural image generators (and the
+ * performance HUD): clears, spans, rectangles, thick lines and 5x7 glyphs
+ * on an RGB or RGBA 8-bit buffer.
+ *
+ * Shapes are clipped once against the canvas and then written a row span at
+ * a time, instead of bounds-checking every pixel. Spans are filled with
+ * 16-byte SSE2 stores where available (a repeating 48-byte pattern for RGB).
+ *
+ * A canvas does not own its pixels; it draws into storage the caller keeps
+ * (usually an Image, whose buffer is reused when the Image is regenerated).
+ * Rows grow upwards like texture space: y = 0 is the first row in memory.
+ */
+
+struct CanvasColor {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;   // Ignored by RGB canvases
+};
+
+struct Canvas {
+    unsigned char* pixels;
+    int width;
+    int height;
+    int channels;      // 3 or 4
+};
+
+Canvas makeCanvas(unsigned char* pixels, int width, int height, int channels);
+
+void canvasClear(const Canvas& canvas, CanvasColor color);
+
+// Pixels x0 <= x < x1 of row y
+void canvasFillSpan(const Canvas& canvas, int x0, int x1, int y, CanvasColor color);
+
+// w x h pixels with the lower-left corner at (x, y)
+void canvasFillRect(const Canvas& canvas, int x, int y, int w, int h, CanvasColor color);
+
+/**
+ * Line from (x0, y0) to (x1, y1) stepped along its major axis; every step
+ * draws a span of thickness pixels across it (vertical for mostly
+ * horizontal lines), centered on the line
+ */
+void canvasDrawLine(const Canvas& canvas, int x0, int y0, int x1, int y1, int thickness, CanvasColor color);
+
+/**
+ * Draws a string with the 5x7 FONT_DATA glyphs, each font pixel scale x scale
+ * topY is the top row of the text
+ *
+ * @return X position just after the last character
+ */
+int canvasDrawString(const Canvas& canvas, const char* str, int x, int topY, int scale, CanvasColor color);
@@ -0,0 +1,233 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "Config.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+const QualityTier QUALITY_TIERS[] = {
+    { "low",    256,  0, 120.0f },
+    { "medium", WATCH_SCREEN_SIZE, 0, CAMERA_FAR_PLANE },
+    { "high",   1024, 8, 300.0f },
+};
+const int QUALITY_TIER_COUNT = sizeof(QUALITY_TIERS) / sizeof(QUALITY_TIERS[0]);
+
+const char* const GROUND_SHADING_NAMES[GROUND_SHADING_COUNT] = { "texture", "procedural", "auto" };
+
+// ==================== PARSING ====================
+// The whole value has to parse; "12abc" or "" is an error, not 12 or 0
+
+static bool parseInt(const char* text, int& out) {
+    char* end = NULL;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0) return false;
+    out = (int)value;
+    return true;
+}
+
+static bool parseFloat(const char* text, double& out) {
+    char* end = NULL;
+    errno = 0;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || errno != 0) return false;
+    out = value;
+    return true;
+}
+
+static bool parseBool(const char* text, bool& out) {
+    if (strcmp(text, "true") == 0 || strcmp(text, "1") == 0 || strcmp(text, "on") == 0) out = true;
+    else if (strcmp(text, "false") == 0 || strcmp(text, "0") == 0 || strcmp(text, "off") == 0) out = false;
+    else return false;
+    return true;
+}
+
+// Index of text in names
+static bool parseName(const char* text, const char* const* names, int count, int& out) {
+    for (int n = 0; n < count; n++) {
+        if (strcmp(names[n], text) == 0) {
+            out = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool configSet(RuntimeConfig& config, const char* key, const char* value) {
+    int i = 0;
+    double d = 0.0;
+    bool ok = true;
+
+    if (strcmp(key, "quality") == 0) {
+        const QualityTier* tier = NULL;
+        for (const QualityTier& t : QUALITY_TIERS) {
+            if (strcmp(t.name, value) == 0) tier = &t;
+        }
+        if (tier != NULL) config.quality = tier;
+        ok = tier != NULL;
+    }
+    else if (strcmp(key, "target_fps") == 0) { ok = parseFloat(value, d); if (ok) config.targetFps = d; }
+    else if (strcmp(key, "ground_segments") == 0) { ok = parseInt(value, i); if (ok) config.groundSegments = i; }
+    else if (strcmp(key, "buildings") == 0) { ok = parseInt(value, i); if (ok) config.buildingsPerSide = i; }
+    else if (strcmp(key, "building_spacing") == 0) { ok = parseFloat(value, d); if (ok) config.buildingSpacing = (float)d; }
+    else if (strcmp(key, "fov") == 0) { ok = parseFloat(value, d); if (ok) config.fovDegrees = (float)d; }
+    else if (strcmp(key, "fullscreen") == 0) { ok = parseBool(value, config.fullscreen); }
+    else if (strcmp(key, "monitor") == 0) { ok = parseInt(value, i); if (ok) config.monitor = i; }
+    else if (strcmp(key, "watch_ui") == 0) {
+        ok = strcmp(value, "gl") == 0 || strcmp(value, "cpu") == 0;
+        if (ok) config.softWatchUi = strcmp(value, "cpu") == 0;
+    }
+    else if (strcmp(key, "watch_ui_threads") == 0) { ok = parseInt(value, i); if (ok) config.watchUiThreads = i; }
+    else if (strcmp(key, "display_link") == 0) { ok = parseBool(value, config.displayLink); }
+    else if (strcmp(key, "display_bus_mhz") == 0) { ok = parseFloat(value, d); if (ok) config.displayBusMHz = d; }
+    else if (strcmp(key, "display_format") == 0) {
+        ok = parseName(value, DISPLAY_FORMAT_NAMES, DISPLAY_FORMAT_COUNT, i);
+        if (ok) config.displayFormat = (DisplayPixelFormat)i;
+    }
+    else if (strcmp(key, "display_dither") == 0) {
+        ok = parseName(value, DISPLAY_DITHER_NAMES, DITHER_COUNT, i);
+        if (ok) config.displayDither = (DisplayDither)i;
+    }
+    else if (strcmp(key, "ground_shading") == 0) {
+        ok = parseName(value, GROUND_SHADING_NAMES, GROUND_SHADING_COUNT, i);
+        if (ok) config.groundShading = (GroundShading)i;
+    }
+    else if (strcmp(key, "vertex_pull") == 0) { ok = parseBool(value, config.vertexPull); }
+    else if (strcmp(key, "watch_screen_size") == 0) { ok = parseInt(value, i); if (ok) config.watchScreenSize = i; }
+    else if (strcmp(key, "lights") == 0) { ok = parseInt(value, i); if (ok) config.streetLights = i; }
+    else if (strcmp(key, "far_plane") == 0) { ok = parseFloat(value, d); if (ok) config.farPlane = (float)d; }
+    else {
+        std::cout << "Config: unknown setting \"" << key << "\"" << std::endl;
+        return false;
+    }
+
+    if (!ok) std::cout << "Config: invalid value \"" << value << "\" for " << key << std::endl;
+    return ok;
+}
+
+bool configSetPair(RuntimeConfig& config, const char* pair) {
+    const char* eq = strchr(pair, '=');
+    if (eq == NULL) {
+        std::cout << "Config: expected key=value, got \"" << pair << "\"" << std::endl;
+        return false;
+    }
+    std::string key(pair, eq - pair);
+    return configSet(config, key.c_str(), eq + 1);
+}
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool configLoadFile(RuntimeConfig& config, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        std::cout << "Config: cannot open \"" << path << "\"" << std::endl;
+        return false;
+    }
+
+    char buffer[512];
+    int lineNumber = 0;
+    while (fgets(buffer, sizeof(buffer), f) != NULL) {
+        lineNumber++;
+        std::string line = buffer;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        bool ok = eq != std::string::npos &&
+            configSet(config, trim(line.substr(0, eq)).c_str(), trim(line.substr(eq + 1)).c_str());
+        if (!ok) std::cout << "Config: skipped " << path << ":" << lineNumber << ": " << line << std::endl;
+    }
+    fclose(f);
+    return true;
+}
+
+// ==================== VALIDATION ====================
+
+template <typename T>
+static bool clampSetting(const char* key, T& value, T low, T high) {
+    if (value >= low && value <= high) return true;
+    T clamped = (std::min)((std::max)(value, low), high);
+    std::cout << "Config: " << key << " = " << value << " is outside [" << low << ", " << high
+        << "], using " << clamped << std::endl;
+    value = clamped;
+    return false;
+}
+
+bool configValidate(RuntimeConfig& config) {
+    if (config.watchScreenSize < 0) config.watchScreenSize = config.quality->watchScreenSize;
+    if (config.streetLights < 0) config.streetLights = config.quality->streetLights;
+    if (config.farPlane < 0.0f) config.farPlane = config.quality->farPlane;
+
+    bool valid = true;
+    valid &= clampSetting("target_fps", config.targetFps, 10.0, 1000.0);
+    valid &= clampSetting("ground_segments", config.groundSegments, 1, 1000);
+    valid &= clampSetting("buildings", config.buildingsPerSide, 0, 1000);
+    valid &= clampSetting("building_spacing", config.buildingSpacing, 8.0f, 200.0f);  // Below 8 m neighbours overlap
+    valid &= clampSetting("fov", config.fovDegrees, 20.0f, 120.0f);
+    valid &= clampSetting("monitor", config.monitor, 0, 15);
+    valid &= clampSetting("watch_screen_size", config.watchScreenSize, 16, 4096);
+    valid &= clampSetting("watch_ui_threads", config.watchUiThreads, 0, 64);
+    valid &= clampSetting("display_bus_mhz", config.displayBusMHz, 0.1, 1000.0);
+    valid &= clampSetting("lights", config.streetLights, 0, MAX_STREET_LIGHTS);
+    valid &= clampSetting("far_plane", config.farPlane, CAMERA_NEAR_PLANE * 10.0f, 10000.0f);
+    return valid;
+}
+
+double configFrameTime(const RuntimeConfig& config) {
+    return 1.0 / config.targetFps;
+}
+
+void configApplyScene(const RuntimeConfig& config) {
+    groundSegmentCount = config.groundSegments;
+    buildingsPerSide = config.buildingsPerSide;
+    buildingSpacing = config.buildingSpacing;
+    streetLightCount = config.streetLights;
+}
+
+// ==================== OUTPUT ====================
+
+void configReport(const RuntimeConfig& config) {
+    std::cout << "Config: quality=" << config.quality->name
+        << " target_fps=" << config.targetFps
+        << " ground_segments=" << config.groundSegments
+        << " buildings=" << config.buildingsPerSide
+        << " building_spacing=" << config.buildingSpacing
+        << " watch_screen_size=" << config.watchScreenSize
+        << " lights=" << config.streetLights
+        << " fov=" << config.fovDegrees
+        << " far_plane=" << config.farPlane
+        << " fullscreen=" << (config.fullscreen ? "true" : "false")
+        << " monitor=" << config.monitor
+        << " watch_ui=" << (config.softWatchUi ? "cpu" : "gl")
+        << " watch_ui_threads=" << config.watchUiThreads
+        << " display_link=" << (config.displayLink ? "true" : "false")
+        << " display_bus_mhz=" << config.displayBusMHz
+        << " display_format=" << DISPLAY_FORMAT_NAMES[config.displayFormat]
+        << " display_dither=" << DISPLAY_DITHER_NAMES[config.displayDither]
+        << " ground_shading=" << GROUND_SHADING_NAMES[config.groundShading]
+        << " vertex_pull=" << (config.vertexPull ? "true" : "false") << std::endl;
+}
+
+void configWriteJson(FILE* f, const RuntimeConfig& config) {
+    fprintf(f, "  \"config\": { \"quality\": \"%s\", \"target_fps\": %.2f, \"ground_segments\": %d, \"buildings\": %d, "
+        "\"building_spacing\": %.2f, \"watch_screen_size\": %d, \"lights\": %d, \"fov\": %.2f, \"far_plane\": %.2f, "
+        "\"fullscreen\": %s, \"monitor\": %d, \"watch_ui\": \"%s\", \"watch_ui_threads\": %d, "
+        "\"display_link\": %s, \"display_bus_mhz\": %.2f, \"display_format\": \"%s\", \"display_dither\": \"%s\", "
+        "\"ground_shading\": \"%s\", \"vertex_pull\": %s },\n",
+        config.quality->name, config.targetFps, config.groundSegments, config.buildingsPerSide,
+        config.buildingSpacing, config.watchScreenSize, config.streetLights, config.fovDegrees, config.farPlane,
+        config.fullscreen ? "true" : "false", config.monitor, config.softWatchUi ? "cpu" : "gl", config.watchUiThreads,
+        config.displayLink ? "true" : "false", config.displayBusMHz,
+        DISPLAY_FORMAT_NAMES[config.displayFormat], DISPLAY_DITHER_NAMES[config.displayDither],
+        GROUND_SHADING_NAMES[config.groundShading], config.vertexPull ? "true" : "false");
+}
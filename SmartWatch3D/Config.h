@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdio>
+
+#include "DisplayFormat.h"
+#include "Scene.h"
+
+/*
+ * Runtime configuration
+ * ---------------------
+ * Frame pacing, scene size, camera and quality settings that used to be
+ * compile-time constants. Every setting has a key, and the same keys work
+ * in a config file (--config FILE: one "key = value" per line, # starts a
+ * comment) and on the command line (--set key=value, or the dedicated flags
+ * like --buildings). Command line values override the file; explicitly set
+ * values override the quality tier.
+ *
+ * configValidate clamps everything into a working range before the engine
+ * starts. Each benchmark JSON contains the resolved settings, so two results
+ * are only compared when they were rendered with the same config.
+ */
+
+// Defaults (the "medium" quality tier and the settings before they were configurable)
+const double TARGET_FPS = 75.0;            // Frame limiter target
+const int WATCH_SCREEN_SIZE = 512;         // Watch screen texture resolution
+const float CAMERA_FOV_DEGREES = 60.0f;    // Vertical field of view
+const float CAMERA_NEAR_PLANE = 0.1f;
+const float CAMERA_FAR_PLANE = 200.0f;
+const double DISPLAY_BUS_MHZ = 32.0;       // Simulated watch panel bus (SPI-like, one bit per clock)
+
+// Ground and road surface shading (ground_shading)
+enum GroundShading {
+    GROUND_SHADING_TEXTURE,      // Generated grass/road textures
+    GROUND_SHADING_PROCEDURAL,   // Noise and road markings computed in basic.frag
+    GROUND_SHADING_AUTO,         // Time both at startup, keep the faster (texture for scenario/capture runs)
+    GROUND_SHADING_COUNT
+};
+
+extern const char* const GROUND_SHADING_NAMES[GROUND_SHADING_COUNT];   // texture, procedural, auto
+
+// A named set of defaults for the settings that trade image quality for frame time
+struct QualityTier {
+    const char* name;
+    int watchScreenSize;
+    int streetLights;
+    float farPlane;
+};
+
+extern const QualityTier QUALITY_TIERS[];
+extern const int QUALITY_TIER_COUNT;
+
+struct RuntimeConfig {
+    const QualityTier* quality = &QUALITY_TIERS[1];  // quality (low, medium, high)
+
+    double targetFps = TARGET_FPS;                   // target_fps
+    int groundSegments = NUM_GROUND_SEGMENTS;        // ground_segments
+    int buildingsPerSide = NUM_BUILDINGS_PER_SIDE;   // buildings
+    float buildingSpacing = BUILDING_SPACING;        // building_spacing
+    float fovDegrees = CAMERA_FOV_DEGREES;           // fov
+    bool fullscreen = true;                          // fullscreen (false = window of --size)
+    int monitor = 0;                                 // monitor (index, 0 = primary)
+    bool softWatchUi = false;                        // watch_ui (gl = screen shader into watchFBO, cpu = SoftRaster.h)
+    int watchUiThreads = 0;                          // watch_ui_threads (CPU watch UI threads, 0 = one per core)
+    bool displayLink = false;                        // display_link (simulate the panel bus, see DisplayLink.h)
+    double displayBusMHz = DISPLAY_BUS_MHZ;          // display_bus_mhz
+    DisplayPixelFormat displayFormat = DISPLAY_RGB888;  // display_format (rgb888, rgb565, rgb444; see DisplayFormat.h)
+    DisplayDither displayDither = DITHER_ORDERED;    // display_dither (none, ordered, blue_noise)
+    GroundShading groundShading = GROUND_SHADING_AUTO;  // ground_shading (texture, procedural, auto)
+    bool vertexPull = true;                          // vertex_pull (scene meshes fetched from buffers, see VertexPull.h)
+
+    // Quality-dependent: < 0 until set explicitly or resolved from the tier
+    int watchScreenSize = -1;                        // watch_screen_size
+    int streetLights = -1;                           // lights
+    float farPlane = -1.0f;                          // far_plane
+};
+
+/**
+ * Sets one setting from its text value
+ * @return false (with a message) for an unknown key or a value that does not parse
+ */
+bool configSet(RuntimeConfig& config, const char* key, const char* value);
+
+/**
+ * Sets "key=value" (the --set form)
+ */
+bool configSetPair(RuntimeConfig& config, const char* pair);
+
+/**
+ * Reads a config file; bad lines are reported with their line number and skipped
+ * @return false if the file cannot be opened
+ */
+bool configLoadFile(RuntimeConfig& config, const char* path);
+
+/**
+ * Resolves the quality tier defaults and clamps every setting into its
+ * valid range, reporting each value it had to change
+ * @return true if nothing had to be changed
+ */
+bool configValidate(RuntimeConfig& config);
+
+// Seconds per frame at the target frame rate
+double configFrameTime(const RuntimeConfig& config);
+
+// Applies the scene size settings to the scene layout (Scene.h)
+void configApplyScene(const RuntimeConfig& config);
+
+// Prints the resolved settings on one line
+void configReport(const RuntimeConfig& config);
+
+// Writes the resolved settings as the "config" member of a JSON object (with trailing comma)
+void configWriteJson(FILE* f, const RuntimeConfig& config);
@@ -0,0 +1,246 @@
+#include "DisplayFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DISPLAY_FORMAT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const char* const DISPLAY_FORMAT_NAMES[DISPLAY_FORMAT_COUNT] = { "rgb888", "rgb565", "rgb444" };
+const char* const DISPLAY_DITHER_NAMES[DITHER_COUNT] = { "none", "ordered", "blue_noise" };
+
+const int BAYER_SIZE = 8;
+const int BLUE_NOISE_SIZE = 32;
+const int THRESHOLD_ROW = 32;   // Every matrix size divides this
+
+void displayChannelBits(DisplayPixelFormat format, int bits[3]) {
+    bits[0] = bits[1] = bits[2] = 8;
+    if (format == DISPLAY_RGB565) { bits[0] = 5; bits[1] = 6; bits[2] = 5; }
+    else if (format == DISPLAY_RGB444) { bits[0] = bits[1] = bits[2] = 4; }
+}
+
+int displayBytesPerPixel(DisplayPixelFormat format) {
+    return format == DISPLAY_RGB888 ? 3 : 2;
+}
+
+// ==================== DITHER MATRICES ====================
+
+// Threshold of rank out of count, strictly below 255 so a full channel never rounds past its top level
+static unsigned char rankThreshold(int rank, int count) {
+    return (unsigned char)((2 * rank + 1) * 255 / (2 * count));
+}
+
+// Bayer index: bit-reversed interleave of x ^ y and y
+static void buildBayer(unsigned char* out) {
+    const int bitsPerAxis = 3;
+    for (int y = 0; y < BAYER_SIZE; y++) {
+        for (int x = 0; x < BAYER_SIZE; x++) {
+            int rank = 0;
+            for (int bit = 0; bit < bitsPerAxis; bit++) {
+                int shift = 2 * (bitsPerAxis - 1 - bit);
+                rank |= ((((x ^ y) >> bit) & 1) << (shift + 1)) | (((y >> bit) & 1) << shift);
+            }
+            out[y * BAYER_SIZE + x] = rankThreshold(rank, BAYER_SIZE * BAYER_SIZE);
+        }
+    }
+}
+
+/*
+ * Void-and-cluster (Ulichney): pixels are ranked by repeatedly taking the
+ * tightest cluster out of a binary pattern (from the initial pattern down
+ * to none) and filling the largest void (from it up to all pixels). Energy
+ * is a toroidal Gaussian, updated incrementally as pixels flip.
+ */
+struct VoidCluster {
+    int n;
+    std::vector<float> kernel;   // Gaussian by toroidal (dx, dy)
+    std::vector<float> energy;
+    std::vector<unsigned char> on;
+
+    explicit VoidCluster(int n) : n(n), kernel(n * n), energy(n * n, 0.0f), on(n * n, 0) {
+        const float sigma = 1.5f;
+        for (int dy = 0; dy < n; dy++) {
+            for (int dx = 0; dx < n; dx++) {
+                int wx = (std::min)(dx, n - dx);
+                int wy = (std::min)(dy, n - dy);
+                kernel[dy * n + dx] = expf(-(float)(wx * wx + wy * wy) / (2.0f * sigma * sigma));
+            }
+        }
+    }
+
+    void flip(int p) {
+        on[p] ^= 1;
+        float sign = on[p] ? 1.0f : -1.0f;
+        int px = p % n, py = p / n;
+        for (int y = 0; y < n; y++) {
+            const float* row = &kernel[((y - py + n) % n) * n];
+            for (int x = 0; x < n; x++) energy[y * n + x] += sign * row[(x - px + n) % n];
+        }
+    }
+
+    // Highest energy among set pixels (tightest cluster) or lowest among unset ones (largest void)
+    int find(bool cluster) const {
+        int best = -1;
+        for (int p = 0; p < n * n; p++) {
+            if ((on[p] != 0) != cluster) continue;
+            if (best < 0 || (cluster ? energy[p] > energy[best] : energy[p] < energy[best])) best = p;
+        }
+        return best;
+    }
+};
+
+static void buildBlueNoise(unsigned char* out) {
+    const int n = BLUE_NOISE_SIZE;
+    const int count = n * n;
+    VoidCluster vc(n);
+
+    // Sparse initial pattern from a fixed LCG, then relaxed until stable
+    unsigned int seed = 12345u;
+    int initial = 0;
+    while (initial < count / 10) {
+        seed = seed * 1664525u + 1013904223u;
+        int p = (int)((seed >> 8) % (unsigned int)count);
+        if (!vc.on[p]) { vc.flip(p); initial++; }
+    }
+    for (int iteration = 0; iteration < count; iteration++) {
+        int cluster = vc.find(true);
+        vc.flip(cluster);
+        int hole = vc.find(false);
+        if (hole == cluster) { vc.flip(cluster); break; }
+        vc.flip(hole);
+    }
+
+    std::vector<int> rank(count, 0);
+    std::vector<unsigned char> start = vc.on;
+    std::vector<float> startEnergy = vc.energy;
+
+    // Ranks below the initial pattern: remove clusters
+    for (int ones = initial; ones > 0; ones--) {
+        int p = vc.find(true);
+        vc.flip(p);
+        rank[p] = ones - 1;
+    }
+
+    // Ranks from it up: fill voids
+    vc.on = start;
+    vc.energy = startEnergy;
+    for (int ones = initial; ones < count; ones++) {
+        int p = vc.find(false);
+        vc.flip(p);
+        rank[p] = ones;
+    }
+
+    for (int p = 0; p < count; p++) out[p] = rankThreshold(rank[p], count);
+}
+
+const DitherMatrix& displayDitherMatrix(DisplayDither dither) {
+    static const unsigned char noneThreshold[1] = { 128 };
+    static unsigned char bayer[BAYER_SIZE * BAYER_SIZE];
+    static unsigned char blueNoise[BLUE_NOISE_SIZE * BLUE_NOISE_SIZE];
+
+    // Function-local statics are built once even with several engine threads
+    static const DitherMatrix matrices[DITHER_COUNT] = {
+        { 1, noneThreshold },
+        { BAYER_SIZE, (buildBayer(bayer), bayer) },
+        { BLUE_NOISE_SIZE, (buildBlueNoise(blueNoise), blueNoise) },
+    };
+    return matrices[dither];
+}
+
+// ==================== CONVERSION ====================
+
+static inline int quantize(int c, int levels, int threshold) {
+    int x = c * levels + threshold + 1;
+    return (x + (x >> 8)) >> 8;   // floor((c * levels + threshold) / 255)
+}
+
+static inline uint16_t packPixel(DisplayPixelFormat format, int r, int g, int b) {
+    if (format == DISPLAY_RGB565) return (uint16_t)((r << 11) | (g << 5) | b);
+    return (uint16_t)((r << 12) | (g << 8) | (b << 4) | 0xF);
+}
+
+#ifdef DISPLAY_FORMAT_SSE2
+/*
+ * 4 pixels per step: channels widened to 16 bits (2 pixels per register),
+ * quantized with the same floor division, then each pixel's channels are
+ * shifted into place and summed with one multiply-add (madd) per register.
+ */
+static inline __m128i quantizePair(__m128i px, __m128i levels, __m128i threshold) {
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i x = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(px, levels), threshold), one);
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Packed pixels of a register of 2 quantized pixels, in 32-bit lanes 0 and 1
+static inline __m128i packPair(__m128i q, __m128i shifts) {
+    __m128i m = _mm_madd_epi16(q, shifts);             // (r, g) and (b, x) sums per pixel
+    __m128i sum = _mm_add_epi32(m, _mm_srli_epi64(m, 32));
+    return _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 1, 2, 0));
+}
+#endif
+
+void displayConvert(const Image& rgba, DisplayPixelFormat format, DisplayDither dither, Image& out) {
+    size_t bytes = (size_t)rgba.width * rgba.height * 2;
+    if (out.pixels.size() != bytes) out.pixels.resize(bytes);
+    out.width = rgba.width;
+    out.height = rgba.height;
+    out.channels = 2;
+
+    int bits[3];
+    displayChannelBits(format, bits);
+    int levels[3] = { (1 << bits[0]) - 1, (1 << bits[1]) - 1, (1 << bits[2]) - 1 };
+    const DitherMatrix& matrix = displayDitherMatrix(dither);
+
+#ifdef DISPLAY_FORMAT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i levelVec = _mm_setr_epi16((short)levels[0], (short)levels[1], (short)levels[2], 0,
+        (short)levels[0], (short)levels[1], (short)levels[2], 0);
+    const __m128i shifts = format == DISPLAY_RGB565
+        ? _mm_setr_epi16(1 << 11, 1 << 5, 1, 0, 1 << 11, 1 << 5, 1, 0)
+        : _mm_setr_epi16(1 << 12, 1 << 8, 1 << 4, 0, 1 << 12, 1 << 8, 1 << 4, 0);
+    const __m128i fill = _mm_set1_epi32(format == DISPLAY_RGB444 ? 0xF : 0);
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    const __m128i flip = _mm_set1_epi16((short)0x8000);
+#endif
+
+    unsigned char thresholds[THRESHOLD_ROW];
+    for (int y = 0; y < rgba.height; y++) {
+        const unsigned char* matrixRow = matrix.thresholds + (y % matrix.size) * matrix.size;
+        for (int i = 0; i < THRESHOLD_ROW; i++) thresholds[i] = matrixRow[i % matrix.size];
+
+        const unsigned char* src = rgba.pixels.data() + (size_t)y * rgba.width * 4;
+        unsigned char* dst = out.pixels.data() + (size_t)y * rgba.width * 2;
+        int x = 0;
+#ifdef DISPLAY_FORMAT_SSE2
+        for (; x + 4 <= rgba.width; x += 4) {
+            int t4;
+            memcpy(&t4, thresholds + (x % THRESHOLD_ROW), 4);
+            __m128i t = _mm_unpacklo_epi8(_mm_cvtsi32_si128(t4), zero);   // t0 t1 t2 t3
+            t = _mm_unpacklo_epi16(t, t);                                  // t0 t0 t1 t1 ...
+            __m128i tLo = _mm_unpacklo_epi32(t, t);                        // t0 x4, t1 x4
+            __m128i tHi = _mm_unpackhi_epi32(t, t);                        // t2 x4, t3 x4
+
+            __m128i px = _mm_loadu_si128((const __m128i*)(src + x * 4));
+            __m128i lo = packPair(quantizePair(_mm_unpacklo_epi8(px, zero), levelVec, tLo), shifts);
+            __m128i hi = packPair(quantizePair(_mm_unpackhi_epi8(px, zero), levelVec, tHi), shifts);
+            __m128i packed = _mm_add_epi32(_mm_unpacklo_epi64(lo, hi), fill);
+
+            // 32 -> 16 bits: packs saturates signed, so shift the range down and back
+            packed = _mm_packs_epi32(_mm_sub_epi32(packed, bias), _mm_sub_epi32(packed, bias));
+            _mm_storel_epi64((__m128i*)(dst + x * 2), _mm_xor_si128(packed, flip));
+        }
+#endif
+        for (; x < rgba.width; x++) {
+            const unsigned char* p = src + x * 4;
+            int t = thresholds[x % THRESHOLD_ROW];
+            uint16_t value = packPixel(format, quantize(p[0], levels[0], t), quantize(p[1], levels[1], t),
+                quantize(p[2], levels[2], t));
+            memcpy(dst + x * 2, &value, 2);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "TextureGen.h"
+
+/*
+ * Watch panel pixel format
+ * ------------------------
+ * Watch panels store far fewer bits per pixel than the RGBA8 watch screen
+ * texture: RGB565 or RGB444 is typical. This stage reduces the composed
+ * screen to the panel format, with a dither threshold added before each
+ * channel is truncated so gradients and blended edges do not band:
+ *
+ *   q = floor((c * levels + threshold) / 255),  levels = 2^bits - 1
+ *
+ * threshold (0..255) comes from a small repeating matrix: a constant 128
+ * (no dithering, round to nearest), an 8x8 Bayer matrix (ordered) or a
+ * 32x32 void-and-cluster matrix (blue noise). Both matrices are
+ * deterministic and stable in time, so a static screen converts to the same
+ * pixels every frame and the display link (DisplayLink.h) still sends only
+ * what changed.
+ *
+ * The CPU path converts with displayConvert; the GL path runs the same
+ * formula in display.frag with the matrix uploaded as a texture, so both
+ * give the same pixels. Converted images keep 2 bytes per pixel (channels
+ * = 2): RGB565 as r5 g6 b5, RGB444 as r4 g4 b4 x4 (x = 0xF), the layouts of
+ * GL_UNSIGNED_SHORT_5_6_5 and GL_UNSIGNED_SHORT_4_4_4_4 uploads.
+ */
+
+enum DisplayPixelFormat {
+    DISPLAY_RGB888,   // Unconverted (the RGBA8 watch screen texture)
+    DISPLAY_RGB565,
+    DISPLAY_RGB444,
+    DISPLAY_FORMAT_COUNT
+};
+
+enum DisplayDither {
+    DITHER_NONE,
+    DITHER_ORDERED,      // 8x8 Bayer
+    DITHER_BLUE_NOISE,   // 32x32 void-and-cluster
+    DITHER_COUNT
+};
+
+// Config names (display_format, display_dither)
+extern const char* const DISPLAY_FORMAT_NAMES[DISPLAY_FORMAT_COUNT];   // rgb888, rgb565, rgb444
+extern const char* const DISPLAY_DITHER_NAMES[DITHER_COUNT];           // none, ordered, blue_noise
+
+// size x size thresholds (0..255), repeated over the screen; row 0 is the bottom row
+struct DitherMatrix {
+    int size;
+    const unsigned char* thresholds;
+};
+
+/**
+ * Threshold matrix of a dither mode (built on first use, then shared)
+ */
+const DitherMatrix& displayDitherMatrix(DisplayDither dither);
+
+// Bits per channel (r, g, b) of a format
+void displayChannelBits(DisplayPixelFormat format, int bits[3]);
+
+// Bytes per pixel the panel stores (3 for RGB888, else 2)
+int displayBytesPerPixel(DisplayPixelFormat format);
+
+/**
+ * Converts an RGBA image to a 16-bit format (RGB565 or RGB444)
+ * out is resized only when its size changes
+ */
+void displayConvert(const Image& rgba, DisplayPixelFormat format, DisplayDither dither, Image& out);
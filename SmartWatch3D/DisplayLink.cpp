@@ -0,0 +1,272 @@
+#include "DisplayLink.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DISPLAY_LINK_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const int TILE_PIXELS = DISPLAY_TILE * DISPLAY_TILE;
+
+// Bytes a pixel takes on the bus: RGB888 for RGBA frames, else the 16-bit value
+static int pixelBytes(int channels) {
+    return channels == 4 ? 3 : 2;
+}
+
+void displayLinkInit(DisplayLink& link, int size, int channels, double busMHz) {
+    link.busMHz = busMHz;
+    link.panel.width = size;
+    link.panel.height = size;
+    link.panel.channels = channels;
+    link.panel.pixels.assign((size_t)size * size * channels, 0);
+    link.panelValid = false;
+
+    // Worst case: every tile changed and sent raw
+    int tiles = (size + DISPLAY_TILE - 1) / DISPLAY_TILE;
+    link.packet.clear();
+    link.packet.reserve((size_t)tiles * tiles * (DISPLAY_TILE_HEADER_BYTES + TILE_PIXELS * pixelBytes(channels)));
+    displayLinkResetStats(link);
+}
+
+void displayLinkResetStats(DisplayLink& link) {
+    for (DisplayScreenStats& s : link.screens) s = DisplayScreenStats();
+}
+
+// ==================== TILE COMPARE ====================
+
+/**
+ * Whether rows rows of rowBytes differ between the two images (same stride)
+ * RGBA frames (channels 4) ignore alpha: it is never sent, so an alpha-only
+ * change must not re-send a tile
+ */
+static bool tileDiffers(const unsigned char* a, const unsigned char* b, size_t stride, int rowBytes, int rows,
+    int channels) {
+    bool ignoreAlpha = channels == 4;
+#ifdef DISPLAY_LINK_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(ignoreAlpha ? 0x00FFFFFF : -1);   // Little endian: alpha is the top byte
+#endif
+    for (int y = 0; y < rows; y++, a += stride, b += stride) {
+        int i = 0;
+#ifdef DISPLAY_LINK_SSE2
+        __m128i diff = zero;
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+            diff = _mm_or_si128(diff, _mm_and_si128(_mm_xor_si128(va, vb), mask));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF) return true;
+#endif
+        if (!ignoreAlpha) {
+            if (memcmp(a + i, b + i, rowBytes - i) != 0) return true;
+            continue;
+        }
+        for (; i < rowBytes; i += 4) {
+            if (memcmp(a + i, b + i, 3) != 0) return true;
+        }
+    }
+    return false;
+}
+
+static void copyTile(unsigned char* dst, const unsigned char* src, size_t stride, int rowBytes, int rows) {
+    for (int y = 0; y < rows; y++, dst += stride, src += stride) memcpy(dst, src, rowBytes);
+}
+
+// ==================== TILE ENCODING ====================
+
+static int rleBytes(const uint32_t* px, int count, int bytes) {
+    int runs = 0;
+    for (int i = 0; i < count; runs++) {
+        int j = i + 1;
+        while (j < count && j - i < 256 && px[j] == px[i]) j++;
+        i = j;
+    }
+    return runs * (1 + bytes);
+}
+
+static int indexBits(int colors) {
+    return colors <= 2 ? 1 : (colors <= 4 ? 2 : 4);
+}
+
+/**
+ * Collects the tile's colors into palette (at most 16)
+ * @return Palette payload size, or -1 if the tile has more than 16 colors
+ */
+static int paletteBytes(const uint32_t* px, int count, int bytes, uint32_t* palette, int& colors) {
+    colors = 0;
+    for (int i = 0; i < count; i++) {
+        int c = 0;
+        while (c < colors && palette[c] != px[i]) c++;
+        if (c == colors) {
+            if (colors == 16) return -1;
+            palette[colors++] = px[i];
+        }
+    }
+    return 1 + colors * bytes + (count * indexBits(colors) + 7) / 8;
+}
+
+// A pixel value, little endian
+static void putPixel(std::vector<unsigned char>& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((unsigned char)(value >> (8 * i)));
+}
+
+static void writeRle(std::vector<unsigned char>& out, const uint32_t* px, int count, int bytes) {
+    for (int i = 0; i < count;) {
+        int j = i + 1;
+        while (j < count && j - i < 256 && px[j] == px[i]) j++;
+        out.push_back((unsigned char)(j - i - 1));
+        putPixel(out, px[i], bytes);
+        i = j;
+    }
+}
+
+static void writePalette(std::vector<unsigned char>& out, const uint32_t* px, int count, int bytes,
+    const uint32_t* palette, int colors) {
+    out.push_back((unsigned char)(colors - 1));
+    for (int c = 0; c < colors; c++) putPixel(out, palette[c], bytes);
+
+    // Indices packed from the most significant bit
+    int bits = indexBits(colors);
+    unsigned int acc = 0;
+    int accBits = 0;
+    for (int i = 0; i < count; i++) {
+        int c = 0;
+        while (palette[c] != px[i]) c++;
+        acc = (acc << bits) | (unsigned int)c;
+        accBits += bits;
+        if (accBits == 8) {
+            out.push_back((unsigned char)acc);
+            acc = 0;
+            accBits = 0;
+        }
+    }
+    if (accBits > 0) out.push_back((unsigned char)(acc << (8 - accBits)));
+}
+
+/**
+ * Appends a tile (header and smallest payload) to the packet
+ * @return The mode used
+ */
+static DisplayTileMode encodeTile(std::vector<unsigned char>& out, const Image& frame,
+    int tileX, int tileY, int w, int h) {
+    uint32_t px[TILE_PIXELS];
+    int count = 0;
+    int channels = frame.channels;
+    int bytes = pixelBytes(channels);
+    for (int y = 0; y < h; y++) {
+        const unsigned char* row = frame.pixels.data() +
+            ((size_t)(tileY * DISPLAY_TILE + y) * frame.width + (size_t)tileX * DISPLAY_TILE) * channels;
+        for (int x = 0; x < w; x++, row += channels) {
+            px[count] = (uint32_t)row[0] | ((uint32_t)row[1] << 8);
+            if (channels == 4) px[count] |= (uint32_t)row[2] << 16;
+            count++;
+        }
+    }
+
+    uint32_t palette[16];
+    int colors = 0;
+    int raw = count * bytes;
+    int rle = rleBytes(px, count, bytes);
+    int pal = paletteBytes(px, count, bytes, palette, colors);
+
+    DisplayTileMode mode = DISPLAY_TILE_RAW;
+    int payload = raw;
+    if (rle < payload) { mode = DISPLAY_TILE_RLE; payload = rle; }
+    if (pal >= 0 && pal < payload) { mode = DISPLAY_TILE_PALETTE; payload = pal; }
+
+    out.push_back((unsigned char)tileX);
+    out.push_back((unsigned char)tileY);
+    out.push_back((unsigned char)mode);
+    out.push_back((unsigned char)payload);
+    out.push_back((unsigned char)(payload >> 8));
+
+    switch (mode) {
+    case DISPLAY_TILE_RAW:
+        for (int i = 0; i < count; i++) putPixel(out, px[i], bytes);
+        break;
+    case DISPLAY_TILE_RLE:
+        writeRle(out, px, count, bytes);
+        break;
+    default:
+        writePalette(out, px, count, bytes, palette, colors);
+        break;
+    }
+    return mode;
+}
+
+// ==================== FRAMES ====================
+
+DisplayLinkFrame displayLinkPush(DisplayLink& link, const Image& frame, int screen) {
+    DisplayLinkFrame result = {};
+    link.packet.clear();
+
+    int size = link.panel.width;
+    int tiles = (size + DISPLAY_TILE - 1) / DISPLAY_TILE;
+    int channels = link.panel.channels;
+    size_t stride = (size_t)size * channels;
+    result.tileCount = tiles * tiles;
+
+    for (int ty = 0; ty < tiles; ty++) {
+        int h = (std::min)(DISPLAY_TILE, size - ty * DISPLAY_TILE);
+        for (int tx = 0; tx < tiles; tx++) {
+            int w = (std::min)(DISPLAY_TILE, size - tx * DISPLAY_TILE);
+            size_t offset = (size_t)ty * DISPLAY_TILE * stride + (size_t)tx * DISPLAY_TILE * channels;
+            const unsigned char* src = frame.pixels.data() + offset;
+            unsigned char* dst = link.panel.pixels.data() + offset;
+
+            if (link.panelValid && !tileDiffers(src, dst, stride, w * channels, h, channels)) continue;
+
+            result.modeTiles[encodeTile(link.packet, frame, tx, ty, w, h)]++;
+            result.changedTiles++;
+            copyTile(dst, src, stride, w * channels, h);
+        }
+    }
+    link.panelValid = true;
+
+    result.bytes = (unsigned int)link.packet.size();
+    result.busMs = result.bytes * 8.0 / (link.busMHz * 1000.0);
+
+    if (screen >= 0 && screen < WATCH_UI_SCREEN_COUNT) {
+        DisplayScreenStats& s = link.screens[screen];
+        s.frames++;
+        s.changedTiles += result.changedTiles;
+        s.bytes += result.bytes;
+        s.maxBytes = (std::max)(s.maxBytes, result.bytes);
+        s.busMs += result.busMs;
+        s.maxBusMs = (std::max)(s.maxBusMs, result.busMs);
+    }
+    return result;
+}
+
+// ==================== OUTPUT ====================
+
+void displayLinkReport(const DisplayLink& link) {
+    int size = link.panel.width;
+    printf("Display link (%.1f MHz bus, full frame %d B):\n", link.busMHz,
+        size * size * pixelBytes(link.panel.channels));
+    for (int i = 0; i < WATCH_UI_SCREEN_COUNT; i++) {
+        const DisplayScreenStats& s = link.screens[i];
+        if (s.frames == 0) continue;
+        printf("  %-12s %5d frames, %8.0f B/frame (max %u), %6.1f tiles/frame, bus %.3f ms (max %.3f ms)\n",
+            WATCH_UI_SCREEN_NAMES[i], s.frames, s.bytes / s.frames, s.maxBytes,
+            s.changedTiles / s.frames, s.busMs / s.frames, s.maxBusMs);
+    }
+}
+
+void displayLinkWriteJson(FILE* f, const DisplayLink& link) {
+    fprintf(f, "  \"display_link\": { \"bus_mhz\": %.2f, \"screens\": {", link.busMHz);
+    bool first = true;
+    for (int i = 0; i < WATCH_UI_SCREEN_COUNT; i++) {
+        const DisplayScreenStats& s = link.screens[i];
+        if (s.frames == 0) continue;
+        fprintf(f, "%s \"%s\": { \"frames\": %d, \"bytes_per_frame\": %.1f, \"max_bytes\": %u, "
+            "\"tiles_per_frame\": %.2f, \"bus_ms\": %.4f, \"max_bus_ms\": %.4f }",
+            first ? "" : ",", WATCH_UI_SCREEN_NAMES[i], s.frames, s.bytes / s.frames, s.maxBytes,
+            s.changedTiles / s.frames, s.busMs / s.frames, s.maxBusMs);
+        first = false;
+    }
+    fprintf(f, " } },\n");
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+#include "TextureGen.h"
+#include "WatchUi.h"
+
+/*
+ * Display link simulation
+ * -----------------------
+ * A real watch pushes its frames to the panel over a slow serial bus, so
+ * it only sends what changed. This stage plays the display driver after the
+ * watch screen is composed: the new frame is compared with the panel
+ * contents (the previous frame) in DISPLAY_TILE square tiles, 16 bytes per
+ * SSE2 compare, and only the changed tiles are encoded into a packet.
+ *
+ * Each changed tile is sent as a 5-byte header (tile x, tile y, mode,
+ * payload length as 16 bits little endian) and the smallest of three
+ * payloads:
+ *   raw      one pixel value per pixel, row by row
+ *   RLE      runs of one color: [run length - 1][pixel]
+ *   palette  [colors - 1][colors x pixel][indices at 1, 2 or 4 bits], up to 16 colors
+ * A pixel value is RGB888 (3 bytes, alpha is not sent) for RGBA frames, or
+ * the 16-bit panel value (2 bytes, little endian) for frames already
+ * converted to RGB565/RGB444 (DisplayFormat.h). The simulated bus time is the packet size at
+ * display_bus_mhz bits per microsecond (one data line, like SPI).
+ *
+ * The link keeps bytes and bus time per watch screen, because how much
+ * changes depends on the screen: the clock changes a few digits a second,
+ * the heart rate screen scrolls the EKG every frame.
+ */
+
+const int DISPLAY_TILE = 16;               // Tile edge in pixels
+const int DISPLAY_TILE_HEADER_BYTES = 5;
+
+enum DisplayTileMode {
+    DISPLAY_TILE_RAW,
+    DISPLAY_TILE_RLE,
+    DISPLAY_TILE_PALETTE,
+    DISPLAY_TILE_MODE_COUNT
+};
+
+// One pushed frame
+struct DisplayLinkFrame {
+    int tileCount;
+    int changedTiles;
+    int modeTiles[DISPLAY_TILE_MODE_COUNT];  // Changed tiles per encoding
+    unsigned int bytes;                      // Packet size
+    double busMs;
+};
+
+// Totals over the frames pushed while a screen was shown
+struct DisplayScreenStats {
+    int frames;
+    double changedTiles;
+    double bytes;
+    unsigned int maxBytes;
+    double busMs;
+    double maxBusMs;
+};
+
+struct DisplayLink {
+    double busMHz = 0.0;
+    Image panel;                          // What the panel shows: the last frame sent (RGBA or 16-bit)
+    bool panelValid = false;              // False until the first frame: then every tile is sent
+    std::vector<unsigned char> packet;    // Encoded changed tiles of the last frame
+    DisplayScreenStats screens[WATCH_UI_SCREEN_COUNT];
+};
+
+/**
+ * Sizes the panel and packet for size x size frames
+ * @param channels 4 for RGBA frames, 2 for 16-bit panel formats
+ * @param busMHz Bus clock; one bit per clock
+ */
+void displayLinkInit(DisplayLink& link, int size, int channels, double busMHz);
+
+/**
+ * Sends a frame: encodes the tiles that differ from the panel into
+ * link.packet, updates the panel and the screen's statistics
+ * frame must have the size and channels given to displayLinkInit
+ */
+DisplayLinkFrame displayLinkPush(DisplayLink& link, const Image& frame, int screen);
+
+// Forgets the statistics (not the panel contents), e.g. when the measured frames start
+void displayLinkResetStats(DisplayLink& link);
+
+// Prints bytes per frame and bus time for each screen that was shown
+void displayLinkReport(const DisplayLink& link);
+
+// Writes the per-screen statistics as the "display_link" member of a JSON object (with trailing comma)
+void displayLinkWriteJson(FILE* f, const DisplayLink& link);
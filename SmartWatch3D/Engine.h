@@ -0,0 +1,244 @@
+#pragma once
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <future>
+#include <vector>
+
+#include "Config.h"
+#include "DisplayLink.h"
+#include "GLHandles.h"
+#include "Scene.h"
+#include "SoftRaster.h"
+#include "TextureGen.h"
+#include "VertexPull.h"
+#include "WatchUi.h"
+
+/*
+ * Engine context
+ * --------------
+ * Everything one running simulator owns: its window, the simulation state
+ * (watch, camera, scene), the GL objects it renders with and the input it
+ * received. Main.cpp passes an Engine to every function instead of using
+ * globals, and the GLFW callbacks find theirs through the window user
+ * pointer, so several engines can run in one process.
+ *
+ * Each engine renders on its own thread with its own GL context
+ * (--instances N, headless only). The profiler, GPU resource registry,
+ * texture pool and frame arena keep their state per thread, so instances
+ * never share measurements or GL objects. The runtime config (Config.h)
+ * is parsed once and shared read-only.
+ */
+
+// ----- Scenarios -----
+// --scenario NAME puts the simulation into a fixed state and advances it with
+// a fixed timestep, so every run produces the same frames
+struct Scenario {
+    const char* name;
+    int screen;        // Watch screen shown
+    bool watchView;    // Watch raised in front of the camera
+    bool running;      // Simulates holding D
+    int battery;       // Battery percentage
+};
+
+// ----- Command line options, shared by all instances -----
+struct EngineOptions {
+    int benchmarkFrames = 0;                    // Measured frames, 0 = interactive (--benchmark-frames)
+    const char* benchmarkOutPath = "benchmark.json";
+    const Scenario* scenario = NULL;            // Fixed starting state and timestep (--scenario)
+    const char* capturePath = NULL;             // PNG of the last measured frame (--capture)
+    bool headless = false;                      // Hidden window + offscreen target (--capture or --headless)
+    int captureWidth = 640;                     // Headless and windowed resolution (--size)
+    int captureHeight = 360;
+    int tiledWidth = 0;                         // Capture resolution rendered in tiles of --size, 0 = off
+    int tiledHeight = 0;                        // (--capture-size)
+    RuntimeConfig config;                       // Scene, frame pacing and quality (--config, --set)
+    bool eagerInit = false;                     // Create every texture before the first frame (--eager-init)
+    bool requireZeroAlloc = false;              // Fail if a measured frame allocates (--require-zero-alloc)
+    bool telemetry = false;                     // Publish frames for TelemetryViewer (--telemetry)
+    int instances = 1;                          // Engines run side by side (--instances)
+};
+
+// ----- Simulation state -----
+struct WorldState {
+    // Watch screen: 0 = clock, 1 = heart rate, 2 = battery, 3 = performance
+    int currentScreen = 0;
+
+    // Clock display
+    int hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    double lastSecondTime = 0;   // For updating clock every second
+
+    // Heart rate simulation
+    float bpm = 70.0f;           // Current displayed BPM
+    float targetBpm = 70.0f;     // Target BPM (increases when running)
+    float ekgOffset = 0.0f;      // Horizontal scroll of EKG graph
+    float ekgScale = 1.0f;       // Scale factor for EKG animation speed
+    bool isRunning = false;      // Whether D key is held
+
+    // Battery simulation
+    int batteryPercent = 100;    // Current battery level
+    double lastBatteryDrain = 0; // Timer for battery drain
+
+    // Camera
+    glm::vec3 cameraPos = glm::vec3(0.0f, 1.6f, 0.0f);  // Eye level height (1.6m)
+    float cameraYaw = -90.0f;      // Horizontal rotation (looking down -Z axis)
+    float cameraPitch = 0.0f;      // Vertical rotation (combined base + bob)
+    float cameraBasePitch = 0.0f;  // Base pitch from mouse input
+    bool watchViewMode = false;    // When true, watch is in front of camera
+
+    // Running animation
+    float runTime = 0.0f;          // Accumulated time while running
+    float groundOffset = 0.0f;     // How far ground has scrolled (for infinite effect)
+    float cameraBobOffset = 0.0f;  // Vertical camera bob while running
+
+    // Scene objects
+    SceneEntities sceneEntities;      // Buildings and the watch rig (see Scene.cpp)
+    SceneTransforms sceneTransforms;  // Ground, road and lights of the current frame, rebuilt by renderScene
+};
+
+// ----- Input received through the GLFW callbacks -----
+struct InputState {
+    double mouseX = 0, mouseY = 0;       // Current mouse position
+    double lastMouseX = 0, lastMouseY = 0;
+    bool firstMouse = true;              // For initializing mouse delta
+    bool mouseClicked = false;           // Left click flag for UI interaction
+    bool depthTestEnabled = true;        // F1 toggles depth testing
+    bool faceCullingEnabled = true;      // F2 toggles back-face culling
+};
+
+/*
+ * A procedural texture generated on a worker thread (see the TEXTURE JOBS
+ * section in Main.cpp)
+ */
+struct TextureJob {
+    const char* label;
+    GLint wrapS;
+    GLint wrapT;
+    Image image;                  // Written by the worker, freed after upload
+    std::shared_future<void> done;
+
+    TextureJob(const char* label, GLint wrapS, GLint wrapT) : label(label), wrapS(wrapS), wrapT(wrapT), image() {}
+};
+
+/*
+ * A 3D scene mesh, drawable both ways: its own VAO (attribute path) or its
+ * range of the vertex pool (vertex_pull)
+ */
+struct SceneMesh {
+    GLuint vao = 0;         // Not owned (one of the VAO members below)
+    int count = 0;          // Vertices, or indices when indexed
+    bool indexed = false;
+    PulledMesh pulled;
+};
+
+// ----- GL objects and the CPU data feeding them -----
+struct RenderResources {
+    // Textures
+    GlTexture groundTexture;          // Grass texture for ground
+    GlTexture roadTexture;            // Asphalt texture for road
+    GlTexture ekgTexture;             // EKG waveform pattern (created on first use)
+    GlTexture arrowRightTexture;      // Navigation arrow (right)
+    GlTexture arrowLeftTexture;       // Navigation arrow (left)
+    GlTexture heartCursorTexture;     // Heart icon for BPM display (created on first use)
+    GlTexture studentInfoTexture;     // Student name overlay (created on first use)
+    GlTexture buildingTexture;        // Building facades, a GL_TEXTURE_2D_ARRAY with BUILDING_FACADES layers
+    GlTexture watchFrameTexture;      // Watch bezel texture
+    GlTexture perfTextTexture;        // Performance screen text (refreshed a few times per second)
+    GlTexture perfGraphTexture;       // Performance screen frame-time graph (refreshed every frame)
+    GlTexture timeTexture;            // Clock digits, replaced from the texture pool when the text changes
+    GlTexture bpmTexture;             // BPM digits, replaced from the texture pool when the text changes
+    GlTexture percTexture;            // Battery percentage digits, replaced from the texture pool when the text changes
+
+    // Shader programs
+    GlProgram basicShader;   // 3D Phong lighting shader
+    GlProgram screenShader;  // 2D shader for watch UI rendering
+    GlProgram displayShader; // Watch screen to panel format (display_format other than rgb888)
+    bool proceduralGround = false;  // Ground and road colors computed in basic.frag (ground_shading)
+
+    // Vertex array objects and their buffers
+    GlVertexArray VAOground;      // Ground plane (large quad)
+    GlVertexArray VAOcube;        // Unit cube (for buildings, hand, watch frame)
+    GlVertexArray VAOwatchQuad;   // 3D quad for watch screen in world space
+    GlVertexArray VAOscreenQuad;  // 2D quad for FBO rendering
+    unsigned int VAOhand = 0;     // Hand mesh (not owned, reuses the cube VAO)
+    GlBuffer VBOground, EBOground;
+    GlBuffer VBOcube;
+    GlBuffer VBOwatchQuad, EBOwatchQuad;
+    GlBuffer VBOscreenQuad, EBOscreenQuad;
+
+    // Scene meshes and vertex pulling (vertex_pull, see VertexPull.h)
+    SceneMesh groundMesh, cubeMesh, watchQuadMesh;
+    bool vertexPull = false;       // Scene drawn from the pool with VAOempty, batches instanced
+    VertexPool vertexPool;         // Instances are refilled by every renderScene, in both paths
+    GlVertexArray VAOempty;        // Bound for pulled draws (core profile draws need a VAO)
+    GlBuffer pullVertexBuffer, pullInstanceBuffer;
+    GlTexture pullVertexTexture, pullInstanceTexture;  // GL_TEXTURE_BUFFER views of the buffers (RGBA32F)
+
+    // Watch UI render target, applied to the 3D watch quad
+    GlFramebuffer watchFBO;
+    GlTexture watchScreenTexture;
+
+    // Watch screen in the panel format (display_format other than rgb888); replaces
+    // watchScreenTexture on the watch quad
+    GlFramebuffer displayFBO;
+    GlTexture displayTexture;
+    GlTexture ditherTexture;     // Threshold matrix of display_dither
+    Image displayImage;          // CPU path: the converted screen
+
+    // Final render target: 0 = window, otherwise the offscreen capture framebuffer
+    GlFramebuffer sceneFBO;
+    GlRenderbuffer sceneColorRBO;
+    GlRenderbuffer sceneDepthRBO;
+
+    // Background texture generation
+    TextureJob groundJob{ "ground", GL_REPEAT, GL_REPEAT };
+    TextureJob roadJob{ "road", GL_REPEAT, GL_REPEAT };
+    TextureJob buildingJob{ "building", GL_REPEAT, GL_REPEAT };
+    TextureJob arrowRightJob{ "arrow_right", GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    TextureJob arrowLeftJob{ "arrow_left", GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    TextureJob ekgJob{ "ekg", GL_REPEAT, GL_CLAMP_TO_EDGE };
+    TextureJob heartJob{ "heart", GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    TextureJob studentInfoJob{ "student_info", GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+
+    // CPU images behind the dynamic textures
+    Image textureImage;                      // Scratch for digit textures
+    Image perfText;
+    Image perfGraph;
+    bool perfTextChanged = false;            // perfText not uploaded yet
+
+    // Text currently shown by the digit textures and the performance screen
+    char lastTimeStr[16] = "";
+    char lastBpmStr[16] = "";
+    char lastPercStr[8] = "";
+    double lastPerfTextUpdate = -1.0e9;
+
+    // Watch UI quads of the current frame (GL path)
+    std::vector<WatchUiQuad> watchUiQuads;
+
+    // CPU watch UI renderer (watch_ui = cpu), uploaded into watchScreenTexture
+    SoftWatchUi softWatchUi;
+    double softWatchUiMs = 0.0;  // softWatchUiRender time summed over the measured frames
+    int softWatchUiFrames = 0;
+
+    // Simulated watch panel (display_link); the GL path reads its screen back into watchReadback
+    // (RGBA, or 16-bit from displayFBO)
+    DisplayLink displayLink;
+    Image watchReadback;
+};
+
+struct Engine {
+    int instance = 0;               // Index among the engines of this process
+    const EngineOptions* options = NULL;
+    GLFWwindow* window = NULL;
+    bool mainThread = true;         // Polls GLFW events and reads the keyboard (GLFW allows this on the main thread only)
+    int screenWidth = 1920;
+    int screenHeight = 1080;
+    double startupMs = 0.0;         // Engine start -> first frame presented
+
+    WorldState world;
+    InputState input;
+    RenderResources gpu;
+};
@@ -0,0 +1,132 @@
+#include "Entities.h"
+
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+void entityClear(EntityStore& store) {
+    for (std::vector<float>* column : { &store.posX, &store.posY, &store.posZ, &store.rotX, &store.rotY,
+        &store.scaleX, &store.scaleY, &store.scaleZ, &store.boundsRadius,
+        &store.worldX, &store.worldY, &store.worldZ }) {
+        column->clear();
+    }
+    store.material.clear();
+    store.flags.clear();
+    store.variant.clear();
+    store.color.clear();
+    store.model.clear();
+}
+
+size_t entityCount(const EntityStore& store) {
+    return store.posX.size();
+}
+
+EntityId entityCreate(EntityStore& store, const glm::vec3& position, const glm::vec3& scale,
+    const glm::vec3& color, EntityMaterial material, unsigned char flags) {
+    EntityId id = (EntityId)entityCount(store);
+
+    store.posX.push_back(position.x);
+    store.posY.push_back(position.y);
+    store.posZ.push_back(position.z);
+    store.rotX.push_back(0.0f);
+    store.rotY.push_back(0.0f);
+    store.scaleX.push_back(scale.x);
+    store.scaleY.push_back(scale.y);
+    store.scaleZ.push_back(scale.z);
+    store.boundsRadius.push_back(0.5f * glm::length(scale));
+    store.material.push_back((unsigned char)material);
+    store.flags.push_back(flags);
+    store.variant.push_back(0);
+    store.color.push_back(color);
+
+    store.worldX.push_back(position.x);
+    store.worldY.push_back(position.y);
+    store.worldZ.push_back(position.z);
+    store.model.push_back(glm::mat4(1.0f));
+    return id;
+}
+
+void entitySetPose(EntityStore& store, EntityId id, const glm::vec3& position, float rotX, float rotY) {
+    store.posX[id] = position.x;
+    store.posY[id] = position.y;
+    store.posZ[id] = position.z;
+    store.rotX[id] = rotX;
+    store.rotY[id] = rotY;
+}
+
+// ==================== TRANSFORM PASS ====================
+
+void entityUpdateTransforms(EntityStore& store, float groundOffset, float wrapLength) {
+    size_t count = entityCount(store);
+    const unsigned char* flags = store.flags.data();
+
+    // World positions, one column at a time
+    for (size_t i = 0; i < count; i++) {
+        if (flags[i] & ENTITY_PARENTED) continue;
+        store.worldX[i] = store.posX[i];
+        store.worldY[i] = store.posY[i];
+        store.worldZ[i] = store.posZ[i];
+    }
+
+    // INFINITE SCROLLING: wrap entities that move with the ground when they go too far
+    for (size_t i = 0; i < count; i++) {
+        if (!(flags[i] & ENTITY_SCROLLS)) continue;
+        float z = store.worldZ[i] + groundOffset;
+        while (z > 10.0f) z -= wrapLength;
+        while (z < -wrapLength) z += wrapLength;
+        store.worldZ[i] = z;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (flags[i] & ENTITY_PARENTED) continue;
+        glm::vec3 world(store.worldX[i], store.worldY[i], store.worldZ[i]);
+        glm::vec3 scale(store.scaleX[i], store.scaleY[i], store.scaleZ[i]);
+
+        if (store.rotX[i] == 0.0f && store.rotY[i] == 0.0f) {
+            // Translate * scale written directly (same result as glm::translate + glm::scale)
+            glm::mat4& m = store.model[i];
+            m = glm::mat4(1.0f);
+            m[0][0] = scale.x;
+            m[1][1] = scale.y;
+            m[2][2] = scale.z;
+            m[3] = glm::vec4(world, 1.0f);
+            continue;
+        }
+
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), world);
+        if (store.rotX[i] != 0.0f) m = glm::rotate(m, glm::radians(store.rotX[i]), glm::vec3(1.0f, 0.0f, 0.0f));
+        if (store.rotY[i] != 0.0f) m = glm::rotate(m, glm::radians(store.rotY[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+        store.model[i] = glm::scale(m, scale);
+    }
+}
+
+// ==================== FRUSTUM CULLING ====================
+
+int entityCull(EntityStore& store, const glm::mat4& viewProjection) {
+    size_t count = entityCount(store);
+    unsigned char* flags = store.flags.data();
+    const float* x = store.worldX.data();
+    const float* y = store.worldY.data();
+    const float* z = store.worldZ.data();
+    const float* radius = store.boundsRadius.data();
+
+    for (size_t i = 0; i < count; i++) flags[i] |= ENTITY_VISIBLE;
+
+    // Frustum planes from the rows of the matrix (Gribb/Hartmann): left, right, bottom, top, near, far
+    glm::mat4 m = glm::transpose(viewProjection);
+    const glm::vec4 planes[6] = { m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2] };
+
+    // One plane at a time over all entities, so the inner loop is branch-free
+    for (const glm::vec4& p : planes) {
+        float invLength = 1.0f / std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        glm::vec4 n = p * invLength;
+        for (size_t i = 0; i < count; i++) {
+            float distance = n.x * x[i] + n.y * y[i] + n.z * z[i] + n.w;
+            unsigned char keep = distance >= -radius[i] ? 0xFF : (unsigned char)~ENTITY_VISIBLE;
+            flags[i] &= keep;
+        }
+    }
+
+    int visible = 0;
+    for (size_t i = 0; i < count; i++) visible += flags[i] & ENTITY_VISIBLE;
+    return visible;
+}
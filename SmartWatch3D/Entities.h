@@ -0,0 +1,77 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+/*
+ * Entity store
+ * ------------
+ * Scene objects (buildings and the watch rig) kept as structure-of-arrays
+ * columns: entity i is element i of every column. The per-frame passes
+ * (transforms, frustum culling) each read only the columns they need, as
+ * contiguous float arrays, instead of striding over whole objects.
+ *
+ * Positions and scales are split into x/y/z columns so the loops work on
+ * plain floats and can vectorize. The transform pass writes the world
+ * position and model matrix columns; the cull pass writes ENTITY_VISIBLE.
+ */
+
+typedef int EntityId;
+
+// Index into the renderer's material table
+enum EntityMaterial {
+    MATERIAL_BUILDING,
+    MATERIAL_SKIN,
+    MATERIAL_WATCH_FRAME,
+    MATERIAL_WATCH_SCREEN,
+    MATERIAL_COUNT
+};
+
+enum EntityFlags {
+    ENTITY_VISIBLE = 1,          // Inside the view frustum (written by entityCull)
+    ENTITY_SCROLLS = 2,          // Moves with the ground and wraps around (buildings)
+    ENTITY_PARENTED = 4,         // Transform written by a hierarchy node (watch rig, see Hierarchy.h)
+};
+
+struct EntityStore {
+    // Input columns
+    std::vector<float> posX, posY, posZ;        // Center (unused with ENTITY_PARENTED)
+    std::vector<float> rotX, rotY;              // Degrees, applied X then Y (unused with ENTITY_PARENTED)
+    std::vector<float> scaleX, scaleY, scaleZ;  // Size of the unit mesh
+    std::vector<float> boundsRadius;            // Bounding sphere around the center
+    std::vector<unsigned char> material;        // EntityMaterial
+    std::vector<unsigned char> flags;           // EntityFlags
+    std::vector<unsigned char> variant;         // Appearance variant (facade layer of buildings), 0 by default
+    std::vector<glm::vec3> color;
+
+    // Output columns, one frame's worth
+    std::vector<float> worldX, worldY, worldZ;
+    std::vector<glm::mat4> model;
+};
+
+void entityClear(EntityStore& store);
+size_t entityCount(const EntityStore& store);
+
+/**
+ * Appends an entity; the bounding radius is derived from the scale
+ * (half the diagonal of the scaled unit mesh)
+ */
+EntityId entityCreate(EntityStore& store, const glm::vec3& position, const glm::vec3& scale,
+    const glm::vec3& color, EntityMaterial material, unsigned char flags);
+
+// Moves an entity that is not parented; rotations in degrees
+void entitySetPose(EntityStore& store, EntityId id, const glm::vec3& position, float rotX, float rotY);
+
+/**
+ * Computes world positions and model matrices of all entities except the
+ * parented ones. Scrolling entities are offset by groundOffset and wrapped
+ * into [-wrapLength, 10].
+ */
+void entityUpdateTransforms(EntityStore& store, float groundOffset, float wrapLength);
+
+/**
+ * Sets ENTITY_VISIBLE on entities whose bounding sphere touches the frustum
+ * of viewProjection (uses the world positions of the last transform pass)
+ *
+ * @return Number of visible entities
+ */
+int entityCull(EntityStore& store, const glm::mat4& viewProjection);
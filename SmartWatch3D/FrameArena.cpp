@@ -0,0 +1,161 @@
+#include "FrameArena.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Malloc'd allocation that did not fit; linked into its half and freed on reset
+struct OverflowBlock {
+    OverflowBlock* next;
+};
+
+struct ArenaHalf {
+    unsigned char* base;
+    size_t used;
+    OverflowBlock* overflow;
+    size_t overflowBytes;
+};
+
+// Each render thread has its own arena and allocation count
+static thread_local ArenaHalf halves[2];
+static thread_local int currentHalf = 0;
+static thread_local size_t capacity = 0;
+static thread_local size_t peakBytes = 0;
+static thread_local unsigned int overflowCount = 0;
+static thread_local size_t overflowTotalBytes = 0;
+
+static thread_local unsigned int heapAllocations = 0;
+static thread_local bool trackThread = false;
+
+static void releaseHalf(ArenaHalf& half) {
+    OverflowBlock* block = half.overflow;
+    while (block != NULL) {
+        OverflowBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    half.used = 0;
+    half.overflow = NULL;
+    half.overflowBytes = 0;
+}
+
+void frameArenaInit(size_t bytesPerHalf) {
+    capacity = bytesPerHalf;
+    for (ArenaHalf& half : halves) {
+        half.base = (unsigned char*)malloc(capacity);
+        half.used = 0;
+        half.overflow = NULL;
+        half.overflowBytes = 0;
+    }
+    currentHalf = 0;
+}
+
+void frameArenaShutdown() {
+    for (ArenaHalf& half : halves) {
+        releaseHalf(half);
+        free(half.base);
+        half.base = NULL;
+    }
+    capacity = 0;
+}
+
+void frameArenaBeginFrame() {
+    currentHalf = 1 - currentHalf;
+    releaseHalf(halves[currentHalf]);
+}
+
+void* frameArenaAlloc(size_t bytes, size_t align) {
+    ArenaHalf& half = halves[currentHalf];
+    size_t start = (half.used + align - 1) & ~(align - 1);
+
+    if (half.base != NULL && start + bytes <= capacity) {
+        half.used = start + bytes;
+        size_t total = half.used + half.overflowBytes;
+        if (total > peakBytes) peakBytes = total;
+        return half.base + start;
+    }
+
+    // Overflow: room for the link, the data and alignment padding
+    OverflowBlock* block = (OverflowBlock*)malloc(sizeof(OverflowBlock) + bytes + align);
+    if (block == NULL) throw std::bad_alloc();
+    block->next = half.overflow;
+    half.overflow = block;
+    half.overflowBytes += bytes;
+    overflowCount++;
+    overflowTotalBytes += bytes;
+    heapAllocations++;
+
+    size_t total = half.used + half.overflowBytes;
+    if (total > peakBytes) peakBytes = total;
+
+    uintptr_t data = (uintptr_t)(block + 1);
+    return (void*)((data + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+const char* frameArenaPrintf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list sizing;
+    va_copy(sizing, args);
+    int length = vsnprintf(NULL, 0, format, sizing);
+    va_end(sizing);
+
+    char* text = (char*)frameArenaAlloc(length > 0 ? length + 1 : 1, 1);
+    if (length > 0) vsnprintf(text, length + 1, format, args);
+    else text[0] = '\0';
+    va_end(args);
+    return text;
+}
+
+FrameArenaStats frameArenaStats() {
+    FrameArenaStats stats;
+    stats.capacity = capacity;
+    stats.used = halves[currentHalf].used;
+    stats.peak = peakBytes;
+    stats.overflows = overflowCount;
+    stats.overflowBytes = overflowTotalBytes;
+    return stats;
+}
+
+// ==================== HEAP ALLOCATION COUNTING ====================
+
+void heapTrackThisThread() {
+    trackThread = true;
+}
+
+unsigned int heapAllocationCount() {
+    return heapAllocations;
+}
+
+/*
+ * Replacements for the global allocation functions, so every operator new
+ * on a tracked thread is counted (array and nothrow forms call these).
+ */
+void* operator new(size_t size) {
+    if (trackThread) heapAllocations++;
+    void* p = malloc(size != 0 ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+ * Per-frame arena
+ * ---------------
+ * A bump allocator for data that only lives for the frame that creates it
+ * (uniform names, scratch arrays, draw lists). Allocating is a pointer
+ * increment and nothing is freed individually; the whole arena is reset at
+ * frame start instead.
+ *
+ * Double-buffered: frame N allocates from one half, frame N + 1 from the
+ * other, so data written in a frame stays valid through the next one (e.g.
+ * while a deferred upload still reads it). Never keep arena memory longer.
+ *
+ * When a frame needs more than its half, the extra allocations fall back to
+ * malloc (freed at the next reset of that half) and are reported as
+ * overflows, so the arena size can be raised instead of silently degrading.
+ *
+ * The same module counts general heap allocations (operator new) made on
+ * the render thread, which the main loop reports as COUNTER_HEAP_ALLOCS;
+ * steady-state frames are expected to make none (--require-zero-alloc).
+ */
+
+const size_t FRAME_ARENA_SIZE = 256 * 1024;  // Bytes per half
+
+struct FrameArenaStats {
+    size_t capacity;        // Bytes per half
+    size_t used;            // Bytes used by the current frame
+    size_t peak;            // Most bytes any frame used (including overflow)
+    unsigned int overflows; // Allocations that fell back to malloc, all frames
+    size_t overflowBytes;
+};
+
+// Allocates both halves; call once at startup on the render thread
+void frameArenaInit(size_t bytesPerHalf);
+void frameArenaShutdown();
+
+// Switches halves and releases everything the new half held two frames ago
+void frameArenaBeginFrame();
+
+// Never returns NULL; align must be a power of two
+void* frameArenaAlloc(size_t bytes, size_t align);
+
+// printf into arena memory, for transient strings such as uniform names
+const char* frameArenaPrintf(const char* format, ...);
+
+FrameArenaStats frameArenaStats();
+
+// ==================== HEAP ALLOCATION COUNTING ====================
+
+// Counts operator new calls made by the calling thread from now on
+void heapTrackThisThread();
+
+// Allocations counted so far on the calling thread (operator new if tracked, plus arena overflows)
+unsigned int heapAllocationCount();
+
+// ==================== STL ADAPTERS ====================
+
+/**
+ * std allocator over the frame arena. deallocate is a no-op, so containers
+ * that grow leave their old blocks behind until the reset; reserve up front.
+ */
+template <typename T>
+struct FrameAllocator {
+    typedef T value_type;
+
+    FrameAllocator() {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(frameArenaAlloc(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> FrameString;
@@ -0,0 +1,56 @@
+#include "GLDebug.h"
+
+#ifdef SW_GL_DEBUG
+
+#include "Profiler.h"
+
+static bool debugAvailable = false;
+
+static const char* messageTypeName(GLenum type) {
+    switch (type) {
+    case GL_DEBUG_TYPE_ERROR: return "error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+    case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+    case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+    default: return "other";
+    }
+}
+
+static void GLAPIENTRY debugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* message, const void* userParam) {
+    // Our own push/pop group markers come back as messages too
+    if (type == GL_DEBUG_TYPE_PUSH_GROUP || type == GL_DEBUG_TYPE_POP_GROUP) return;
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION && type != GL_DEBUG_TYPE_PERFORMANCE) return;
+
+    profilerLog("GL %s #%u: %s", messageTypeName(type), id, message);
+}
+
+void glDebugInit() {
+    debugAvailable = GLEW_KHR_debug || GLEW_VERSION_4_3;
+    if (!debugAvailable) return;
+
+    // Synchronous, so messages arrive on the render thread right after the offending call
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(debugMessageCallback, NULL);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+}
+
+bool glDebugIsAvailable() {
+    return debugAvailable;
+}
+
+void glDebugLabel(GLenum identifier, GLuint name, const char* label) {
+    if (debugAvailable && name != 0) glObjectLabel(identifier, name, -1, label);
+}
+
+void glDebugPushGroup(const char* name) {
+    if (debugAvailable) glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+}
+
+void glDebugPopGroup() {
+    if (debugAvailable) glPopDebugGroup();
+}
+
+#endif
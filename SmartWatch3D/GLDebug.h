@@ -0,0 +1,38 @@
+#pragma once
+#include <GL/glew.h>
+
+/*
+ * KHR_debug integration
+ * ---------------------
+ * Object labels and debug groups make captures from external GPU tools
+ * (apitrace, RenderDoc, Mesa's GALLIUM_HUD) readable: every texture, buffer,
+ * FBO and program shows its name and draws are grouped by render pass.
+ * Driver messages of type PERFORMANCE (and errors) are routed into the
+ * profiler log.
+ *
+ * Only compiled when SW_GL_DEBUG is defined (Debug configurations); in
+ * release builds every function below is an empty inline and disappears.
+ * At runtime everything is a no-op when the driver lacks KHR_debug.
+ */
+
+#ifdef SW_GL_DEBUG
+
+// Call once after glewInit; installs the message callback
+void glDebugInit();
+bool glDebugIsAvailable();
+
+// identifier: GL_TEXTURE, GL_BUFFER, GL_VERTEX_ARRAY, GL_FRAMEBUFFER, GL_RENDERBUFFER, GL_PROGRAM
+void glDebugLabel(GLenum identifier, GLuint name, const char* label);
+
+void glDebugPushGroup(const char* name);
+void glDebugPopGroup();
+
+#else
+
+inline void glDebugInit() {}
+inline bool glDebugIsAvailable() { return false; }
+inline void glDebugLabel(GLenum, GLuint, const char*) {}
+inline void glDebugPushGroup(const char*) {}
+inline void glDebugPopGroup() {}
+
+#endif
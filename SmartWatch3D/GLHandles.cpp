@@ -0,0 +1,116 @@
+#include "GLHandles.h"
+#include "GLState.h"
+#include "GLTrace.h"
+
+#include <cstdio>
+
+struct TexturePoolBucket {
+    GLenum internalFormat;   // 0 = unused bucket
+    int width;
+    int height;
+    int freeCount;
+    unsigned int free[TEXTURE_POOL_BUCKET_SIZE];
+};
+
+// Pooled textures belong to the context current on this thread
+static thread_local TexturePoolBucket buckets[TEXTURE_POOL_BUCKETS];
+static thread_local TexturePoolStats poolStats;
+static thread_local bool shutDown = false;
+
+// ==================== RELEASE ====================
+
+static void deleteObject(GpuResourceType type, unsigned int id) {
+    glStateObjectDeleted(type, id);
+    switch (type) {
+    case GPU_RES_TEXTURE:      glDeleteTextures(1, &id); break;
+    case GPU_RES_BUFFER:       glDeleteBuffers(1, &id); break;
+    case GPU_RES_VERTEX_ARRAY: glDeleteVertexArrays(1, &id); break;
+    case GPU_RES_FRAMEBUFFER:  glDeleteFramebuffers(1, &id); break;
+    case GPU_RES_RENDERBUFFER: glDeleteRenderbuffers(1, &id); break;
+    case GPU_RES_PROGRAM:      glDeleteProgram(id); break;
+    default: break;
+    }
+}
+
+void glHandleRelease(GpuResourceType type, unsigned int id, int poolBucket) {
+    if (shutDown) return;
+
+    if (poolBucket >= 0) {
+        TexturePoolBucket& bucket = buckets[poolBucket];
+        if (bucket.freeCount < TEXTURE_POOL_BUCKET_SIZE) {
+            bucket.free[bucket.freeCount++] = id;
+            return;
+        }
+        poolStats.deleted++;
+    }
+    deleteObject(type, id);
+}
+
+// ==================== TEXTURE POOL ====================
+
+static int findBucket(GLenum internalFormat, int width, int height) {
+    for (int i = 0; i < TEXTURE_POOL_BUCKETS; i++) {
+        const TexturePoolBucket& b = buckets[i];
+        if (b.internalFormat == internalFormat && b.width == width && b.height == height) return i;
+    }
+    for (int i = 0; i < TEXTURE_POOL_BUCKETS; i++) {
+        TexturePoolBucket& b = buckets[i];
+        if (b.internalFormat == 0) {
+            b.internalFormat = internalFormat;
+            b.width = width;
+            b.height = height;
+            b.freeCount = 0;
+            return i;
+        }
+    }
+    return -1;  // All buckets taken: the texture is not pooled
+}
+
+GlTexture texturePoolAcquire(GLenum internalFormat, int width, int height, const char* label) {
+    int bucket = findBucket(internalFormat, width, height);
+
+    if (bucket >= 0 && buckets[bucket].freeCount > 0) {
+        unsigned int texture = buckets[bucket].free[--buckets[bucket].freeCount];
+        glStateBindTexture(0, texture);
+        poolStats.reused++;
+        return GlTexture(texture, bucket);
+    }
+
+    GLenum format = internalFormat == GL_RGB8 ? GL_RGB : GL_RGBA;
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glStateBindTexture(0, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gpuResourceSetLabel(GPU_RES_TEXTURE, texture, label);
+    poolStats.created++;
+    return GlTexture(texture, bucket);
+}
+
+void texturePoolReserve(GLenum internalFormat, int width, int height, int count, const char* label) {
+    GlTexture held[TEXTURE_POOL_BUCKET_SIZE];
+    if (count > TEXTURE_POOL_BUCKET_SIZE) count = TEXTURE_POOL_BUCKET_SIZE;
+
+    // Acquire them all at once so each one is new, then park them (held goes out of scope)
+    for (int i = 0; i < count; i++) held[i] = texturePoolAcquire(internalFormat, width, height, label);
+}
+
+TexturePoolStats texturePoolStats() {
+    return poolStats;
+}
+
+void texturePoolReport() {
+    printf("Texture pool: %d created, %d reused, %d deleted on release\n",
+        poolStats.created, poolStats.reused, poolStats.deleted);
+}
+
+void glHandlesShutdown() {
+    for (TexturePoolBucket& bucket : buckets) {
+        for (int i = 0; i < bucket.freeCount; i++) deleteObject(GPU_RES_TEXTURE, bucket.free[i]);
+        bucket.freeCount = 0;
+    }
+    shutDown = true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "GpuResources.h"
+
+/*
+ * GL object handles
+ * -----------------
+ * Move-only owners for GL objects. The object is released when its handle
+ * is reset, assigned over or destroyed, so it cannot leak on an early
+ * return or be deleted twice. A handle converts to the raw id and passes
+ * straight to gl* calls; objects are still created with glGen* at the call
+ * site (so the resource registry records the real creator) and then adopted:
+ *
+ *     unsigned int vao;
+ *     glGenVertexArrays(1, &vao);
+ *     VAOground = GlVertexArray(vao);
+ *
+ * Textures that are replaced while running (the digit displays) come from a
+ * pool bucketed by internal format and size instead. Releasing a pooled
+ * texture parks it in its bucket; the next acquire of the same format and
+ * size gets it back and overwrites it with glTexSubImage2D, so changing the
+ * text creates and deletes no GL objects. Buckets are fixed arrays and
+ * never allocate; a texture that does not fit is deleted.
+ *
+ * glHandlesShutdown deletes the pooled textures. Handles released after it
+ * (globals destroyed after the context is gone) are ignored.
+ */
+
+const int TEXTURE_POOL_BUCKETS = 16;      // Distinct format/size combinations
+const int TEXTURE_POOL_BUCKET_SIZE = 4;   // Free textures kept per combination
+
+// Deletes the object, or returns it to its pool bucket (poolBucket >= 0)
+void glHandleRelease(GpuResourceType type, unsigned int id, int poolBucket);
+
+template <GpuResourceType Type>
+class GlHandle {
+public:
+    GlHandle() : id(0), poolBucket(-1) {}
+    explicit GlHandle(unsigned int id, int poolBucket = -1) : id(id), poolBucket(poolBucket) {}
+
+    GlHandle(GlHandle&& other) noexcept : id(other.id), poolBucket(other.poolBucket) {
+        other.id = 0;
+        other.poolBucket = -1;
+    }
+
+    GlHandle& operator=(GlHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            id = other.id;
+            poolBucket = other.poolBucket;
+            other.id = 0;
+            other.poolBucket = -1;
+        }
+        return *this;
+    }
+
+    GlHandle(const GlHandle&) = delete;
+    GlHandle& operator=(const GlHandle&) = delete;
+
+    ~GlHandle() { reset(); }
+
+    void reset() {
+        if (id != 0) glHandleRelease(Type, id, poolBucket);
+        id = 0;
+        poolBucket = -1;
+    }
+
+    unsigned int get() const { return id; }
+    operator unsigned int() const { return id; }
+
+private:
+    unsigned int id;
+    int poolBucket;  // Texture pool bucket, -1 = deleted on release
+};
+
+typedef GlHandle<GPU_RES_TEXTURE> GlTexture;
+typedef GlHandle<GPU_RES_BUFFER> GlBuffer;
+typedef GlHandle<GPU_RES_VERTEX_ARRAY> GlVertexArray;
+typedef GlHandle<GPU_RES_FRAMEBUFFER> GlFramebuffer;
+typedef GlHandle<GPU_RES_RENDERBUFFER> GlRenderbuffer;
+typedef GlHandle<GPU_RES_PROGRAM> GlProgram;
+
+// ==================== TEXTURE POOL ====================
+
+struct TexturePoolStats {
+    int created;    // Acquires that had to create a texture
+    int reused;     // Acquires served from a bucket
+    int deleted;    // Releases that found their bucket full
+};
+
+/**
+ * Returns an RGB(A)8 texture with allocated but undefined contents, bound to
+ * GL_TEXTURE_2D, with linear filtering and clamped edges.
+ * The label is applied when the texture is created.
+ */
+GlTexture texturePoolAcquire(GLenum internalFormat, int width, int height, const char* label);
+
+// Creates count textures up front so later acquires of this size create nothing
+void texturePoolReserve(GLenum internalFormat, int width, int height, int count, const char* label);
+
+TexturePoolStats texturePoolStats();
+void texturePoolReport();
+
+// Deletes the pooled textures; call before the context is destroyed
+void glHandlesShutdown();
@@ -0,0 +1,196 @@
+#include "GLState.h"
+#include "GLTrace.h"
+#include "Profiler.h"
+
+// Marks a shadowed value as not known (nothing the renderer requests matches it)
+const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+struct ShadowState {
+    GLuint program;
+    GLuint vao;
+    GLuint fbo;
+    GLuint textures[GL_STATE_TEXTURE_UNITS];
+    GLuint textureArrays[GL_STATE_TEXTURE_UNITS];
+    GLuint textureBuffers[GL_STATE_TEXTURE_UNITS];
+    GLuint activeUnit;
+    GLuint depthTest;   // 0/1, or UNKNOWN
+    GLuint cullFace;
+    GLuint blend;
+    GLenum blendSrc, blendDst;
+    GLenum cullMode;
+    GLenum frontFace;
+    GLint viewport[4];
+    bool viewportKnown;
+};
+
+// One shadow per render thread, like the context it mirrors
+static thread_local ShadowState state;
+static thread_local bool stateInitialized = false;
+
+/**
+ * Counts a request and tells the caller whether to make the GL call
+ */
+static bool issue(bool differs) {
+    profilerCount(differs ? COUNTER_STATE_ISSUED : COUNTER_STATE_FILTERED);
+    return differs;
+}
+
+static ShadowState& shadow() {
+    if (!stateInitialized) glStateInvalidate();
+    return state;
+}
+
+void glStateInvalidate() {
+    state.program = UNKNOWN;
+    state.vao = UNKNOWN;
+    state.fbo = UNKNOWN;
+    for (GLuint& texture : state.textures) texture = UNKNOWN;
+    for (GLuint& texture : state.textureArrays) texture = UNKNOWN;
+    for (GLuint& texture : state.textureBuffers) texture = UNKNOWN;
+    state.activeUnit = UNKNOWN;
+    state.depthTest = UNKNOWN;
+    state.cullFace = UNKNOWN;
+    state.blend = UNKNOWN;
+    state.blendSrc = state.blendDst = UNKNOWN;
+    state.cullMode = UNKNOWN;
+    state.frontFace = UNKNOWN;
+    state.viewportKnown = false;
+    stateInitialized = true;
+}
+
+// ==================== BINDS ====================
+
+void glStateUseProgram(GLuint program) {
+    ShadowState& s = shadow();
+    if (!issue(s.program != program)) return;
+    glUseProgram(program);
+    s.program = program;
+}
+
+void glStateBindVertexArray(GLuint vao) {
+    ShadowState& s = shadow();
+    if (!issue(s.vao != vao)) return;
+    glBindVertexArray(vao);
+    s.vao = vao;
+}
+
+void glStateBindFramebuffer(GLuint fbo) {
+    ShadowState& s = shadow();
+    if (!issue(s.fbo != fbo)) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    s.fbo = fbo;
+}
+
+// Each target has its own binding per unit, so each has its own shadow array
+static void bindTextureTarget(GLuint* bound, GLenum target, int unit, GLuint texture) {
+    ShadowState& s = shadow();
+    bool shadowed = unit >= 0 && unit < GL_STATE_TEXTURE_UNITS;
+
+    // Already bound there: not even the active unit has to change
+    if (!issue(!shadowed || bound[unit] != texture)) return;
+
+    if (s.activeUnit != (GLuint)unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        s.activeUnit = (GLuint)unit;
+        profilerCount(COUNTER_STATE_ISSUED);
+    }
+    glBindTexture(target, texture);
+    if (shadowed) bound[unit] = texture;
+}
+
+void glStateBindTexture(int unit, GLuint texture) {
+    bindTextureTarget(shadow().textures, GL_TEXTURE_2D, unit, texture);
+}
+
+void glStateBindTextureArray(int unit, GLuint texture) {
+    bindTextureTarget(shadow().textureArrays, GL_TEXTURE_2D_ARRAY, unit, texture);
+}
+
+void glStateBindTextureBuffer(int unit, GLuint texture) {
+    bindTextureTarget(shadow().textureBuffers, GL_TEXTURE_BUFFER, unit, texture);
+}
+
+// ==================== FIXED-FUNCTION STATE ====================
+
+void glStateSetEnabled(GLenum cap, bool enabled) {
+    ShadowState& s = shadow();
+    GLuint* flag = NULL;
+    switch (cap) {
+    case GL_DEPTH_TEST: flag = &s.depthTest; break;
+    case GL_CULL_FACE:  flag = &s.cullFace; break;
+    case GL_BLEND:      flag = &s.blend; break;
+    default: break;
+    }
+
+    GLuint value = enabled ? 1 : 0;
+    if (!issue(flag == NULL || *flag != value)) return;
+    if (enabled) glEnable(cap);
+    else glDisable(cap);
+    if (flag != NULL) *flag = value;
+}
+
+void glStateBlendFunc(GLenum sfactor, GLenum dfactor) {
+    ShadowState& s = shadow();
+    if (!issue(s.blendSrc != sfactor || s.blendDst != dfactor)) return;
+    glBlendFunc(sfactor, dfactor);
+    s.blendSrc = sfactor;
+    s.blendDst = dfactor;
+}
+
+void glStateCullFace(GLenum mode) {
+    ShadowState& s = shadow();
+    if (!issue(s.cullMode != mode)) return;
+    glCullFace(mode);
+    s.cullMode = mode;
+}
+
+void glStateFrontFace(GLenum mode) {
+    ShadowState& s = shadow();
+    if (!issue(s.frontFace != mode)) return;
+    glFrontFace(mode);
+    s.frontFace = mode;
+}
+
+void glStateViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    ShadowState& s = shadow();
+    bool same = s.viewportKnown && s.viewport[0] == x && s.viewport[1] == y &&
+        s.viewport[2] == width && s.viewport[3] == height;
+    if (!issue(!same)) return;
+    glViewport(x, y, width, height);
+    s.viewport[0] = x;
+    s.viewport[1] = y;
+    s.viewport[2] = width;
+    s.viewport[3] = height;
+    s.viewportKnown = true;
+}
+
+// ==================== OBJECT DELETION ====================
+
+void glStateObjectDeleted(GpuResourceType type, GLuint id) {
+    ShadowState& s = shadow();
+    switch (type) {
+    case GPU_RES_TEXTURE:
+        for (GLuint& texture : s.textures) {
+            if (texture == id) texture = 0;
+        }
+        for (GLuint& texture : s.textureArrays) {
+            if (texture == id) texture = 0;
+        }
+        for (GLuint& texture : s.textureBuffers) {
+            if (texture == id) texture = 0;
+        }
+        break;
+    case GPU_RES_VERTEX_ARRAY:
+        if (s.vao == id) s.vao = 0;
+        break;
+    case GPU_RES_FRAMEBUFFER:
+        if (s.fbo == id) s.fbo = 0;
+        break;
+    case GPU_RES_PROGRAM:
+        // A deleted program stays in use until another one is; its name may be reused meanwhile
+        if (s.program == id) s.program = UNKNOWN;
+        break;
+    default:
+        break;
+    }
+}
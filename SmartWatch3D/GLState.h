@@ -0,0 +1,46 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "GpuResources.h"
+
+/*
+ * GL state cache
+ * --------------
+ * Shadows the context state the renderer changes every frame: program,
+ * vertex array, framebuffer, 2D, 2D array and buffer texture per unit (and
+ * the active unit), depth test / face culling / blending, blend function, cull
+ * mode, front face and viewport. A request only reaches GL when it differs from the
+ * shadowed value; each GL call made is counted as state_issued and each
+ * request dropped as state_filtered (profiler counters).
+ *
+ * Passes set the state they need instead of restoring what they changed;
+ * the cache turns the repeats into no-ops. The cache only sees changes made
+ * through it, so everything in the renderer binds through these functions.
+ * Deleting an object through its GL handle (GLHandles.h) tells the cache,
+ * because GL silently unbinds deleted objects. glStateInvalidate() forgets
+ * everything, for code that changed state behind the cache's back.
+ *
+ * Shadows are per thread, like the context they mirror.
+ */
+
+const int GL_STATE_TEXTURE_UNITS = 8;  // Units shadowed (units 0 .. 7)
+
+// Forgets all shadowed state: the next request of each kind is issued
+void glStateInvalidate();
+
+void glStateUseProgram(GLuint program);
+void glStateBindVertexArray(GLuint vao);
+void glStateBindFramebuffer(GLuint fbo);             // GL_FRAMEBUFFER (draw and read)
+void glStateBindTexture(int unit, GLuint texture);   // GL_TEXTURE_2D on GL_TEXTURE0 + unit
+void glStateBindTextureArray(int unit, GLuint texture);  // GL_TEXTURE_2D_ARRAY on GL_TEXTURE0 + unit
+void glStateBindTextureBuffer(int unit, GLuint texture); // GL_TEXTURE_BUFFER on GL_TEXTURE0 + unit
+
+// GL_DEPTH_TEST, GL_CULL_FACE or GL_BLEND (other capabilities go straight to GL)
+void glStateSetEnabled(GLenum cap, bool enabled);
+void glStateBlendFunc(GLenum sfactor, GLenum dfactor);
+void glStateCullFace(GLenum mode);
+void glStateFrontFace(GLenum mode);
+void glStateViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+// Called when an object is deleted: GL unbinds it everywhere in this context
+void glStateObjectDeleted(GpuResourceType type, GLuint id);
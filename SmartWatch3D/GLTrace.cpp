@@ -0,0 +1,315 @@
+// Wrappers call the real entry points, so the redirect macros must stay off here
+#define GL_TRACE_IMPLEMENTATION
+#include "GLTrace.h"
+#include "Profiler.h"
+#include "GpuResources.h"
+
+#include <climits>
+
+static bool traceEnabled = true;
+
+// Bind state mirrored for the resource registry, so storage calls know which object they size
+// (per thread, like the context it mirrors)
+const int MAX_TEXTURE_UNITS = 32;
+static thread_local GLuint boundTextures[MAX_TEXTURE_UNITS];
+static thread_local int activeTextureUnit = 0;
+static thread_local GLuint boundArrayBuffer = 0;
+static thread_local GLuint boundElementBuffer = 0;
+static thread_local GLuint boundTextureBuffer = 0;
+static thread_local GLuint boundRenderbuffer = 0;
+
+void glTraceSetEnabled(bool enabled) {
+    traceEnabled = enabled;
+}
+
+bool glTraceIsEnabled() {
+    return traceEnabled;
+}
+
+/**
+ * Estimated bytes per texel of an internal format (unsized formats use the
+ * usual 8 bits per channel; drivers commonly pad RGB to 4 bytes)
+ */
+static size_t texelBytes(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_RED: case GL_R8: return 1;
+    case GL_RG: case GL_RG8: case GL_RGB565: case GL_RGB5: case GL_RGBA4: case GL_DEPTH_COMPONENT16: return 2;
+    case GL_RGBA16F: return 8;
+    case GL_RGBA32F: return 16;
+    default: return 4;  // RGB(A)8, depth 24, depth 24 + stencil 8
+    }
+}
+
+static void addCount(ProfilerCounter counter, unsigned int amount = 1) {
+    if (traceEnabled) profilerCount(counter, amount);
+}
+
+// Byte counts are GLsizeiptr; the counters are 32-bit and saturate instead of wrapping
+static unsigned int countBytes(GLsizeiptr size) {
+    return size > (GLsizeiptr)UINT_MAX ? UINT_MAX : (unsigned int)size;
+}
+
+// ==================== DRAWS ====================
+
+void glTraceDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArrays(mode, first, count);
+    addCount(COUNTER_DRAW_CALLS);
+    addCount(COUNTER_VERTICES, (unsigned int)count);
+}
+
+void glTraceDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    glDrawElements(mode, count, type, indices);
+    addCount(COUNTER_DRAW_CALLS);
+    addCount(COUNTER_VERTICES, (unsigned int)count);
+}
+
+void glTraceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    glDrawArraysInstanced(mode, first, count, instances);
+    addCount(COUNTER_DRAW_CALLS);
+    addCount(COUNTER_VERTICES, (unsigned int)(count * instances));
+}
+
+void glTraceDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances) {
+    glDrawElementsInstanced(mode, count, type, indices, instances);
+    addCount(COUNTER_DRAW_CALLS);
+    addCount(COUNTER_VERTICES, (unsigned int)(count * instances));
+}
+
+// ==================== BINDS ====================
+
+void glTraceUseProgram(GLuint program) {
+    glUseProgram(program);
+    addCount(COUNTER_PROGRAM_BINDS);
+}
+
+void glTraceBindTexture(GLenum target, GLuint texture) {
+    glBindTexture(target, texture);
+    boundTextures[activeTextureUnit] = texture;
+    addCount(COUNTER_TEXTURE_BINDS);
+}
+
+void glTraceActiveTexture(GLenum unit) {
+    glActiveTexture(unit);
+    activeTextureUnit = (int)(unit - GL_TEXTURE0) % MAX_TEXTURE_UNITS;
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceBindVertexArray(GLuint vao) {
+    glBindVertexArray(vao);
+    boundElementBuffer = 0;  // The element buffer binding belongs to the VAO
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceBindFramebuffer(GLenum target, GLuint fbo) {
+    glBindFramebuffer(target, fbo);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceBindBuffer(GLenum target, GLuint buffer) {
+    glBindBuffer(target, buffer);
+    if (target == GL_ARRAY_BUFFER) boundArrayBuffer = buffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER) boundElementBuffer = buffer;
+    else if (target == GL_TEXTURE_BUFFER) boundTextureBuffer = buffer;
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceBindRenderbuffer(GLenum target, GLuint renderbuffer) {
+    glBindRenderbuffer(target, renderbuffer);
+    boundRenderbuffer = renderbuffer;
+}
+
+// ==================== UNIFORMS ====================
+
+void glTraceUniform1i(GLint location, GLint v0) {
+    glUniform1i(location, v0);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniform1f(GLint location, GLfloat v0) {
+    glUniform1f(location, v0);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+    glUniform2f(location, v0, v1);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+    glUniform4f(location, v0, v1, v2, v3);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+    glUniform3fv(location, count, value);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+    glUniform4fv(location, count, value);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+void glTraceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    glUniformMatrix4fv(location, count, transpose, value);
+    addCount(COUNTER_UNIFORM_UPLOADS);
+}
+
+// ==================== UPLOADS ====================
+
+void glTraceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    glBufferData(target, size, data, usage);
+    if (target == GL_ARRAY_BUFFER) gpuResourceSetSize(GPU_RES_BUFFER, boundArrayBuffer, (size_t)size);
+    else if (target == GL_ELEMENT_ARRAY_BUFFER) gpuResourceSetSize(GPU_RES_BUFFER, boundElementBuffer, (size_t)size);
+    else if (target == GL_TEXTURE_BUFFER) gpuResourceSetSize(GPU_RES_BUFFER, boundTextureBuffer, (size_t)size);
+    addCount(COUNTER_BUFFER_UPLOADS);
+    addCount(COUNTER_BUFFER_BYTES, countBytes(size));
+}
+
+void glTraceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    glBufferSubData(target, offset, size, data);
+    addCount(COUNTER_BUFFER_UPLOADS);
+    addCount(COUNTER_BUFFER_BYTES, countBytes(size));
+}
+
+void glTraceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+    GLint border, GLenum format, GLenum type, const void* pixels) {
+    glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+    if (level == 0) {
+        gpuResourceSetSize(GPU_RES_TEXTURE, boundTextures[activeTextureUnit],
+            (size_t)width * height * texelBytes((GLenum)internalFormat));
+    }
+    if (pixels != NULL) addCount(COUNTER_TEXTURE_UPLOADS);
+}
+
+void glTraceTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+    GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels) {
+    glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, pixels);
+    if (level == 0) {
+        gpuResourceSetSize(GPU_RES_TEXTURE, boundTextures[activeTextureUnit],
+            (size_t)width * height * depth * texelBytes((GLenum)internalFormat));
+    }
+    if (pixels != NULL) addCount(COUNTER_TEXTURE_UPLOADS);
+}
+
+void glTraceTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+    GLenum format, GLenum type, const void* pixels) {
+    glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    addCount(COUNTER_TEXTURE_UPLOADS);
+}
+
+void glTraceGenerateMipmap(GLenum target) {
+    glGenerateMipmap(target);
+    // A full mip chain adds one third to the base level
+    GLuint texture = boundTextures[activeTextureUnit];
+    size_t base = gpuResourceSize(GPU_RES_TEXTURE, texture);
+    gpuResourceSetSize(GPU_RES_TEXTURE, texture, base + base / 3);
+}
+
+void glTraceRenderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) {
+    glRenderbufferStorage(target, internalFormat, width, height);
+    gpuResourceSetSize(GPU_RES_RENDERBUFFER, boundRenderbuffer, (size_t)width * height * texelBytes(internalFormat));
+}
+
+// ==================== OBJECT LIFETIME ====================
+
+static void registerObjects(GpuResourceType type, GLsizei n, const GLuint* ids, const char* file, int line) {
+    for (GLsizei i = 0; i < n; i++) gpuResourceCreated(type, ids[i], file, line);
+}
+
+static void unregisterObjects(GpuResourceType type, GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) gpuResourceDeleted(type, ids[i]);
+}
+
+void glTraceGenTextures(GLsizei n, GLuint* textures, const char* file, int line) {
+    glGenTextures(n, textures);
+    registerObjects(GPU_RES_TEXTURE, n, textures, file, line);
+}
+
+void glTraceDeleteTextures(GLsizei n, const GLuint* textures) {
+    unregisterObjects(GPU_RES_TEXTURE, n, textures);
+    glDeleteTextures(n, textures);
+}
+
+void glTraceGenBuffers(GLsizei n, GLuint* buffers, const char* file, int line) {
+    glGenBuffers(n, buffers);
+    registerObjects(GPU_RES_BUFFER, n, buffers, file, line);
+}
+
+void glTraceDeleteBuffers(GLsizei n, const GLuint* buffers) {
+    unregisterObjects(GPU_RES_BUFFER, n, buffers);
+    glDeleteBuffers(n, buffers);
+}
+
+void glTraceGenVertexArrays(GLsizei n, GLuint* arrays, const char* file, int line) {
+    glGenVertexArrays(n, arrays);
+    registerObjects(GPU_RES_VERTEX_ARRAY, n, arrays, file, line);
+}
+
+void glTraceDeleteVertexArrays(GLsizei n, const GLuint* arrays) {
+    unregisterObjects(GPU_RES_VERTEX_ARRAY, n, arrays);
+    glDeleteVertexArrays(n, arrays);
+}
+
+void glTraceGenFramebuffers(GLsizei n, GLuint* framebuffers, const char* file, int line) {
+    glGenFramebuffers(n, framebuffers);
+    registerObjects(GPU_RES_FRAMEBUFFER, n, framebuffers, file, line);
+}
+
+void glTraceDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+    unregisterObjects(GPU_RES_FRAMEBUFFER, n, framebuffers);
+    glDeleteFramebuffers(n, framebuffers);
+}
+
+void glTraceGenRenderbuffers(GLsizei n, GLuint* renderbuffers, const char* file, int line) {
+    glGenRenderbuffers(n, renderbuffers);
+    registerObjects(GPU_RES_RENDERBUFFER, n, renderbuffers, file, line);
+}
+
+void glTraceDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+    unregisterObjects(GPU_RES_RENDERBUFFER, n, renderbuffers);
+    glDeleteRenderbuffers(n, renderbuffers);
+}
+
+GLuint glTraceCreateProgram(const char* file, int line) {
+    GLuint program = glCreateProgram();
+    gpuResourceCreated(GPU_RES_PROGRAM, program, file, line);
+    return program;
+}
+
+void glTraceDeleteProgram(GLuint program) {
+    gpuResourceDeleted(GPU_RES_PROGRAM, program);
+    glDeleteProgram(program);
+}
+
+// ==================== FIXED-FUNCTION STATE ====================
+
+void glTraceEnable(GLenum cap) {
+    glEnable(cap);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceDisable(GLenum cap) {
+    glDisable(cap);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceBlendFunc(GLenum sfactor, GLenum dfactor) {
+    glBlendFunc(sfactor, dfactor);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceCullFace(GLenum mode) {
+    glCullFace(mode);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceFrontFace(GLenum mode) {
+    glFrontFace(mode);
+    addCount(COUNTER_STATE_CHANGES);
+}
+
+void glTraceViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    glViewport(x, y, width, height);
+    addCount(COUNTER_STATE_CHANGES);
+}
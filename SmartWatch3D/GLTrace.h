@@ -0,0 +1,171 @@
+#pragma once
+#include <GL/glew.h>
+
+/*
+ * GL call interception
+ * --------------------
+ * Thin wrappers around the GL entry points the renderer uses. Each wrapper
+ * forwards to the real function and bumps the matching profiler counter
+ * (draw calls, vertices, program/texture binds, uniform updates, buffer
+ * uploads and bytes, state toggles).
+ *
+ * Compile time: define SW_GL_TRACE and include this header after glew.h;
+ *               the gl* names below are then redirected to the wrappers.
+ *               Without SW_GL_TRACE the header adds nothing to the calls.
+ * Runtime:      glTraceSetEnabled(false) keeps forwarding but stops counting.
+ *
+ * Object creation, deletion and storage calls are also forwarded to the GPU
+ * resource registry (GpuResources.h); glGen* and glCreateProgram pass the
+ * caller's file and line so leaks can be traced back to their creator.
+ */
+
+void glTraceSetEnabled(bool enabled);
+bool glTraceIsEnabled();
+
+// Draws
+void glTraceDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glTraceDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void glTraceDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+void glTraceDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances);
+
+// Binds
+void glTraceUseProgram(GLuint program);
+void glTraceBindTexture(GLenum target, GLuint texture);
+void glTraceActiveTexture(GLenum unit);
+void glTraceBindVertexArray(GLuint vao);
+void glTraceBindFramebuffer(GLenum target, GLuint fbo);
+void glTraceBindBuffer(GLenum target, GLuint buffer);
+void glTraceBindRenderbuffer(GLenum target, GLuint renderbuffer);
+
+// Uniforms
+void glTraceUniform1i(GLint location, GLint v0);
+void glTraceUniform1f(GLint location, GLfloat v0);
+void glTraceUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void glTraceUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void glTraceUniform3fv(GLint location, GLsizei count, const GLfloat* value);
+void glTraceUniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void glTraceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+// Uploads
+void glTraceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glTraceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void glTraceTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+    GLint border, GLenum format, GLenum type, const void* pixels);
+void glTraceTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+    GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels);
+void glTraceTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+    GLenum format, GLenum type, const void* pixels);
+void glTraceGenerateMipmap(GLenum target);
+void glTraceRenderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height);
+
+// Object lifetime (registered with the resource registry)
+void glTraceGenTextures(GLsizei n, GLuint* textures, const char* file, int line);
+void glTraceDeleteTextures(GLsizei n, const GLuint* textures);
+void glTraceGenBuffers(GLsizei n, GLuint* buffers, const char* file, int line);
+void glTraceDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glTraceGenVertexArrays(GLsizei n, GLuint* arrays, const char* file, int line);
+void glTraceDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glTraceGenFramebuffers(GLsizei n, GLuint* framebuffers, const char* file, int line);
+void glTraceDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void glTraceGenRenderbuffers(GLsizei n, GLuint* renderbuffers, const char* file, int line);
+void glTraceDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+GLuint glTraceCreateProgram(const char* file, int line);
+void glTraceDeleteProgram(GLuint program);
+
+// Fixed-function state
+void glTraceEnable(GLenum cap);
+void glTraceDisable(GLenum cap);
+void glTraceBlendFunc(GLenum sfactor, GLenum dfactor);
+void glTraceCullFace(GLenum mode);
+void glTraceFrontFace(GLenum mode);
+void glTraceViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+#if defined(SW_GL_TRACE) && !defined(GL_TRACE_IMPLEMENTATION)
+#undef glDrawArrays
+#undef glDrawElements
+#undef glDrawArraysInstanced
+#undef glDrawElementsInstanced
+#undef glUseProgram
+#undef glBindTexture
+#undef glActiveTexture
+#undef glBindVertexArray
+#undef glBindFramebuffer
+#undef glBindBuffer
+#undef glBindRenderbuffer
+#undef glUniform1i
+#undef glUniform1f
+#undef glUniform2f
+#undef glUniform4f
+#undef glUniform3fv
+#undef glUniform4fv
+#undef glUniformMatrix4fv
+#undef glBufferData
+#undef glBufferSubData
+#undef glTexImage2D
+#undef glTexImage3D
+#undef glTexSubImage2D
+#undef glGenerateMipmap
+#undef glRenderbufferStorage
+#undef glGenTextures
+#undef glDeleteTextures
+#undef glGenBuffers
+#undef glDeleteBuffers
+#undef glGenVertexArrays
+#undef glDeleteVertexArrays
+#undef glGenFramebuffers
+#undef glDeleteFramebuffers
+#undef glGenRenderbuffers
+#undef glDeleteRenderbuffers
+#undef glCreateProgram
+#undef glDeleteProgram
+#undef glEnable
+#undef glDisable
+#undef glBlendFunc
+#undef glCullFace
+#undef glFrontFace
+#undef glViewport
+
+#define glDrawArrays glTraceDrawArrays
+#define glDrawElements glTraceDrawElements
+#define glDrawArraysInstanced glTraceDrawArraysInstanced
+#define glDrawElementsInstanced glTraceDrawElementsInstanced
+#define glUseProgram glTraceUseProgram
+#define glBindTexture glTraceBindTexture
+#define glActiveTexture glTraceActiveTexture
+#define glBindVertexArray glTraceBindVertexArray
+#define glBindFramebuffer glTraceBindFramebuffer
+#define glBindBuffer glTraceBindBuffer
+#define glBindRenderbuffer glTraceBindRenderbuffer
+#define glUniform1i glTraceUniform1i
+#define glUniform1f glTraceUniform1f
+#define glUniform2f glTraceUniform2f
+#define glUniform4f glTraceUniform4f
+#define glUniform3fv glTraceUniform3fv
+#define glUniform4fv glTraceUniform4fv
+#define glUniformMatrix4fv glTraceUniformMatrix4fv
+#define glBufferData glTraceBufferData
+#define glBufferSubData glTraceBufferSubData
+#define glTexImage2D glTraceTexImage2D
+#define glTexImage3D glTraceTexImage3D
+#define glTexSubImage2D glTraceTexSubImage2D
+#define glGenerateMipmap glTraceGenerateMipmap
+#define glRenderbufferStorage glTraceRenderbufferStorage
+#define glGenTextures(n, ids) glTraceGenTextures(n, ids, __FILE__, __LINE__)
+#define glDeleteTextures glTraceDeleteTextures
+#define glGenBuffers(n, ids) glTraceGenBuffers(n, ids, __FILE__, __LINE__)
+#define glDeleteBuffers glTraceDeleteBuffers
+#define glGenVertexArrays(n, ids) glTraceGenVertexArrays(n, ids, __FILE__, __LINE__)
+#define glDeleteVertexArrays glTraceDeleteVertexArrays
+#define glGenFramebuffers(n, ids) glTraceGenFramebuffers(n, ids, __FILE__, __LINE__)
+#define glDeleteFramebuffers glTraceDeleteFramebuffers
+#define glGenRenderbuffers(n, ids) glTraceGenRenderbuffers(n, ids, __FILE__, __LINE__)
+#define glDeleteRenderbuffers glTraceDeleteRenderbuffers
+#define glCreateProgram() glTraceCreateProgram(__FILE__, __LINE__)
+#define glDeleteProgram glTraceDeleteProgram
+#define glEnable glTraceEnable
+#define glDisable glTraceDisable
+#define glBlendFunc glTraceBlendFunc
+#define glCullFace glTraceCullFace
+#define glFrontFace glTraceFrontFace
+#define glViewport glTraceViewport
+#endif
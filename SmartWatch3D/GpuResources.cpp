@@ -0,0 +1,108 @@
+#include "GpuResources.h"
+#include "GLDebug.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+struct GpuResourceRecord {
+    size_t bytes;
+    const char* file;
+    int line;
+    std::string label;
+};
+
+// Object names are per GL context, and each context is used by one thread
+static thread_local std::unordered_map<unsigned int, GpuResourceRecord> resources[GPU_RES_TYPE_COUNT];
+static thread_local GpuResourceStats stats[GPU_RES_TYPE_COUNT];
+
+// KHR_debug identifier for each type (glObjectLabel)
+static const GLenum RESOURCE_GL_IDENTIFIERS[GPU_RES_TYPE_COUNT] = {
+    GL_TEXTURE, GL_BUFFER, GL_VERTEX_ARRAY, GL_FRAMEBUFFER, GL_RENDERBUFFER, GL_PROGRAM
+};
+
+static const char* RESOURCE_TYPE_NAMES[GPU_RES_TYPE_COUNT] = {
+    "textures", "buffers", "vertex_arrays", "framebuffers", "renderbuffers", "programs"
+};
+
+// ==================== REGISTRATION ====================
+
+void gpuResourceCreated(GpuResourceType type, unsigned int id, const char* file, int line) {
+    if (id == 0) return;
+    GpuResourceRecord record = { 0, file, line, std::string() };
+    resources[type][id] = record;
+
+    GpuResourceStats& s = stats[type];
+    s.created++;
+    s.liveCount++;
+    if (s.liveCount > s.peakCount) s.peakCount = s.liveCount;
+}
+
+void gpuResourceDeleted(GpuResourceType type, unsigned int id) {
+    auto it = resources[type].find(id);
+    if (it == resources[type].end()) return;  // 0 or never registered
+
+    GpuResourceStats& s = stats[type];
+    s.liveBytes -= it->second.bytes;
+    s.liveCount--;
+    s.deleted++;
+    resources[type].erase(it);
+}
+
+void gpuResourceSetSize(GpuResourceType type, unsigned int id, size_t bytes) {
+    auto it = resources[type].find(id);
+    if (it == resources[type].end()) return;
+
+    // Storage is replaced, not added (glTexImage2D/glBufferData respecify the object)
+    GpuResourceStats& s = stats[type];
+    s.liveBytes = s.liveBytes - it->second.bytes + bytes;
+    it->second.bytes = bytes;
+    if (s.liveBytes > s.peakBytes) s.peakBytes = s.liveBytes;
+}
+
+size_t gpuResourceSize(GpuResourceType type, unsigned int id) {
+    auto it = resources[type].find(id);
+    return it == resources[type].end() ? 0 : it->second.bytes;
+}
+
+void gpuResourceSetLabel(GpuResourceType type, unsigned int id, const char* label) {
+    glDebugLabel(RESOURCE_GL_IDENTIFIERS[type], id, label);
+
+    auto it = resources[type].find(id);
+    if (it != resources[type].end()) it->second.label = label;
+}
+
+GpuResourceStats gpuResourceStats(GpuResourceType type) {
+    return stats[type];
+}
+
+const char* gpuResourceTypeName(GpuResourceType type) {
+    return RESOURCE_TYPE_NAMES[type];
+}
+
+// ==================== REPORTS ====================
+
+void gpuResourceReport() {
+    printf("GPU resources      live   peak   created   live KB   peak KB\n");
+    for (int t = 0; t < GPU_RES_TYPE_COUNT; t++) {
+        const GpuResourceStats& s = stats[t];
+        printf("  %-14s %6d %6d %9d %9.1f %9.1f\n", RESOURCE_TYPE_NAMES[t],
+            s.liveCount, s.peakCount, s.created, s.liveBytes / 1024.0, s.peakBytes / 1024.0);
+    }
+}
+
+int gpuResourceReportLeaks() {
+    int leaks = 0;
+    for (int t = 0; t < GPU_RES_TYPE_COUNT; t++) {
+        for (const auto& entry : resources[t]) {
+            const GpuResourceRecord& r = entry.second;
+            if (leaks == 0) std::cout << "Leaked GPU resources:" << std::endl;
+            printf("  %s #%u \"%s\" %zu bytes, created at %s:%d\n", RESOURCE_TYPE_NAMES[t], entry.first,
+                r.label.empty() ? "unlabeled" : r.label.c_str(), r.bytes, r.file, r.line);
+            leaks++;
+        }
+    }
+    if (leaks == 0) std::cout << "No leaked GPU resources." << std::endl;
+    return leaks;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+
+/*
+ * GPU resource registry
+ * ---------------------
+ * Book-keeping for every GL object the application creates: textures,
+ * buffers, vertex arrays, framebuffers, renderbuffers and programs. Each
+ * live object is stored with its estimated size in bytes, the file/line
+ * that created it and an optional debug label.
+ *
+ * The GL interception layer (GLTrace.h) feeds the registry from the
+ * glGen*, glDelete*, glCreateProgram and storage calls, so code only has
+ * to add labels. At shutdown gpuResourceReport prints live/peak usage per
+ * category and gpuResourceReportLeaks lists everything still alive.
+ */
+
+enum GpuResourceType {
+    GPU_RES_TEXTURE,
+    GPU_RES_BUFFER,
+    GPU_RES_VERTEX_ARRAY,
+    GPU_RES_FRAMEBUFFER,
+    GPU_RES_RENDERBUFFER,
+    GPU_RES_PROGRAM,
+    GPU_RES_TYPE_COUNT
+};
+
+struct GpuResourceStats {
+    int liveCount;
+    int peakCount;
+    size_t liveBytes;
+    size_t peakBytes;
+    int created;   // Total over the run, shows churn
+    int deleted;
+};
+
+// Called by the interception layer
+void gpuResourceCreated(GpuResourceType type, unsigned int id, const char* file, int line);
+void gpuResourceDeleted(GpuResourceType type, unsigned int id);
+void gpuResourceSetSize(GpuResourceType type, unsigned int id, size_t bytes);
+size_t gpuResourceSize(GpuResourceType type, unsigned int id);
+
+// Debug label shown in the leak report (ignored for unknown objects);
+// also passed to glObjectLabel in builds with SW_GL_DEBUG
+void gpuResourceSetLabel(GpuResourceType type, unsigned int id, const char* label);
+
+GpuResourceStats gpuResourceStats(GpuResourceType type);
+const char* gpuResourceTypeName(GpuResourceType type);
+
+// Prints live/peak counts and bytes per category
+void gpuResourceReport();
+// Prints every object that is still alive; returns how many there are
+int gpuResourceReportLeaks();
@@ -0,0 +1,70 @@
+#include "Hierarchy.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+void transformClear(TransformHierarchy& hierarchy) {
+    hierarchy.parent.clear();
+    hierarchy.position.clear();
+    hierarchy.rotX.clear();
+    hierarchy.rotY.clear();
+    hierarchy.entity.clear();
+    hierarchy.dirty.clear();
+    hierarchy.world.clear();
+}
+
+TransformNode transformCreate(TransformHierarchy& hierarchy, TransformNode parent, EntityId entity) {
+    TransformNode node = (TransformNode)hierarchy.parent.size();
+    hierarchy.parent.push_back(parent < node ? parent : -1);
+    hierarchy.position.push_back(glm::vec3(0.0f));
+    hierarchy.rotX.push_back(0.0f);
+    hierarchy.rotY.push_back(0.0f);
+    hierarchy.entity.push_back(entity);
+    hierarchy.dirty.push_back(1);  // Computed by the first update
+    hierarchy.world.push_back(glm::mat4(1.0f));
+    return node;
+}
+
+void transformSetLocal(TransformHierarchy& hierarchy, TransformNode node, const glm::vec3& position, float rotX, float rotY) {
+    if (hierarchy.position[node] == position && hierarchy.rotX[node] == rotX && hierarchy.rotY[node] == rotY) return;
+    hierarchy.position[node] = position;
+    hierarchy.rotX[node] = rotX;
+    hierarchy.rotY[node] = rotY;
+    hierarchy.dirty[node] = 1;
+}
+
+// ==================== UPDATE PASS ====================
+
+int transformUpdate(TransformHierarchy& hierarchy, EntityStore& store) {
+    int count = (int)hierarchy.parent.size();
+    int recomputed = 0;
+
+    // Parents come first, so a node's dirty flag is final when the pass reaches it
+    for (int i = 0; i < count; i++) {
+        int parent = hierarchy.parent[i];
+        if (parent >= 0 && hierarchy.dirty[parent]) hierarchy.dirty[i] = 1;
+        if (!hierarchy.dirty[i]) continue;
+
+        glm::mat4 m = parent >= 0 ? hierarchy.world[parent] : glm::mat4(1.0f);
+        m = glm::translate(m, hierarchy.position[i]);
+        if (hierarchy.rotX[i] != 0.0f) m = glm::rotate(m, glm::radians(hierarchy.rotX[i]), glm::vec3(1.0f, 0.0f, 0.0f));
+        if (hierarchy.rotY[i] != 0.0f) m = glm::rotate(m, glm::radians(hierarchy.rotY[i]), glm::vec3(0.0f, 1.0f, 0.0f));
+        hierarchy.world[i] = m;
+        recomputed++;
+
+        EntityId e = hierarchy.entity[i];
+        if (e >= 0) {
+            store.model[e] = glm::scale(m, glm::vec3(store.scaleX[e], store.scaleY[e], store.scaleZ[e]));
+            store.worldX[e] = m[3].x;
+            store.worldY[e] = m[3].y;
+            store.worldZ[e] = m[3].z;
+        }
+    }
+
+    // Flags stay set until the whole pass is done, so children see their parent's
+    for (int i = 0; i < count; i++) hierarchy.dirty[i] = 0;
+    return recomputed;
+}
+
+glm::vec3 transformWorldPosition(const TransformHierarchy& hierarchy, TransformNode node) {
+    return glm::vec3(hierarchy.world[node][3]);
+}
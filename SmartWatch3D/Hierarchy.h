@@ -0,0 +1,56 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Entities.h"
+
+/*
+ * Transform hierarchy
+ * -------------------
+ * Parent/child transforms with cached world matrices, used for the watch
+ * rig (camera -> wrist -> hand / watch -> screen / light). Each node has a
+ * local translation and rotation; its world matrix is
+ *
+ *     world = parent.world * translate(position) * rotateX * rotateY
+ *
+ * Setting a local transform to a new value marks the node dirty. Nodes are
+ * created after their parent, so the arrays are already in topological
+ * order and one linear pass recomputes every dirty node and everything
+ * below it, each after its parent; clean subtrees keep their cached matrix.
+ *
+ * A node can drive an entity: its world matrix times the entity's scale
+ * becomes the entity's model matrix and its translation the entity's world
+ * position. Scale is not inherited, so it stays a property of the entity.
+ */
+
+typedef int TransformNode;
+
+struct TransformHierarchy {
+    std::vector<TransformNode> parent;   // -1 = root; always lower than the node's own index
+    std::vector<glm::vec3> position;     // Local translation
+    std::vector<float> rotX, rotY;       // Local rotation in degrees, applied X then Y
+    std::vector<EntityId> entity;        // Entity driven by the node, -1 = none
+    std::vector<unsigned char> dirty;    // Local transform changed, or (during the pass) an ancestor did
+    std::vector<glm::mat4> world;        // Cached world matrices
+};
+
+void transformClear(TransformHierarchy& hierarchy);
+
+/**
+ * Appends a node with an identity local transform
+ * The parent must already exist (or be -1); entity may be -1
+ */
+TransformNode transformCreate(TransformHierarchy& hierarchy, TransformNode parent, EntityId entity);
+
+// Sets the local transform; the node only becomes dirty if a value changed
+void transformSetLocal(TransformHierarchy& hierarchy, TransformNode node, const glm::vec3& position, float rotX, float rotY);
+
+/**
+ * Recomputes the world matrices of dirty nodes and their descendants, and
+ * writes the model matrix and world position of the entities they drive
+ *
+ * @return Number of world matrices recomputed
+ */
+int transformUpdate(TransformHierarchy& hierarchy, EntityStore& store);
+
+glm::vec3 transformWorldPosition(const TransformHierarchy& hierarchy, TransformNode node);
@@ -0,0 +1,159 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "ImageIO.h"
+
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+// ==================== CHECKSUMS ====================
+
+struct CrcTable {
+    unsigned int entries[256];
+
+    CrcTable() {
+        for (unsigned int n = 0; n < 256; n++) {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+static unsigned int crc32(unsigned int crc, const unsigned char* data, size_t length) {
+    // Function-local static: built once even when several engine threads capture at the same time
+    static const CrcTable table;
+    const unsigned int* crcTable = table.entries;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void putBigEndian(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+// ==================== PNG WRITER ====================
+
+PngWriter::PngWriter()
+    : file(NULL), width(0), height(0), channels(0), rowsWritten(0), adlerA(1), adlerB(0) {
+}
+
+PngWriter::~PngWriter() {
+    if (file != NULL) close();
+}
+
+bool PngWriter::open(const char* path, int w, int h, int c) {
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        std::cout << "Error opening PNG for writing: " << path << std::endl;
+        return false;
+    }
+    width = w;
+    height = h;
+    channels = c;
+    rowsWritten = 0;
+    adlerA = 1;
+    adlerB = 0;
+
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    fwrite(signature, 1, 8, file);
+
+    unsigned char colorType = c == 1 ? 0 : (c == 3 ? 2 : 6);
+    unsigned char ihdr[13];
+    putBigEndian(ihdr, (unsigned int)w);
+    putBigEndian(ihdr + 4, (unsigned int)h);
+    ihdr[8] = 8;          // Bit depth
+    ihdr[9] = colorType;
+    ihdr[10] = 0;         // Deflate
+    ihdr[11] = 0;         // Adaptive filtering
+    ihdr[12] = 0;         // No interlace
+    writeChunk("IHDR", ihdr, sizeof(ihdr));
+
+    // zlib header: deflate, 32K window, no preset dictionary
+    static const unsigned char zlibHeader[2] = { 0x78, 0x01 };
+    writeChunk("IDAT", zlibHeader, 2);
+    return true;
+}
+
+void PngWriter::writeChunk(const char* type, const unsigned char* data, size_t length) {
+    unsigned char header[8];
+    putBigEndian(header, (unsigned int)length);
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, file);
+    if (length > 0) fwrite(data, 1, length, file);
+
+    unsigned int crc = crc32(0, header + 4, 4);
+    crc = crc32(crc, data, length);
+    unsigned char crcBytes[4];
+    putBigEndian(crcBytes, crc);
+    fwrite(crcBytes, 1, 4, file);
+}
+
+void PngWriter::writeStoredBlocks(const unsigned char* data, size_t length) {
+    // Every stored block holds at most 65535 bytes; all of them are non-final,
+    // close() appends the empty final block
+    std::vector<unsigned char> chunk;
+    size_t offset = 0;
+    while (offset < length) {
+        size_t blockLen = length - offset;
+        if (blockLen > 65535) blockLen = 65535;
+
+        chunk.push_back(0x00);
+        chunk.push_back((unsigned char)(blockLen & 0xFF));
+        chunk.push_back((unsigned char)(blockLen >> 8));
+        chunk.push_back((unsigned char)(~blockLen & 0xFF));
+        chunk.push_back((unsigned char)((~blockLen >> 8) & 0xFF));
+        chunk.insert(chunk.end(), data + offset, data + offset + blockLen);
+        offset += blockLen;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        adlerA = (adlerA + data[i]) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+    }
+    writeChunk("IDAT", chunk.data(), chunk.size());
+}
+
+void PngWriter::writeRow(const unsigned char* row) {
+    if (file == NULL || rowsWritten >= height) return;
+
+    std::vector<unsigned char> line((size_t)width * channels + 1);
+    line[0] = 0;  // Filter type: none
+    memcpy(&line[1], row, (size_t)width * channels);
+    writeStoredBlocks(line.data(), line.size());
+    rowsWritten++;
+}
+
+bool PngWriter::close() {
+    if (file == NULL) return false;
+
+    // Final empty stored block followed by the Adler-32 of the raw data
+    unsigned char tail[9] = { 0x01, 0x00, 0x00, 0xFF, 0xFF, 0, 0, 0, 0 };
+    putBigEndian(tail + 5, (adlerB << 16) | adlerA);
+    writeChunk("IDAT", tail, sizeof(tail));
+    writeChunk("IEND", NULL, 0);
+
+    bool complete = rowsWritten == height;
+    fclose(file);
+    file = NULL;
+    if (!complete) std::cout << "Warning: PNG closed after " << rowsWritten << " of " << height << " rows" << std::endl;
+    return complete;
+}
+
+bool writePng(const char* path, int width, int height, int channels, const unsigned char* pixels, bool flipY) {
+    PngWriter writer;
+    if (!writer.open(path, width, height, channels)) return false;
+    size_t stride = (size_t)width * channels;
+    for (int y = 0; y < height; y++) {
+        int srcY = flipY ? height - 1 - y : y;
+        writer.writeRow(pixels + srcY * stride);
+    }
+    return writer.close();
+}
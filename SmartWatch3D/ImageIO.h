@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdio>
+
+/*
+ * PNG output
+ * ----------
+ * Minimal PNG encoder (stored/uncompressed deflate blocks, no zlib needed).
+ * PngWriter streams the image row by row, so callers never have to hold the
+ * whole image in memory; writePng is the one-shot convenience wrapper.
+ * Reading PNGs is done with stb_image.
+ */
+
+class PngWriter {
+public:
+    PngWriter();
+    ~PngWriter();
+
+    // channels: 1 (gray), 3 (RGB) or 4 (RGBA), 8 bits each
+    bool open(const char* path, int width, int height, int channels);
+    // Rows are written top to bottom, width * channels bytes each
+    void writeRow(const unsigned char* row);
+    bool close();
+
+private:
+    void writeChunk(const char* type, const unsigned char* data, size_t length);
+    void writeStoredBlocks(const unsigned char* data, size_t length);
+
+    FILE* file;
+    int width;
+    int height;
+    int channels;
+    int rowsWritten;
+    unsigned int adlerA;
+    unsigned int adlerB;
+};
+
+// Writes a whole image; flipY for bottom-up data such as glReadPixels output
+bool writePng(const char* path, int width, int height, int channels, const unsigned char* pixels, bool flipY);
@@ -16,11 +16,18 @@
  * 1. First Pass (FBO): Render 2D watch UI elements to off-screen texture
  *    - Uses screenShader (simple 2D shader)
  *    - Renders clock digits, EKG graph, battery indicator, navigation arrows
+ *    - Performance screen shows live profiler data (FPS, frame graph, counters)
  *
  * 2. Second Pass (Screen): Render 3D scene with watch texture
  *    - Uses basicShader (Phong lighting shader)
  *    - Renders ground, road, buildings, hand, watch frame, watch screen
  *    - Watch screen uses FBO texture and is marked as emissive
+ *    - With vertex_pull, meshes are fetched from one vertex pool and each
+ *      batch of objects is one instanced draw (VertexPull.h)
+ *
+ * All state of a running simulator lives in an Engine (Engine.h) that is
+ * passed to every function. --instances N runs several headless engines side
+ * by side, each on its own thread with its own GL context.
  *
  * CONTROLS:
  * ---------
@@ -55,114 +62,51 @@
 #include <ctime>
 #include <cstdio>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <thread>
 #include <vector>
 #include <cstring>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include "Util.h"  // Shader compilation and texture loading utilities
+#include "Profiler.h"  // Frame timing, GPU pass timers and per-frame counters
+#include "GLTrace.h"   // Counts GL calls into the profiler when SW_GL_TRACE is defined
+#include "GLState.h"   // Shadowed GL state, filters redundant binds and toggles
+#include "Benchmark.h" // Benchmark result JSON
+#include "ImageIO.h"   // PNG output for scenario captures
+#include "TextureGen.h" // CPU side of the procedural textures
+#include "Scene.h"      // Scene entities (buildings, watch rig) and per-frame model matrices
+#include "GpuResources.h" // Live/peak GPU memory per object type, leak report
+#include "GLDebug.h"      // KHR_debug labels, debug groups and driver messages (debug builds)
+#include "Startup.h"      // Time-to-first-frame phases and the init dependency graph
+#include "FrameArena.h"   // Per-frame bump allocator and render-thread heap allocation counts
+#include "GLHandles.h"    // Move-only GL object handles and the texture pool
+#include "Config.h"       // Runtime settings: scene size, frame pacing, camera, quality tiers
+#include "Engine.h"       // Engine context: world state, render resources, input
+#include "WatchUi.h"      // Watch screen layout as a quad list, shared by the GL and CPU paths
+#include "SoftRaster.h"   // CPU watch UI rasterizer (watch_ui = cpu)
+#include "DisplayLink.h"  // Dirty-tile panel bus simulation (display_link)
 
 // ==================== CONSTANTS ====================
 
-// Frame rate limiter - limits to 75 FPS for smooth animation
-const double TARGET_FPS = 75.0;
-const double TARGET_FRAME_TIME = 1.0 / TARGET_FPS;  // ~13.3ms per frame
-
-// Ground/road configuration for infinite scrolling effect
-const float GROUND_SEGMENT_LENGTH = 20.0f;  // Length of one ground segment
-const int NUM_GROUND_SEGMENTS = 5;          // Number of segments to tile
-const float ROAD_WIDTH = 8.0f;              // Width of the road
-
-// Building configuration
-const int NUM_BUILDINGS_PER_SIDE = 6;       // Buildings on each side of road
-const float BUILDING_SPACING = 15.0f;       // Distance between buildings
-
-// ==================== GLOBAL VARIABLES ====================
-
-// Window dimensions (fullscreen)
-int screenWidth = 1920;
-int screenHeight = 1080;
-
-// ----- Watch Screen State (ported from 2D version) -----
-int currentScreen = 0;  // 0 = clock, 1 = heart rate, 2 = battery
-
-// Time tracking for clock display
-time_t currentTimeVal = time(NULL);
-struct tm* localTimeVal = localtime(&currentTimeVal);
-int hours = localTimeVal->tm_hour;
-int minutes = localTimeVal->tm_min;
-int seconds = localTimeVal->tm_sec;
-double lastSecondTime = 0;  // For updating clock every second
-
-// Heart rate simulation
-float bpm = 70.0f;           // Current displayed BPM
-float targetBpm = 70.0f;     // Target BPM (increases when running)
-float ekgOffset = 0.0f;      // Horizontal scroll of EKG graph
-float ekgScale = 1.0f;       // Scale factor for EKG animation speed
-bool isRunning = false;      // Whether D key is held
-
-// Battery simulation
-int batteryPercent = 100;    // Current battery level
-double lastBatteryDrain = 0; // Timer for battery drain
-
-// ----- Camera State -----
-glm::vec3 cameraPos = glm::vec3(0.0f, 1.6f, 0.0f);  // Eye level height (1.6m)
-float cameraYaw = -90.0f;      // Horizontal rotation (looking down -Z axis)
-float cameraPitch = 0.0f;      // Vertical rotation (combined base + bob)
-float cameraBasePitch = 0.0f;  // Base pitch from mouse input
-bool watchViewMode = false;    // When true, watch is in front of camera
-
-// ----- Mouse State -----
-double mouseX = 0, mouseY = 0;       // Current mouse position
-double lastMouseX = 0, lastMouseY = 0;
-bool firstMouse = true;              // For initializing mouse delta
-bool mouseClicked = false;           // Left click flag for UI interaction
-
-// ----- Running Animation -----
-float runTime = 0.0f;          // Accumulated time while running
-float groundOffset = 0.0f;     // How far ground has scrolled (for infinite effect)
-float cameraBobOffset = 0.0f;  // Vertical camera bob while running
-
-// ----- Render Settings (toggleable) -----
-bool depthTestEnabled = true;    // F1 toggles depth testing
-bool faceCullingEnabled = true;  // F2 toggles back-face culling
-
-// ----- OpenGL Textures -----
-unsigned int groundTexture;       // Grass texture for ground
-unsigned int roadTexture;         // Asphalt texture for road
-unsigned int ekgTexture;          // EKG waveform pattern
-unsigned int arrowRightTexture;   // Navigation arrow (right)
-unsigned int arrowLeftTexture;    // Navigation arrow (left)
-unsigned int heartCursorTexture;  // Heart icon for BPM display
-unsigned int studentInfoTexture;  // Student name overlay
-unsigned int buildingTexture;     // Generic building texture
-unsigned int watchFrameTexture;   // Watch bezel texture
-
-// ----- Shader Programs -----
-unsigned int basicShader;   // 3D Phong lighting shader
-unsigned int screenShader;  // 2D shader for watch UI rendering
-
-// ----- Vertex Array Objects -----
-unsigned int VAOground;      // Ground plane (large quad)
-unsigned int VAOcube;        // Unit cube (for buildings, hand, watch frame)
-unsigned int VAOwatchQuad;   // 3D quad for watch screen in world space
-unsigned int VAOscreenQuad;  // 2D quad for FBO rendering
-unsigned int VAOhand;        // Hand mesh (reuses cube VAO)
-
-// ----- Framebuffer Object for Watch Screen -----
-// The watch UI is first rendered to this FBO, then the resulting texture
-// is applied to the 3D watch quad in the scene
-unsigned int watchFBO;           // Framebuffer object handle
-unsigned int watchScreenTexture; // Color attachment (render target)
-const int WATCH_SCREEN_SIZE = 512;  // Resolution of watch screen texture
-
-// ----- Building Data -----
-// Stores procedurally generated building properties
-struct Building {
-    glm::vec3 position;  // World position
-    glm::vec3 scale;     // Size (width, height, depth)
-    glm::vec3 color;     // RGB color
+// Benchmark runs (--benchmark-frames N) skip the frame limiter and record N
+// frames after this many warmup frames
+const int BENCHMARK_WARMUP_FRAMES = 30;
+
+// Fixed starting states for --scenario, used by the golden-image regression harness
+const Scenario SCENARIOS[] = {
+    { "clock",             0, true,  false, 100 },
+    { "heartrate_running", 1, true,  true,  100 },
+    { "battery",           2, true,  false, 42 },
+    { "wrist_view",        0, false, false, 100 },
 };
-std::vector<Building> buildings;  // All buildings in the scene
+const int SCENARIO_FRAMES = 60;   // Measured frames when --benchmark-frames is not given
+
+const int MAX_INSTANCES = 16;     // Upper bound for --instances
 
 // ==================== HELPER FUNCTIONS ====================
 
@@ -179,598 +123,162 @@ int endProgram(std::string message) {
 /*
  * These functions create textures procedurally (without loading image files).
  * This ensures the application is self-contained and doesn't require external assets.
- * Each texture is generated pixel-by-pixel and uploaded to the GPU.
+ * The pixels are generated on the CPU (TextureGen.cpp) and uploaded to the GPU here.
  */
 
 /**
- * Creates the EKG (electrocardiogram) waveform texture
- * The waveform shows the characteristic PQRST pattern of a heartbeat:
- * - P wave: small bump (atrial depolarization)
- * - QRS complex: large spike (ventricular depolarization)
- * - T wave: medium bump (ventricular repolarization)
- *
- * This texture is tiled horizontally to create a scrolling EKG display
+ * Uploads a generated image as a new texture
+ * RGB images get mipmaps (they are tiled across the 3D scene), RGBA UI images do not
  */
-unsigned int createEKGTexture() {
-    const int width = 256;
-    const int height = 128;
-    unsigned char* data = new unsigned char[width * height * 4];
-
-    for (int i = 0; i < width * height * 4; i += 4) {
-        data[i] = 0;
-        data[i + 1] = 0;
-        data[i + 2] = 0;
-        data[i + 3] = 0;
-    }
-
-    auto setPixel = [&](int x, int y, unsigned char r, unsigned char g, unsigned char b) {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            int idx = (y * width + x) * 4;
-            data[idx] = r;
-            data[idx + 1] = g;
-            data[idx + 2] = b;
-            data[idx + 3] = 255;
-        }
-    };
-
-    auto drawThickLine = [&](int x, int y1, int y2) {
-        int minY = (std::min)(y1, y2);
-        int maxY = (std::max)(y1, y2);
-        for (int y = minY; y <= maxY; y++) {
-            for (int dx = -2; dx <= 2; dx++) {
-                setPixel(x + dx, y, 0, 255, 0);
-            }
-        }
-    };
-
-    int baseline = height / 2;
-    int lastY = baseline;
-
-    for (int x = 0; x < width; x++) {
-        int y = baseline;
-        float t = (float)x / width;
-
-        if (t < 0.1f) {
-            y = baseline;
-        }
-        else if (t < 0.15f) {
-            float local = (t - 0.1f) / 0.05f;
-            y = baseline - (int)(10 * sin(local * M_PI));
-        }
-        else if (t < 0.25f) {
-            y = baseline;
-        }
-        else if (t < 0.30f) {
-            float local = (t - 0.25f) / 0.05f;
-            y = baseline + (int)(8 * sin(local * M_PI));
-        }
-        else if (t < 0.40f) {
-            float local = (t - 0.30f) / 0.10f;
-            if (local < 0.5f) {
-                y = baseline - (int)(50 * (local * 2));
-            }
-            else {
-                y = baseline - (int)(50 * (1.0f - (local - 0.5f) * 2));
-            }
-        }
-        else if (t < 0.48f) {
-            float local = (t - 0.40f) / 0.08f;
-            y = baseline + (int)(15 * sin(local * M_PI));
-        }
-        else if (t < 0.65f) {
-            float local = (t - 0.48f) / 0.17f;
-            y = baseline - (int)(15 * sin(local * M_PI));
-        }
-        else {
-            y = baseline;
-        }
-
-        drawThickLine(x, lastY, y);
-        lastY = y;
-    }
+GlTexture createTextureFromImage(const Image& image, GLint wrapS, GLint wrapT, const char* label) {
+    GLenum format = image.channels == 4 ? GL_RGBA : GL_RGB;
+    bool mipmapped = image.channels == 3;
 
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glStateBindTexture(0, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+    if (mipmapped) glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
-    return texture;
+    gpuResourceSetLabel(GPU_RES_TEXTURE, texture, label);
+    return GlTexture(texture);
 }
 
-unsigned int createArrowTexture(bool pointRight) {
-    const int size = 64;
-    unsigned char* data = new unsigned char[size * size * 4];
-
-    for (int i = 0; i < size * size * 4; i += 4) {
-        data[i] = 0;
-        data[i + 1] = 0;
-        data[i + 2] = 0;
-        data[i + 3] = 0;
-    }
-
-    auto setPixel = [&](int x, int y) {
-        if (x >= 0 && x < size && y >= 0 && y < size) {
-            int idx = (y * size + x) * 4;
-            data[idx] = 255;
-            data[idx + 1] = 255;
-            data[idx + 2] = 255;
-            data[idx + 3] = 255;
-        }
-    };
-
-    int cy = size / 2;
-
-    for (int thickness = -3; thickness <= 3; thickness++) {
-        for (int x = 15; x < 50; x++) {
-            setPixel(x, cy + thickness);
-        }
-        for (int i = 0; i < 15; i++) {
-            if (pointRight) {
-                setPixel(49 - i, cy - i + thickness);
-                setPixel(49 - i, cy + i + thickness);
-            }
-            else {
-                setPixel(15 + i, cy - i + thickness);
-                setPixel(15 + i, cy + i + thickness);
-            }
-        }
-    }
-
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
+/**
+ * Draws a digit string into a texture from the pool
+ * The caller assigns the result over its previous texture, which goes back
+ * to the pool, so the displays alternate between two textures of a size
+ * (the one being replaced may still be in use by the previous frame)
+ */
+GlTexture createDigitTexture(RenderResources& gpu, const char* digitStr) {
+    generateDigitImage(gpu.textureImage, digitStr);
+    GlTexture texture = texturePoolAcquire(GL_RGBA8, gpu.textureImage.width, gpu.textureImage.height, "digits");
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, gpu.textureImage.width, gpu.textureImage.height,
+        GL_RGBA, GL_UNSIGNED_BYTE, gpu.textureImage.pixels.data());
     return texture;
 }
 
-unsigned int createHeartTexture() {
-    const int size = 32;
-    unsigned char* data = new unsigned char[size * size * 4];
-
-    for (int i = 0; i < size * size * 4; i += 4) {
-        data[i] = 0;
-        data[i + 1] = 0;
-        data[i + 2] = 0;
-        data[i + 3] = 0;
-    }
-
-    int cx = size / 2;
-    int cy = size / 2;
-
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            float fx = (x - cx) / (float)(size / 2);
-            float fy = (y - cy) / (float)(size / 2);
-
-            float val = pow(fx * fx + fy * fy - 0.5f, 3) - fx * fx * fy * fy * fy;
-
-            if (val < 0) {
-                int idx = (y * size + x) * 4;
-                data[idx] = 255;
-                data[idx + 1] = 50;
-                data[idx + 2] = 80;
-                data[idx + 3] = 255;
-            }
-        }
-    }
-
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
-    return texture;
+/**
+ * Creates the digit textures and scratch pixels up front, so changing the
+ * clock, BPM or battery text never creates GL objects or allocates
+ */
+void reserveDigitTextures(RenderResources& gpu) {
+    const int clockChars = 8;   // HH:MM:SS
+    const int counterChars = 3; // BPM and battery percentage share a size
+    gpu.textureImage.pixels.reserve((size_t)DIGIT_CHAR_WIDTH * clockChars * DIGIT_CHAR_HEIGHT * 4);
+    texturePoolReserve(GL_RGBA8, DIGIT_CHAR_WIDTH * clockChars, DIGIT_CHAR_HEIGHT, 2, "digits");
+    texturePoolReserve(GL_RGBA8, DIGIT_CHAR_WIDTH * counterChars, DIGIT_CHAR_HEIGHT, 3, "digits");
 }
 
-const unsigned char FONT_DATA[128][7] = {
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 0-3
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 4-7
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 8-11
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 12-15
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 16-19
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 20-23
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 24-27
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 28-31
-    {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // 32 space
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 33-36
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 37-40
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 41-44
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 45-46
-    {0x01,0x01,0x02,0x04,0x08,0x10,0x10}, // 47 /
-    {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, // 48 0
-    {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // 49 1
-    {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, // 50 2
-    {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // 51 3
-    {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, // 52 4
-    {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // 53 5
-    {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, // 54 6
-    {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // 55 7
-    {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, // 56 8
-    {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // 57 9
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 58-61
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 62-64
-    {0x0E,0x11,0x11,0x1F,0x11,0x11,0x11}, // 65 A
-    {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, // 66 B
-    {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // 67 C
-    {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, // 68 D
-    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // 69 E
-    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, // 70 F
-    {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // 71 G
-    {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, // 72 H
-    {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // 73 I
-    {0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, // 74 J
-    {0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // 75 K
-    {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, // 76 L
-    {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // 77 M
-    {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, // 78 N
-    {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // 79 O
-    {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, // 80 P
-    {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // 81 Q
-    {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, // 82 R
-    {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // 83 S
-    {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, // 84 T
-    {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // 85 U
-    {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, // 86 V
-    {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // 87 W
-    {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, // 88 X
-    {0x11,0x11,0x11,0x0A,0x04,0x04,0x04}, // 89 Y
-    {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, // 90 Z
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 91-94
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 95-96
-    {0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // 97 a
-    {0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, // 98 b
-    {0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // 99 c
-    {0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, // 100 d
-    {0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // 101 e
-    {0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, // 102 f
-    {0x00,0x00,0x0F,0x11,0x0F,0x01,0x0E}, // 103 g
-    {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, // 104 h
-    {0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // 105 i
-    {0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, // 106 j
-    {0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // 107 k
-    {0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, // 108 l
-    {0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // 109 m
-    {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, // 110 n
-    {0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // 111 o
-    {0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, // 112 p
-    {0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // 113 q
-    {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, // 114 r
-    {0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // 115 s
-    {0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, // 116 t
-    {0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // 117 u
-    {0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, // 118 v
-    {0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // 119 w
-    {0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, // 120 x
-    {0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // 121 y
-    {0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, // 122 z
-    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 123-126
-    {0,0,0,0,0,0,0}  // 127
-};
-
-unsigned int createStudentInfoTexture() {
-    const int width = 256;
-    const int height = 64;
-    unsigned char* data = new unsigned char[width * height * 4];
-
-    for (int i = 0; i < width * height * 4; i += 4) {
-        data[i] = 30;
-        data[i + 1] = 30;
-        data[i + 2] = 50;
-        data[i + 3] = 180;
-    }
-
-    auto setPixel = [&](int x, int y, unsigned char r, unsigned char g, unsigned char b) {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            int idx = (y * width + x) * 4;
-            data[idx] = r;
-            data[idx + 1] = g;
-            data[idx + 2] = b;
-            data[idx + 3] = 255;
-        }
-    };
-
-    auto drawChar = [&](char c, int startX, int startY, int scale,
-        unsigned char r, unsigned char g, unsigned char b) -> int {
-            unsigned char idx = (unsigned char)c;
-            if (idx >= 128) return 6 * scale;
-
-            for (int row = 0; row < 7; row++) {
-                unsigned char rowData = FONT_DATA[idx][row];
-                for (int col = 0; col < 5; col++) {
-                    if (rowData & (0x10 >> col)) {
-                        for (int sy = 0; sy < scale; sy++) {
-                            for (int sx = 0; sx < scale; sx++) {
-                                setPixel(startX + col * scale + sx,
-                                    startY - row * scale - sy, r, g, b);
-                            }
-                        }
-                    }
-                }
-            }
-            return 6 * scale;
-        };
-
-    auto drawString = [&](const char* str, int startX, int startY, int scale,
-        unsigned char r, unsigned char g, unsigned char b) {
-            int x = startX;
-            while (*str) {
-                x += drawChar(*str, x, startY, scale, r, g, b);
-                str++;
-            }
-        };
-
-    int scale = 2;
-    drawString("Nikola Bandulaja", 10, 50, scale, 255, 255, 255);
-    drawString("SV74/2022", 55, 22, scale, 200, 200, 220);
-
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
-    return texture;
+/*
+ * TEXTURE JOBS
+ * ------------
+ * The fixed procedural textures are generated on worker threads started
+ * before the engine's window exists, so the CPU work overlaps window and
+ * context creation.
+ * Textures the first frame needs are uploaded during startup (waiting for
+ * their job if necessary); the rest are uploaded the first time they are
+ * drawn (getLazyTexture).
+ */
+void startTextureJob(TextureJob& job, std::function<void(Image&)> generate) {
+    Image* image = &job.image;
+    job.done = std::async(std::launch::async, [generate, image]() { generate(*image); }).share();
 }
 
-unsigned int createDigitTexture(const char* digitStr) {
-    const int charWidth = 30;
-    const int charHeight = 50;
-    int len = (int)strlen(digitStr);
-    int width = charWidth * len;
-    int height = charHeight;
-
-    unsigned char* data = new unsigned char[width * height * 4];
-
-    for (int i = 0; i < width * height * 4; i += 4) {
-        data[i] = 0;
-        data[i + 1] = 0;
-        data[i + 2] = 0;
-        data[i + 3] = 0;
-    }
-
-    auto setPixel = [&](int x, int y, unsigned char r, unsigned char g, unsigned char b) {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            int idx = (y * width + x) * 4;
-            data[idx] = r;
-            data[idx + 1] = g;
-            data[idx + 2] = b;
-            data[idx + 3] = 255;
-        }
-    };
-
-    const bool segments[12][7] = {
-        {1,1,1,0,1,1,1},
-        {0,0,1,0,0,1,0},
-        {1,0,1,1,1,0,1},
-        {1,0,1,1,0,1,1},
-        {0,1,1,1,0,1,0},
-        {1,1,0,1,0,1,1},
-        {1,1,0,1,1,1,1},
-        {1,0,1,0,0,1,0},
-        {1,1,1,1,1,1,1},
-        {1,1,1,1,0,1,1},
-        {0,0,0,0,0,0,0},
-        {0,0,0,0,0,0,0},
-    };
-
-    auto drawSegment = [&](int offsetX, int seg) {
-        int thick = 4;
-        int margin = 3;
-        int segW = charWidth - 2 * margin;
-
-        switch (seg) {
-        case 0:
-            for (int t = 0; t < thick; t++)
-                for (int x = margin; x < margin + segW; x++)
-                    setPixel(offsetX + x, height - margin - t, 200, 230, 255);
-            break;
-        case 1:
-            for (int t = 0; t < thick; t++)
-                for (int y = height / 2 + margin / 2; y < height - margin; y++)
-                    setPixel(offsetX + margin + t, y, 200, 230, 255);
-            break;
-        case 2:
-            for (int t = 0; t < thick; t++)
-                for (int y = height / 2 + margin / 2; y < height - margin; y++)
-                    setPixel(offsetX + charWidth - margin - t, y, 200, 230, 255);
-            break;
-        case 3:
-            for (int t = 0; t < thick; t++)
-                for (int x = margin; x < margin + segW; x++)
-                    setPixel(offsetX + x, height / 2 + t - thick / 2, 200, 230, 255);
-            break;
-        case 4:
-            for (int t = 0; t < thick; t++)
-                for (int y = margin; y < height / 2 - margin / 2; y++)
-                    setPixel(offsetX + margin + t, y, 200, 230, 255);
-            break;
-        case 5:
-            for (int t = 0; t < thick; t++)
-                for (int y = margin; y < height / 2 - margin / 2; y++)
-                    setPixel(offsetX + charWidth - margin - t, y, 200, 230, 255);
-            break;
-        case 6:
-            for (int t = 0; t < thick; t++)
-                for (int x = margin; x < margin + segW; x++)
-                    setPixel(offsetX + x, margin + t, 200, 230, 255);
-            break;
-        }
-    };
-
-    auto drawColon = [&](int offsetX) {
-        int dotSize = 4;
-        int cx = offsetX + charWidth / 2;
-        for (int dy = -dotSize / 2; dy <= dotSize / 2; dy++) {
-            for (int dx = -dotSize / 2; dx <= dotSize / 2; dx++) {
-                setPixel(cx + dx, height * 3 / 4 + dy, 200, 230, 255);
-                setPixel(cx + dx, height * 1 / 4 + dy, 200, 230, 255);
-            }
-        }
-    };
-
-    for (int i = 0; i < len; i++) {
-        char c = digitStr[i];
-        int offsetX = i * charWidth;
-
-        if (c == ':') {
-            drawColon(offsetX);
-        }
-        else if (c >= '0' && c <= '9') {
-            int digit = c - '0';
-            for (int s = 0; s < 7; s++) {
-                if (segments[digit][s]) {
-                    drawSegment(offsetX, s);
-                }
-            }
-        }
-    }
-
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
-    return texture;
+void startTextureJobs(RenderResources& gpu) {
+    // Road continues the rand() sequence seeded by the ground, so they share a job
+    Image* ground = &gpu.groundJob.image;
+    Image* road = &gpu.roadJob.image;
+    gpu.groundJob.done = gpu.roadJob.done = std::async(std::launch::async, [ground, road]() {
+        generateGroundImage(*ground);
+        generateRoadImage(*road);
+    }).share();
+    startTextureJob(gpu.buildingJob, [](Image& image) { generateBuildingFacades(image, BUILDING_FACADES); });
+    startTextureJob(gpu.arrowRightJob, [](Image& image) { generateArrowImage(image, true); });
+    startTextureJob(gpu.arrowLeftJob, [](Image& image) { generateArrowImage(image, false); });
+    startTextureJob(gpu.ekgJob, generateEKGImage);
+    startTextureJob(gpu.heartJob, generateHeartImage);
+    startTextureJob(gpu.studentInfoJob, generateStudentInfoImage);
 }
 
-unsigned int createGroundTexture() {
-    const int size = 256;
-    unsigned char* data = new unsigned char[size * size * 3];
-
-    srand(12345);
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            int idx = (y * size + x) * 3;
-            int base = 60 + rand() % 30;
-            data[idx] = base;
-            data[idx + 1] = base + 20 + rand() % 20;
-            data[idx + 2] = base - 20;
-        }
-    }
-
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
+/**
+ * Waits for the job (if still running) and uploads its image
+ */
+GlTexture finishTextureJob(TextureJob& job) {
+    job.done.wait();
+    GlTexture texture = createTextureFromImage(job.image, job.wrapS, job.wrapT, job.label);
+    job.image.pixels = std::vector<unsigned char>();
     return texture;
 }
 
-unsigned int createRoadTexture() {
-    const int width = 256;
-    const int height = 256;
-    unsigned char* data = new unsigned char[width * height * 3];
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = (y * width + x) * 3;
-            int base = 50 + rand() % 15;
-            data[idx] = base;
-            data[idx + 1] = base;
-            data[idx + 2] = base;
-        }
-    }
-
-    // Center line
-    for (int y = 0; y < height; y++) {
-        for (int x = width / 2 - 4; x < width / 2 + 4; x++) {
-            if ((y / 32) % 2 == 0) {
-                int idx = (y * width + x) * 3;
-                data[idx] = 255;
-                data[idx + 1] = 255;
-                data[idx + 2] = 200;
-            }
-        }
-    }
+/**
+ * Waits for a job whose image holds layers equal squares stacked top to
+ * bottom and uploads it as a mipmapped GL_TEXTURE_2D_ARRAY, one layer per square
+ */
+GlTexture finishTextureArrayJob(TextureJob& job, int layers) {
+    job.done.wait();
+    const Image& image = job.image;
+    int layerHeight = image.height / layers;
+    GLenum format = image.channels == 4 ? GL_RGBA : GL_RGB;
 
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glStateBindTextureArray(0, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, image.width, layerHeight, layers, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, job.wrapS);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, job.wrapT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gpuResourceSetLabel(GPU_RES_TEXTURE, texture, job.label);
+
+    job.image.pixels = std::vector<unsigned char>();
+    return GlTexture(texture);
+}
 
-    delete[] data;
+/**
+ * Returns the texture of a job, uploading it on first use. Without wait,
+ * returns 0 while the image is still being generated (caller skips the draw).
+ */
+unsigned int getLazyTexture(GlTexture& texture, TextureJob& job, bool wait) {
+    if (texture != 0) return texture;
+    if (!wait && job.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return 0;
+    texture = finishTextureJob(job);
     return texture;
 }
 
-unsigned int createBuildingTexture() {
-    const int size = 128;
-    unsigned char* data = new unsigned char[size * size * 3];
-
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            int idx = (y * size + x) * 3;
-            data[idx] = 120;
-            data[idx + 1] = 110;
-            data[idx + 2] = 100;
-        }
+// Lets the jobs still running finish writing into their images
+void waitTextureJobs(RenderResources& gpu) {
+    for (TextureJob* job : { &gpu.groundJob, &gpu.roadJob, &gpu.buildingJob, &gpu.arrowRightJob, &gpu.arrowLeftJob,
+        &gpu.ekgJob, &gpu.heartJob, &gpu.studentInfoJob }) {
+        if (job->done.valid()) job->done.wait();
     }
+}
 
-    // Windows
-    for (int wy = 0; wy < 4; wy++) {
-        for (int wx = 0; wx < 4; wx++) {
-            int startX = 8 + wx * 30;
-            int startY = 8 + wy * 30;
-            for (int dy = 0; dy < 20; dy++) {
-                for (int dx = 0; dx < 18; dx++) {
-                    int idx = ((startY + dy) * size + (startX + dx)) * 3;
-                    if (idx < size * size * 3) {
-                        data[idx] = 180;
-                        data[idx + 1] = 200;
-                        data[idx + 2] = 220;
-                    }
-                }
-            }
-        }
-    }
+void finishLazyTextures(RenderResources& gpu) {
+    getLazyTexture(gpu.ekgTexture, gpu.ekgJob, true);
+    getLazyTexture(gpu.heartCursorTexture, gpu.heartJob, true);
+    getLazyTexture(gpu.studentInfoTexture, gpu.studentInfoJob, true);
+}
 
+/**
+ * Creates an empty RGBA texture whose contents are replaced with glTexSubImage2D
+ * Used by the performance screen so refreshing the HUD never creates GL objects
+ */
+GlTexture createDynamicTexture(int width, int height, const char* label) {
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    delete[] data;
-    return texture;
+    glStateBindTexture(0, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    gpuResourceSetLabel(GPU_RES_TEXTURE, texture, label);
+    return GlTexture(texture);
 }
 
 // ==================== VAO CREATION FUNCTIONS ====================
@@ -785,39 +293,67 @@ unsigned int createBuildingTexture() {
  * - Position: 3D coordinates in model space
  * - Normal: Surface normal for lighting calculations
  * - TexCoord: UV coordinates for texture mapping
+ *
+ * The 3D meshes are also appended to the vertex pool (VertexPull.h), which
+ * replaces their VAOs when vertex_pull is on.
  */
 
+const int TEXTURE_ARRAY_UNIT = 1;  // basicShader's uTextureArray; uTexture keeps unit 0
+const int VERTEX_BUFFER_UNIT = 2;  // basicShader's uVertices (vertex_pull)
+const int INSTANCE_BUFFER_UNIT = 3;  // basicShader's uInstances (vertex_pull)
+const float GROUND_WIDTH = 100.0f;
+const glm::vec2 GROUND_TEXCOORD_SPAN(10.0f, 4.0f);  // Texture repeats across and along one ground quad
+
+/**
+ * Describes a mesh just uploaded to vao and adds it to the vertex pool
+ * @param indices Index buffer contents, or NULL for a plain triangle list
+ * @param count Number of indices (or of vertices when indices is NULL)
+ */
+SceneMesh createSceneMesh(RenderResources& gpu, GLuint vao, const float* vertices, const unsigned int* indices, int count) {
+    SceneMesh mesh;
+    mesh.vao = vao;
+    mesh.count = count;
+    mesh.indexed = indices != NULL;
+    mesh.pulled = vertexPoolAddMesh(gpu.vertexPool, vertices, VERTEX_LAYOUT_PNT, indices, count);
+    return mesh;
+}
+
 /**
  * Creates the ground plane VAO
  * A large quad (100m x 20m) that tiles to create infinite ground
  * Normal points up (0, 1, 0) for correct lighting
  * Texture coordinates are scaled to tile the grass texture
  */
-void createGroundVAO() {
-    float halfW = 50.0f;  // Half width = 50m, total width = 100m
+void createGroundVAO(RenderResources& gpu) {
+    float halfW = GROUND_WIDTH / 2.0f;  // Half width = 50m, total width = 100m
     float len = GROUND_SEGMENT_LENGTH;  // Length of one segment
+    float u = GROUND_TEXCOORD_SPAN.x;
+    float v = GROUND_TEXCOORD_SPAN.y;
 
     float vertices[] = {
         // Position              Normal           TexCoord
         -halfW, 0.0f,  0.0f,    0.0f, 1.0f, 0.0f,  0.0f, 0.0f,
-         halfW, 0.0f,  0.0f,    0.0f, 1.0f, 0.0f,  10.0f, 0.0f,
-         halfW, 0.0f, -len,     0.0f, 1.0f, 0.0f,  10.0f, 4.0f,
-        -halfW, 0.0f, -len,     0.0f, 1.0f, 0.0f,  0.0f, 4.0f,
+         halfW, 0.0f,  0.0f,    0.0f, 1.0f, 0.0f,  u, 0.0f,
+         halfW, 0.0f, -len,     0.0f, 1.0f, 0.0f,  u, v,
+        -halfW, 0.0f, -len,     0.0f, 1.0f, 0.0f,  0.0f, v,
     };
 
     unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
 
-    unsigned int VBO, EBO;
-    glGenVertexArrays(1, &VAOground);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    unsigned int vao, vbo, ebo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    gpu.VAOground = GlVertexArray(vao);
+    gpu.VBOground = GlBuffer(vbo);
+    gpu.EBOground = GlBuffer(ebo);
 
-    glBindVertexArray(VAOground);
+    glStateBindVertexArray(gpu.VAOground);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.VBOground);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.EBOground);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -827,7 +363,12 @@ void createGroundVAO() {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+    glStateBindVertexArray(0);
+
+    gpuResourceSetLabel(GPU_RES_VERTEX_ARRAY, gpu.VAOground, "ground");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.VBOground, "ground vertices");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.EBOground, "ground indices");
+    gpu.groundMesh = createSceneMesh(gpu, gpu.VAOground, vertices, indices, 6);
 }
 
 /**
@@ -840,7 +381,7 @@ void createGroundVAO() {
  * IMPORTANT: The winding order must be counter-clockwise (CCW) when viewed
  * from outside the cube for back-face culling to work correctly.
  */
-void createCubeVAO() {
+void createCubeVAO(RenderResources& gpu) {
     float vertices[] = {
         // Back face (facing -Z direction)
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 0.0f,
@@ -886,13 +427,15 @@ void createCubeVAO() {
          -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
     };
 
-    unsigned int VBO;
-    glGenVertexArrays(1, &VAOcube);
-    glGenBuffers(1, &VBO);
+    unsigned int vao, vbo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    gpu.VAOcube = GlVertexArray(vao);
+    gpu.VBOcube = GlBuffer(vbo);
 
-    glBindVertexArray(VAOcube);
+    glStateBindVertexArray(gpu.VAOcube);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.VBOcube);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -902,7 +445,11 @@ void createCubeVAO() {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+    glStateBindVertexArray(0);
+
+    gpuResourceSetLabel(GPU_RES_VERTEX_ARRAY, gpu.VAOcube, "cube");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.VBOcube, "cube vertices");
+    gpu.cubeMesh = createSceneMesh(gpu, gpu.VAOcube, vertices, NULL, 36);
 }
 
 /**
@@ -911,7 +458,7 @@ void createCubeVAO() {
  * Normal points forward (+Z) for emissive lighting calculation.
  * Size: 0.3m x 0.3m (30cm square watch face)
  */
-void createWatchQuadVAO() {
+void createWatchQuadVAO(RenderResources& gpu) {
     float vertices[] = {
         // Position              Normal             TexCoord
         // Normal faces +Z so the watch screen "emits" light forward
@@ -923,17 +470,20 @@ void createWatchQuadVAO() {
 
     unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
 
-    unsigned int VBO, EBO;
-    glGenVertexArrays(1, &VAOwatchQuad);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    unsigned int vao, vbo, ebo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    gpu.VAOwatchQuad = GlVertexArray(vao);
+    gpu.VBOwatchQuad = GlBuffer(vbo);
+    gpu.EBOwatchQuad = GlBuffer(ebo);
 
-    glBindVertexArray(VAOwatchQuad);
+    glStateBindVertexArray(gpu.VAOwatchQuad);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.VBOwatchQuad);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.EBOwatchQuad);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -943,7 +493,12 @@ void createWatchQuadVAO() {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+    glStateBindVertexArray(0);
+
+    gpuResourceSetLabel(GPU_RES_VERTEX_ARRAY, gpu.VAOwatchQuad, "watch_quad");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.VBOwatchQuad, "watch_quad vertices");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.EBOwatchQuad, "watch_quad indices");
+    gpu.watchQuadMesh = createSceneMesh(gpu, gpu.VAOwatchQuad, vertices, indices, 6);
 }
 
 /**
@@ -952,7 +507,7 @@ void createWatchQuadVAO() {
  * Used to render watch UI elements to the framebuffer texture
  * Vertex format: [Position(2) | TexCoord(2)] = 4 floats per vertex (simpler than 3D)
  */
-void createScreenQuadVAO() {
+void createScreenQuadVAO(RenderResources& gpu) {
     float vertices[] = {
         // Position(2D)  TexCoord
         -1.0f,  1.0f,    0.0f, 1.0f,   // Top-left
@@ -963,17 +518,20 @@ void createScreenQuadVAO() {
 
     unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
 
-    unsigned int VBO, EBO;
-    glGenVertexArrays(1, &VAOscreenQuad);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    unsigned int vao, vbo, ebo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    gpu.VAOscreenQuad = GlVertexArray(vao);
+    gpu.VBOscreenQuad = GlBuffer(vbo);
+    gpu.EBOscreenQuad = GlBuffer(ebo);
 
-    glBindVertexArray(VAOscreenQuad);
+    glStateBindVertexArray(gpu.VAOscreenQuad);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.VBOscreenQuad);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.EBOscreenQuad);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -981,14 +539,57 @@ void createScreenQuadVAO() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    glStateBindVertexArray(0);
+
+    gpuResourceSetLabel(GPU_RES_VERTEX_ARRAY, gpu.VAOscreenQuad, "screen_quad");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.VBOscreenQuad, "screen_quad vertices");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.EBOscreenQuad, "screen_quad indices");
 }
 
 /**
  * Hand uses the same cube geometry, just scaled differently during rendering
  */
-void createHandVAO() {
-    VAOhand = VAOcube;  // Reuse cube VAO, transform during render
+void createHandVAO(RenderResources& gpu) {
+    gpu.VAOhand = gpu.VAOcube;  // Reuse cube VAO, transform during render
+}
+
+/**
+ * Uploads the vertex pool (every mesh created above) and creates the
+ * instance buffer that renderScene refills, both viewed as RGBA32F buffer
+ * textures on their own units, and the empty VAO pulled draws bind
+ */
+void createVertexPullBuffers(RenderResources& gpu, bool enabled) {
+    gpu.vertexPull = enabled;
+    if (!enabled) return;
+
+    unsigned int vao, buffers[2], textures[2];
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(2, buffers);
+    glGenTextures(2, textures);
+    gpu.VAOempty = GlVertexArray(vao);
+    gpu.pullVertexBuffer = GlBuffer(buffers[0]);
+    gpu.pullInstanceBuffer = GlBuffer(buffers[1]);
+    gpu.pullVertexTexture = GlTexture(textures[0]);
+    gpu.pullInstanceTexture = GlTexture(textures[1]);
+
+    const std::vector<glm::vec4>& vertices = gpu.vertexPool.vertices;
+    glBindBuffer(GL_TEXTURE_BUFFER, gpu.pullVertexBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, vertices.size() * sizeof(glm::vec4), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, gpu.pullInstanceBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, PULL_TEXELS_PER_INSTANCE * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);  // Resized by every pass
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // glTexBuffer attaches to the texture bound on the active unit
+    glStateBindTextureBuffer(VERTEX_BUFFER_UNIT, gpu.pullVertexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, gpu.pullVertexBuffer);
+    glStateBindTextureBuffer(INSTANCE_BUFFER_UNIT, gpu.pullInstanceTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, gpu.pullInstanceBuffer);
+
+    gpuResourceSetLabel(GPU_RES_VERTEX_ARRAY, gpu.VAOempty, "empty");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.pullVertexBuffer, "vertex_pool vertices");
+    gpuResourceSetLabel(GPU_RES_BUFFER, gpu.pullInstanceBuffer, "vertex_pool instances");
+    gpuResourceSetLabel(GPU_RES_TEXTURE, gpu.pullVertexTexture, "vertex_pool vertices");
+    gpuResourceSetLabel(GPU_RES_TEXTURE, gpu.pullInstanceTexture, "vertex_pool instances");
 }
 
 // ==================== FRAMEBUFFER SETUP ====================
@@ -1013,91 +614,145 @@ void createHandVAO() {
  * Creates the framebuffer for rendering the watch screen
  * The FBO has a color attachment (texture) where pixel data is written
  */
-void createWatchFramebuffer() {
+void createWatchFramebuffer(RenderResources& gpu, int size) {
     // Create and bind the framebuffer
-    glGenFramebuffers(1, &watchFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, watchFBO);
+    unsigned int fbo;
+    glGenFramebuffers(1, &fbo);
+    gpu.watchFBO = GlFramebuffer(fbo);
+    glStateBindFramebuffer(gpu.watchFBO);
 
     // Create the texture that will receive the rendered image
-    glGenTextures(1, &watchScreenTexture);
-    glBindTexture(GL_TEXTURE_2D, watchScreenTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, WATCH_SCREEN_SIZE, WATCH_SCREEN_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    gpu.watchScreenTexture = GlTexture(texture);
+    glStateBindTexture(0, gpu.watchScreenTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, watchScreenTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gpu.watchScreenTexture, 0);
+    gpuResourceSetLabel(GPU_RES_FRAMEBUFFER, gpu.watchFBO, "watch_screen");
+    gpuResourceSetLabel(GPU_RES_TEXTURE, gpu.watchScreenTexture, "watch_screen color");
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         std::cout << "Error: Watch framebuffer not complete!" << std::endl;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glStateBindFramebuffer(0);
 }
 
-// ==================== BUILDING GENERATION ====================
-/*
- * Buildings are procedurally generated with random variations in:
- * - Position: slight offset from the road edge
- * - Size: varying width, height, and depth
- * - Color: brownish/beige tones typical of urban buildings
- *
- * Using a fixed seed (42) ensures the same buildings are generated
- * every time the program runs, providing consistent visuals.
+/**
+ * Creates the panel format target (display_format other than rgb888) and
+ * uploads the dither matrix. RGB565 needs GL 4.1 or ARB_ES2_compatibility;
+ * without it GL_RGB5 lets the driver pick the closest format, and the
+ * shader has already reduced the colors to 565 levels anyway.
+ */
+void createDisplayFramebuffer(RenderResources& gpu, int size, DisplayPixelFormat format, DisplayDither dither) {
+    unsigned int fbo, texture, ditherTexture;
+    glGenFramebuffers(1, &fbo);
+    glGenTextures(1, &texture);
+    glGenTextures(1, &ditherTexture);
+    gpu.displayFBO = GlFramebuffer(fbo);
+    gpu.displayTexture = GlTexture(texture);
+    gpu.ditherTexture = GlTexture(ditherTexture);
+
+    GLenum internalFormat = GL_RGBA4;
+    GLenum dataFormat = GL_RGBA;
+    GLenum dataType = GL_UNSIGNED_SHORT_4_4_4_4;
+    if (format == DISPLAY_RGB565) {
+        internalFormat = (GLEW_VERSION_4_1 || GLEW_ARB_ES2_compatibility) ? GL_RGB565 : GL_RGB5;
+        dataFormat = GL_RGB;
+        dataType = GL_UNSIGNED_SHORT_5_6_5;
+    }
+
+    glStateBindFramebuffer(gpu.displayFBO);
+    glStateBindTexture(0, gpu.displayTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size, size, 0, dataFormat, dataType, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gpu.displayTexture, 0);
+    gpuResourceSetLabel(GPU_RES_FRAMEBUFFER, gpu.displayFBO, "display");
+    gpuResourceSetLabel(GPU_RES_TEXTURE, gpu.displayTexture, "display color");
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Error: Display framebuffer not complete!" << std::endl;
+    }
+    glStateBindFramebuffer(0);
+
+    const DitherMatrix& matrix = displayDitherMatrix(dither);
+    glStateBindTexture(0, gpu.ditherTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, matrix.size, matrix.size, 0, GL_RED, GL_UNSIGNED_BYTE, matrix.thresholds);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    gpuResourceSetLabel(GPU_RES_TEXTURE, gpu.ditherTexture, "dither");
+}
+
+/**
+ * Creates the offscreen target used in capture mode (color + depth renderbuffers)
+ * The 3D scene is rendered here instead of the hidden window's back buffer,
+ * which is not guaranteed to hold defined pixels
  */
+void createCaptureFramebuffer(RenderResources& gpu, int width, int height) {
+    unsigned int fbo, colorRBO, depthRBO;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &colorRBO);
+    glGenRenderbuffers(1, &depthRBO);
+    gpu.sceneFBO = GlFramebuffer(fbo);
+    gpu.sceneColorRBO = GlRenderbuffer(colorRBO);
+    gpu.sceneDepthRBO = GlRenderbuffer(depthRBO);
+
+    glStateBindFramebuffer(gpu.sceneFBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, gpu.sceneColorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, gpu.sceneColorRBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, gpu.sceneDepthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, gpu.sceneDepthRBO);
+    gpuResourceSetLabel(GPU_RES_FRAMEBUFFER, gpu.sceneFBO, "capture");
+    gpuResourceSetLabel(GPU_RES_RENDERBUFFER, gpu.sceneColorRBO, "capture color");
+    gpuResourceSetLabel(GPU_RES_RENDERBUFFER, gpu.sceneDepthRBO, "capture depth");
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Error: Capture framebuffer not complete!" << std::endl;
+    }
+
+    glStateBindFramebuffer(0);
+}
 
 /**
- * Generates buildings on both sides of the road
- * Called once at startup to populate the buildings vector
+ * Reads back the capture framebuffer and saves it as an RGB PNG
  */
-void generateBuildings() {
-    buildings.clear();
-    srand(42);  // Fixed seed for reproducible results
-
-    for (int side = 0; side < 2; side++) {
-        // Left side (side=0) is at negative X, right side (side=1) is at positive X
-        float sideX = (side == 0) ? -(ROAD_WIDTH + 5.0f) : (ROAD_WIDTH + 5.0f);
-
-        for (int i = 0; i < NUM_BUILDINGS_PER_SIDE; i++) {
-            Building b;
-
-            // Position with slight random offset for natural look
-            b.position = glm::vec3(
-                sideX + (rand() % 10 - 5) * 0.5f,    // X: road edge + random offset
-                0.0f,                                  // Y: ground level
-                -10.0f - i * BUILDING_SPACING - (rand() % 10) * 0.5f  // Z: spaced along road
-            );
-
-            // Random size within reasonable bounds
-            b.scale = glm::vec3(
-                4.0f + (rand() % 40) * 0.1f,   // Width: 4-8 meters
-                6.0f + (rand() % 100) * 0.1f,  // Height: 6-16 meters
-                4.0f + (rand() % 40) * 0.1f    // Depth: 4-8 meters
-            );
-
-            // Brownish/beige color with slight variation
-            b.color = glm::vec3(
-                0.5f + (rand() % 30) * 0.01f,   // Red: 0.5-0.8
-                0.45f + (rand() % 30) * 0.01f,  // Green: 0.45-0.75
-                0.4f + (rand() % 30) * 0.01f    // Blue: 0.4-0.7
-            );
-
-            buildings.push_back(b);
-        }
+void saveCapture(Engine& engine, const char* path) {
+    RenderResources& gpu = engine.gpu;
+    std::vector<unsigned char> pixels((size_t)engine.screenWidth * engine.screenHeight * 3);
+    glStateBindFramebuffer(gpu.sceneFBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, engine.screenWidth, engine.screenHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    if (writePng(path, engine.screenWidth, engine.screenHeight, 3, pixels.data(), true)) {
+        std::cout << "Saved capture: " << path << std::endl;
     }
 }
 
 // ==================== GLFW CALLBACKS ====================
 /*
  * Callbacks are functions called by GLFW when specific events occur.
- * They handle user input asynchronously.
+ * They handle user input asynchronously. Each window carries its engine
+ * as the GLFW user pointer, so the callbacks update that engine's state.
  */
 
+Engine& windowEngine(GLFWwindow* window) {
+    return *(Engine*)glfwGetWindowUserPointer(window);
+}
+
 /**
  * Mouse button callback - handles click events for watch UI navigation
  * Only processes clicks when in watch view mode (SPACE pressed)
  */
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-        mouseClicked = true;  // Flag processed in main loop
+        windowEngine(window).input.mouseClicked = true;  // Flag processed in main loop
     }
 }
 
@@ -1107,40 +762,46 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
  * In watch view mode: tracks cursor for UI interaction
  */
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
+    InputState& input = windowEngine(window).input;
+    WorldState& world = windowEngine(window).world;
+
     // Initialize delta tracking on first call
-    if (firstMouse) {
-        lastMouseX = xpos;
-        lastMouseY = ypos;
-        firstMouse = false;
+    if (input.firstMouse) {
+        input.lastMouseX = xpos;
+        input.lastMouseY = ypos;
+        input.firstMouse = false;
     }
 
     // Calculate movement since last frame
-    double xoffset = xpos - lastMouseX;
-    double yoffset = lastMouseY - ypos;  // Inverted: moving mouse up = positive yoffset
+    double xoffset = xpos - input.lastMouseX;
+    double yoffset = input.lastMouseY - ypos;  // Inverted: moving mouse up = positive yoffset
 
-    lastMouseX = xpos;
-    lastMouseY = ypos;
+    input.lastMouseX = xpos;
+    input.lastMouseY = ypos;
 
     // Only adjust camera when not in watch view mode
-    if (!watchViewMode) {
+    if (!world.watchViewMode) {
         float sensitivity = 0.1f;
-        cameraBasePitch += (float)yoffset * sensitivity;
+        world.cameraBasePitch += (float)yoffset * sensitivity;
         // Clamp pitch to prevent camera flipping
-        cameraBasePitch = glm::clamp(cameraBasePitch, -45.0f, 45.0f);
+        world.cameraBasePitch = glm::clamp(world.cameraBasePitch, -45.0f, 45.0f);
     }
 
     // Store current position for watch UI hit detection
-    mouseX = xpos;
-    mouseY = ypos;
+    input.mouseX = xpos;
+    input.mouseY = ypos;
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    InputState& input = windowEngine(window).input;
+    WorldState& world = windowEngine(window).world;
+
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
 
     if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
-        watchViewMode = !watchViewMode;
+        world.watchViewMode = !world.watchViewMode;
         //if (watchViewMode) {
         //    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
         //   /* glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);*/
@@ -1152,84 +813,85 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 
     if (key == GLFW_KEY_F1 && action == GLFW_PRESS) {
-        depthTestEnabled = !depthTestEnabled;
-        std::cout << "Depth testing: " << (depthTestEnabled ? "ON" : "OFF") << std::endl;
+        input.depthTestEnabled = !input.depthTestEnabled;
+        std::cout << "Depth testing: " << (input.depthTestEnabled ? "ON" : "OFF") << std::endl;
     }
 
     if (key == GLFW_KEY_F2 && action == GLFW_PRESS) {
-        faceCullingEnabled = !faceCullingEnabled;
-        std::cout << "Face culling: " << (faceCullingEnabled ? "ON" : "OFF") << std::endl;
+        input.faceCullingEnabled = !input.faceCullingEnabled;
+        std::cout << "Face culling: " << (input.faceCullingEnabled ? "ON" : "OFF") << std::endl;
     }
 }
 
 // ==================== UPDATE FUNCTIONS ====================
 
-void updateClock(double currentTime) {
-    if (currentTime - lastSecondTime >= 1.0) {
-        lastSecondTime = currentTime;
-        seconds++;
-        if (seconds >= 60) {
-            seconds = 0;
-            minutes++;
-            if (minutes >= 60) {
-                minutes = 0;
-                hours++;
-                if (hours >= 24) {
-                    hours = 0;
+void updateClock(WorldState& world, double currentTime) {
+    if (currentTime - world.lastSecondTime >= 1.0) {
+        world.lastSecondTime = currentTime;
+        world.seconds++;
+        if (world.seconds >= 60) {
+            world.seconds = 0;
+            world.minutes++;
+            if (world.minutes >= 60) {
+                world.minutes = 0;
+                world.hours++;
+                if (world.hours >= 24) {
+                    world.hours = 0;
                 }
             }
         }
     }
 }
 
-void updateHeartRate(double deltaTime) {
-    if (isRunning) {
-        targetBpm = (std::min)(targetBpm + 30.0f * (float)deltaTime, 220.0f);
+void updateHeartRate(WorldState& world, double deltaTime) {
+    if (world.isRunning) {
+        world.targetBpm = (std::min)(world.targetBpm + 30.0f * (float)deltaTime, 220.0f);
     }
     else {
-        targetBpm = (std::max)(targetBpm - 20.0f * (float)deltaTime, 60.0f + (rand() % 20));
+        world.targetBpm = (std::max)(world.targetBpm - 20.0f * (float)deltaTime, 60.0f + (rand() % 20));
     }
 
-    bpm += (targetBpm - bpm) * 2.0f * (float)deltaTime;
+    world.bpm += (world.targetBpm - world.bpm) * 2.0f * (float)deltaTime;
 
-    float speed = bpm / 60.0f;
-    ekgOffset += speed * (float)deltaTime * 0.5f;
-    if (ekgOffset > 1.0f) ekgOffset -= 1.0f;
+    float speed = world.bpm / 60.0f;
+    world.ekgOffset += speed * (float)deltaTime * 0.5f;
+    if (world.ekgOffset > 1.0f) world.ekgOffset -= 1.0f;
 
-    float targetScale = 60.0f / bpm;
-    ekgScale += (targetScale - ekgScale) * 2.0f * (float)deltaTime;
+    float targetScale = 60.0f / world.bpm;
+    world.ekgScale += (targetScale - world.ekgScale) * 2.0f * (float)deltaTime;
 }
 
-void updateBattery(double currentTime) {
-    if (currentTime - lastBatteryDrain >= 10.0 && batteryPercent > 0) {
-        lastBatteryDrain = currentTime;
-        batteryPercent--;
+void updateBattery(WorldState& world, double currentTime) {
+    if (currentTime - world.lastBatteryDrain >= 10.0 && world.batteryPercent > 0) {
+        world.lastBatteryDrain = currentTime;
+        world.batteryPercent--;
     }
 }
 
-void updateRunning(double deltaTime) {
-    if (isRunning && currentScreen == 1) {
-        runTime += (float)deltaTime * 8.0f;
-        cameraBobOffset = sin(runTime) * 0.05f;
-        groundOffset += (float)deltaTime * 8.0f;
+void updateRunning(WorldState& world, double deltaTime) {
+    if (world.isRunning && world.currentScreen == 1) {
+        world.runTime += (float)deltaTime * 8.0f;
+        world.cameraBobOffset = sin(world.runTime) * 0.05f;
+        world.groundOffset += (float)deltaTime * 8.0f;
 
-        if (groundOffset > GROUND_SEGMENT_LENGTH) {
-            groundOffset -= GROUND_SEGMENT_LENGTH;
+        if (world.groundOffset > GROUND_SEGMENT_LENGTH) {
+            world.groundOffset -= GROUND_SEGMENT_LENGTH;
         }
     }
     else {
-        cameraBobOffset *= 0.9f;
+        world.cameraBobOffset *= 0.9f;
     }
 }
 
 // ==================== SCREEN DRAWING (2D to FBO) ====================
 
-void drawScreenQuad(unsigned int shader, float x, float y, float w, float h,
+void drawScreenQuad(const RenderResources& gpu, float x, float y, float w, float h,
     float r, float g, float b, float a,
     unsigned int texture = 0,
     float texScaleX = 1.0f, float texOffsetX = 0.0f) {
 
-    glUseProgram(shader);
+    unsigned int shader = gpu.screenShader;
+    glStateUseProgram(shader);
 
     glUniform2f(glGetUniformLocation(shader, "uPos"), x, y);
     glUniform2f(glGetUniformLocation(shader, "uScale"), w, h);
@@ -1239,188 +901,330 @@ void drawScreenQuad(unsigned int shader, float x, float y, float w, float h,
     glUniform1f(glGetUniformLocation(shader, "uTexOffsetX"), texOffsetX);
 
     if (texture != 0) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        glStateBindTexture(0, texture);
         glUniform1i(glGetUniformLocation(shader, "uTexture"), 0);
     }
 
-    glBindVertexArray(VAOscreenQuad);
+    glStateBindVertexArray(gpu.VAOscreenQuad);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
 }
 
-bool isPointInRect(float px, float py, float rx, float ry, float rw, float rh) {
-    return px >= rx - rw && px <= rx + rw && py >= ry - rh && py <= ry + rh;
+/**
+ * Digit texture showing text, recreated when the text differs from shown
+ */
+unsigned int digitTexture(RenderResources& gpu, GlTexture& texture, char* shown, size_t shownSize, const char* text) {
+    if (strcmp(text, shown) != 0) {
+        texture = createDigitTexture(gpu, text);
+        snprintf(shown, shownSize, "%s", text);
+    }
+    return texture;
 }
 
-void drawClockScreen() {
-    char timeStr[16];
-    snprintf(timeStr, sizeof(timeStr), "%02d:%02d:%02d", hours, minutes, seconds);
-
-    static unsigned int timeTexture = 0;
-    static char lastTimeStr[16] = "";
-
-    if (strcmp(timeStr, lastTimeStr) != 0) {
-        if (timeTexture != 0) glDeleteTextures(1, &timeTexture);
-        timeTexture = createDigitTexture(timeStr);
-        strcpy(lastTimeStr, timeStr);
+/**
+ * Texture of a watch UI image; digit textures are brought up to date with
+ * the frame's text first, so only the text on screen is ever regenerated
+ */
+unsigned int watchUiTexture(RenderResources& gpu, const WatchUiFrame& frame, int image) {
+    switch (image) {
+    case UI_IMAGE_ARROW_LEFT:  return gpu.arrowLeftTexture;
+    case UI_IMAGE_ARROW_RIGHT: return gpu.arrowRightTexture;
+    case UI_IMAGE_EKG:         return getLazyTexture(gpu.ekgTexture, gpu.ekgJob, true);
+    case UI_IMAGE_HEART:       return getLazyTexture(gpu.heartCursorTexture, gpu.heartJob, true);
+    case UI_IMAGE_TIME:
+        return digitTexture(gpu, gpu.timeTexture, gpu.lastTimeStr, sizeof(gpu.lastTimeStr), frame.timeText);
+    case UI_IMAGE_BPM:
+        return digitTexture(gpu, gpu.bpmTexture, gpu.lastBpmStr, sizeof(gpu.lastBpmStr), frame.bpmText);
+    case UI_IMAGE_PERCENT:
+        return digitTexture(gpu, gpu.percTexture, gpu.lastPercStr, sizeof(gpu.lastPercStr), frame.percentText);
+    case UI_IMAGE_PERF_TEXT:   return gpu.perfTextTexture;
+    case UI_IMAGE_PERF_GRAPH:  return gpu.perfGraphTexture;
+    default:                   return 0;
     }
+}
 
-    drawScreenQuad(screenShader, 0.0f, 0.0f, 0.6f, 0.15f, 1.0f, 1.0f, 1.0f, 1.0f, timeTexture);
-
-    float arrowSize = 0.1f;
-    float arrowX = 0.8f;
-    drawScreenQuad(screenShader, arrowX, 0.0f, arrowSize, arrowSize, 1.0f, 1.0f, 1.0f, 1.0f, arrowRightTexture);
-
-    if (watchViewMode && mouseClicked) {
-        float normMouseX = ((float)mouseX / screenWidth) * 2 - 1;
-        float normMouseY = -(((float)mouseY / screenHeight) * 2 - 1);
-
-        if (isPointInRect(normMouseX, normMouseY, arrowX, 0.0f, arrowSize, arrowSize)) {
-            currentScreen = 1;
-        }
+// ----- Performance Screen -----
+/*
+ * The performance HUD only reads the profiler's published frame ring and
+ * redraws two small images (uploaded into persistent textures on the GL
+ * path), so it adds a handful of quads and no GL object churn to the frame
+ * it is measuring.
+ */
+const int PERF_TEXT_WIDTH = 256;
+const int PERF_TEXT_HEIGHT = 160;
+const int PERF_GRAPH_WIDTH = PROFILER_HISTORY_SIZE;  // One column per frame
+const int PERF_GRAPH_HEIGHT = 48;
+const float PERF_GRAPH_MAX_MS = 40.0f;      // Frame time at the top of the graph
+const double PERF_TEXT_REFRESH = 0.25;      // Seconds between text refreshes
+
+void updatePerfText(RenderResources& gpu, const FrameStats& stats) {
+    std::fill(gpu.perfText.pixels.begin(), gpu.perfText.pixels.end(), (unsigned char)0);
+
+    const unsigned int* c = stats.counters;
+    char lines[9][32];
+    snprintf(lines[0], sizeof(lines[0]), "FPS %.1f", profilerAverageFps());
+    snprintf(lines[1], sizeof(lines[1]), "FRAME %.2f MS", stats.frameTimeMs);
+    snprintf(lines[2], sizeof(lines[2]), "CPU %.2f MS", stats.cpuTimeMs);
+    snprintf(lines[3], sizeof(lines[3]), "DRAW %u VERT %u", c[COUNTER_DRAW_CALLS], c[COUNTER_VERTICES]);
+    snprintf(lines[4], sizeof(lines[4]), "PROG %u TEXB %u", c[COUNTER_PROGRAM_BINDS], c[COUNTER_TEXTURE_BINDS]);
+    snprintf(lines[5], sizeof(lines[5]), "UNIF %u STATE %u", c[COUNTER_UNIFORM_UPLOADS], c[COUNTER_STATE_CHANGES]);
+    snprintf(lines[6], sizeof(lines[6]), "TEXUP %u BUF %uB", c[COUNTER_TEXTURE_UPLOADS], c[COUNTER_BUFFER_BYTES]);
+    snprintf(lines[7], sizeof(lines[7]), "GPU UI %.2f 3D %.2f",
+        stats.gpuPassMs[GPU_PASS_WATCH_UI], stats.gpuPassMs[GPU_PASS_SCENE]);
+    snprintf(lines[8], sizeof(lines[8]), "GPU OVL %.2f MS", stats.gpuPassMs[GPU_PASS_OVERLAY]);
+
+    // Timing in blue, GL counters in white, GPU passes in orange
+    const unsigned char colors[3][3] = { {200, 230, 255}, {255, 255, 255}, {255, 200, 120} };
+    const int scale = 2;
+    const int lineStep = 16;
+    for (int i = 0; i < 9; i++) {
+        const unsigned char* col = colors[i < 3 ? 0 : (i < 7 ? 1 : 2)];
+        blitString(gpu.perfText.pixels.data(), PERF_TEXT_WIDTH, PERF_TEXT_HEIGHT, lines[i],
+            4, PERF_TEXT_HEIGHT - 6 - i * lineStep, scale, col[0], col[1], col[2]);
     }
+    gpu.perfTextChanged = true;
 }
 
-void drawHeartRateScreen() {
-    float arrowSize = 0.1f;
-    float leftArrowX = -0.8f;
-    float rightArrowX = 0.8f;
-
-    drawScreenQuad(screenShader, leftArrowX, 0.0f, arrowSize, arrowSize, 1.0f, 1.0f, 1.0f, 1.0f, arrowLeftTexture);
-    drawScreenQuad(screenShader, rightArrowX, 0.0f, arrowSize, arrowSize, 1.0f, 1.0f, 1.0f, 1.0f, arrowRightTexture);
-
-    // EKG background
-    drawScreenQuad(screenShader, 0.0f, -0.1f, 0.5f, 0.2f, 0.1f, 0.1f, 0.15f, 1.0f);
-
-    // EKG wave
-    float numRepeats = 3.0f / ekgScale;
-    drawScreenQuad(screenShader, 0.0f, -0.1f, 0.48f, 0.18f, 1.0f, 1.0f, 1.0f, 1.0f,
-        ekgTexture, numRepeats, ekgOffset);
-
-    // BPM display
-    char bpmStr[16];
-    snprintf(bpmStr, sizeof(bpmStr), "%03d", (int)bpm);
-    static unsigned int bpmTexture = 0;
-    static int lastBpm = 0;
-
-    if ((int)bpm != lastBpm) {
-        if (bpmTexture != 0) glDeleteTextures(1, &bpmTexture);
-        bpmTexture = createDigitTexture(bpmStr);
-        lastBpm = (int)bpm;
+void updatePerfGraph(RenderResources& gpu, float budgetMs) {
+    float frameTimes[PERF_GRAPH_WIDTH];
+    int count = profilerFrameTimes(frameTimes, PERF_GRAPH_WIDTH);
+    unsigned char* pixels = gpu.perfGraph.pixels.data();
+
+    // Dark translucent background
+    for (int i = 0; i < PERF_GRAPH_WIDTH * PERF_GRAPH_HEIGHT * 4; i += 4) {
+        pixels[i] = 20;
+        pixels[i + 1] = 20;
+        pixels[i + 2] = 30;
+        pixels[i + 3] = 200;
     }
 
-    drawScreenQuad(screenShader, 0.0f, 0.25f, 0.2f, 0.1f, 0.0f, 1.0f, 0.4f, 1.0f, bpmTexture);
-
-    // Warning overlay if BPM > 200
-    if (bpm > 200) {
-        drawScreenQuad(screenShader, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.3f);
+    // Newest frame on the right, colored by how it compares to the frame budget
+    for (int i = 0; i < count; i++) {
+        int x = PERF_GRAPH_WIDTH - count + i;
+        float ms = frameTimes[i];
+        int barHeight = (int)((std::min)(ms / PERF_GRAPH_MAX_MS, 1.0f) * PERF_GRAPH_HEIGHT);
+
+        unsigned char r = 60, g = 220, b = 90;
+        if (ms > budgetMs * 2.0f) { r = 255; g = 60; b = 60; }
+        else if (ms > budgetMs * 1.1f) { r = 255; g = 200; b = 0; }
+
+        for (int y = 0; y < barHeight; y++) {
+            int idx = (y * PERF_GRAPH_WIDTH + x) * 4;
+            pixels[idx] = r;
+            pixels[idx + 1] = g;
+            pixels[idx + 2] = b;
+            pixels[idx + 3] = 255;
+        }
     }
 
-    if (watchViewMode && mouseClicked) {
-        float normMouseX = ((float)mouseX / screenWidth) * 2 - 1;
-        float normMouseY = -(((float)mouseY / screenHeight) * 2 - 1);
-
-        if (isPointInRect(normMouseX, normMouseY, leftArrowX, 0.0f, arrowSize, arrowSize)) {
-            currentScreen = 0;
-        }
-        if (isPointInRect(normMouseX, normMouseY, rightArrowX, 0.0f, arrowSize, arrowSize)) {
-            currentScreen = 2;
+    // Frame budget line
+    int budgetY = (int)(budgetMs / PERF_GRAPH_MAX_MS * PERF_GRAPH_HEIGHT);
+    if (budgetY < PERF_GRAPH_HEIGHT) {
+        for (int x = 0; x < PERF_GRAPH_WIDTH; x++) {
+            int idx = (budgetY * PERF_GRAPH_WIDTH + x) * 4;
+            pixels[idx] = 255;
+            pixels[idx + 1] = 255;
+            pixels[idx + 2] = 255;
+            pixels[idx + 3] = 255;
         }
     }
 }
 
-void drawBatteryScreen() {
-    float arrowSize = 0.1f;
-    float arrowX = -0.8f;
+void updatePerformanceScreen(Engine& engine) {
+    RenderResources& gpu = engine.gpu;
 
-    drawScreenQuad(screenShader, arrowX, 0.0f, arrowSize, arrowSize, 1.0f, 1.0f, 1.0f, 1.0f, arrowLeftTexture);
+    // Text only needs to be readable, so it is refreshed a few times per second
+    double now = glfwGetTime();
+    if (now - gpu.lastPerfTextUpdate >= PERF_TEXT_REFRESH) {
+        updatePerfText(gpu, profilerLastFrame());
+        gpu.lastPerfTextUpdate = now;
+    }
+    updatePerfGraph(gpu, (float)(configFrameTime(engine.options->config) * 1000.0));
+}
 
-    // Battery outline
-    float battW = 0.3f;
-    float battH = 0.15f;
-    drawScreenQuad(screenShader, 0.0f, 0.0f, battW, battH, 0.8f, 0.8f, 0.8f, 1.0f);
-    drawScreenQuad(screenShader, 0.0f, 0.0f, battW - 0.02f, battH - 0.02f, 0.1f, 0.1f, 0.15f, 1.0f);
+void uploadPerformanceScreen(RenderResources& gpu) {
+    if (gpu.perfTextChanged) {
+        glStateBindTexture(0, gpu.perfTextTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PERF_TEXT_WIDTH, PERF_TEXT_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, gpu.perfText.pixels.data());
+        gpu.perfTextChanged = false;
+    }
+    glStateBindTexture(0, gpu.perfGraphTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PERF_GRAPH_WIDTH, PERF_GRAPH_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, gpu.perfGraph.pixels.data());
+}
 
-    // Battery cap
-    drawScreenQuad(screenShader, battW + 0.02f, 0.0f, 0.02f, 0.06f, 0.8f, 0.8f, 0.8f, 1.0f);
+// ----- Watch Panel Format -----
+/**
+ * Final watch UI pass: watchScreenTexture to displayFBO in the panel format
+ * (display.frag), one full-screen quad
+ */
+void convertWatchScreenGL(Engine& engine) {
+    RenderResources& gpu = engine.gpu;
+    const RuntimeConfig& config = engine.options->config;
+
+    int bits[3];
+    displayChannelBits(config.displayFormat, bits);
+    unsigned int shader = gpu.displayShader;
+
+    glStateBindFramebuffer(gpu.displayFBO);
+    glStateSetEnabled(GL_BLEND, false);
+    glStateUseProgram(shader);
+    glUniform2f(glGetUniformLocation(shader, "uPos"), 0.0f, 0.0f);
+    glUniform2f(glGetUniformLocation(shader, "uScale"), 1.0f, 1.0f);
+    glUniform1f(glGetUniformLocation(shader, "uTexScaleX"), 1.0f);
+    glUniform1f(glGetUniformLocation(shader, "uTexOffsetX"), 0.0f);
+    glUniform3f(glGetUniformLocation(shader, "uLevels"),
+        (float)((1 << bits[0]) - 1), (float)((1 << bits[1]) - 1), (float)((1 << bits[2]) - 1));
+    glUniform1i(glGetUniformLocation(shader, "uThresholdSize"), displayDitherMatrix(config.displayDither).size);
+    glUniform1i(glGetUniformLocation(shader, "uTexture"), 0);
+    glUniform1i(glGetUniformLocation(shader, "uThreshold"), 1);
+    glStateBindTexture(0, gpu.watchScreenTexture);
+    glStateBindTexture(1, gpu.ditherTexture);
+
+    glStateBindVertexArray(gpu.VAOscreenQuad);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
 
-    // Battery fill
-    float fillPercent = batteryPercent / 100.0f;
-    float maxFillW = battW - 0.04f;
-    float fillW = maxFillW * fillPercent;
-    float fillX = -(maxFillW - fillW);
+// ----- Watch Screen -----
+/*
+ * The screens are laid out once per frame as a quad list (WatchUi.h) and
+ * drawn either by the screen shader into watchFBO or by the software
+ * rasterizer (SoftRaster.h, watch_ui = cpu), whose result is uploaded into
+ * the FBO's color texture. Both land in watchScreenTexture, so the 3D pass
+ * does not know which one ran; the watch UI GPU pass times either the
+ * draws or the upload.
+ *
+ * With display_format rgb565/rgb444 the screen is then reduced to the panel
+ * format (DisplayFormat.h) and the watch quad shows displayTexture instead:
+ * the GL path adds a full-screen display.frag pass into displayFBO, the CPU
+ * path converts before uploading and uploads 16-bit pixels.
+ */
+void drawWatchUiGL(Engine& engine, const WatchUiFrame& frame) {
+    RenderResources& gpu = engine.gpu;
+    int size = engine.options->config.watchScreenSize;
 
-    float r, g, b;
-    if (batteryPercent <= 10) {
-        r = 1.0f; g = 0.2f; b = 0.2f;
-    }
-    else if (batteryPercent <= 20) {
-        r = 1.0f; g = 0.8f; b = 0.0f;
-    }
-    else {
-        r = 0.2f; g = 0.9f; b = 0.3f;
-    }
+    if (frame.screen == 3) uploadPerformanceScreen(gpu);
+    watchUiBuild(frame, gpu.watchUiQuads);
 
-    if (batteryPercent > 0) {
-        drawScreenQuad(screenShader, fillX, 0.0f, fillW, battH - 0.04f, r, g, b, 1.0f);
-    }
+    glStateBindFramebuffer(gpu.watchFBO);
+    glStateViewport(0, 0, size, size);
+    glClearColor(WATCH_UI_CLEAR_COLOR[0], WATCH_UI_CLEAR_COLOR[1], WATCH_UI_CLEAR_COLOR[2], WATCH_UI_CLEAR_COLOR[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    // Percentage display
-    char percStr[8];
-    snprintf(percStr, sizeof(percStr), "%03d", batteryPercent);
-    static unsigned int percTexture = 0;
-    static int lastPerc = -1;
+    glStateSetEnabled(GL_DEPTH_TEST, false);
+    glStateSetEnabled(GL_BLEND, true);
+    glStateBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    if (batteryPercent != lastPerc) {
-        if (percTexture != 0) glDeleteTextures(1, &percTexture);
-        percTexture = createDigitTexture(percStr);
-        lastPerc = batteryPercent;
+    for (const WatchUiQuad& quad : gpu.watchUiQuads) {
+        unsigned int texture = quad.image != UI_IMAGE_NONE ? watchUiTexture(gpu, frame, quad.image) : 0;
+        if (quad.image != UI_IMAGE_NONE && texture == 0) continue;
+        drawScreenQuad(gpu, quad.x, quad.y, quad.w, quad.h, quad.r, quad.g, quad.b, quad.a,
+            texture, quad.texScaleX, quad.texOffsetX);
     }
 
-    drawScreenQuad(screenShader, 0.0f, 0.3f, 0.15f, 0.08f, 1.0f, 1.0f, 1.0f, 1.0f, percTexture);
+    if (engine.options->config.displayFormat != DISPLAY_RGB888) convertWatchScreenGL(engine);
+    glStateBindFramebuffer(gpu.sceneFBO);
+}
 
-    if (watchViewMode && mouseClicked) {
-        float normMouseX = ((float)mouseX / screenWidth) * 2 - 1;
-        float normMouseY = -(((float)mouseY / screenHeight) * 2 - 1);
+void drawWatchUiCpu(Engine& engine, const WatchUiFrame& frame) {
+    RenderResources& gpu = engine.gpu;
+    int size = engine.options->config.watchScreenSize;
+
+    double start = glfwGetTime();
+    const Image& screen = softWatchUiRender(gpu.softWatchUi, frame, size, &gpu.perfText, &gpu.perfGraph);
+    gpu.softWatchUiMs += (glfwGetTime() - start) * 1000.0;
+    gpu.softWatchUiFrames++;
+    DisplayPixelFormat format = engine.options->config.displayFormat;
+    if (format == DISPLAY_RGB888) {
+        glStateBindTexture(0, gpu.watchScreenTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, screen.pixels.data());
+        return;
+    }
 
-        if (isPointInRect(normMouseX, normMouseY, arrowX, 0.0f, arrowSize, arrowSize)) {
-            currentScreen = 1;
-        }
+    // Converted on the CPU, so only 2 bytes per pixel are uploaded
+    displayConvert(screen, format, engine.options->config.displayDither, gpu.displayImage);
+    glStateBindTexture(0, gpu.displayTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);  // 16-bit rows of odd-sized screens are not 4-byte aligned
+    if (format == DISPLAY_RGB565) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, gpu.displayImage.pixels.data());
     }
+    else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, gpu.displayImage.pixels.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
-void renderWatchScreen() {
-    glBindFramebuffer(GL_FRAMEBUFFER, watchFBO);
-    glViewport(0, 0, WATCH_SCREEN_SIZE, WATCH_SCREEN_SIZE);
-    glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+/**
+ * Texture shown on the 3D watch quad: the panel format target when the
+ * screen is converted
+ */
+unsigned int watchSurfaceTexture(const Engine& engine) {
+    if (engine.options->config.displayFormat != DISPLAY_RGB888) return engine.gpu.displayTexture;
+    return engine.gpu.watchScreenTexture;
+}
 
-    switch (currentScreen) {
-    case 0:
-        drawClockScreen();
-        break;
-    case 1:
-        drawHeartRateScreen();
-        break;
-    case 2:
-        drawBatteryScreen();
-        break;
+/**
+ * Sends the composed watch screen to the simulated panel (display_link)
+ * The GL path's screen only exists on the GPU, so it is read back first,
+ * which waits for the watch UI pass to finish
+ */
+void pushWatchScreen(Engine& engine, int screen) {
+    RenderResources& gpu = engine.gpu;
+    int size = engine.options->config.watchScreenSize;
+
+    DisplayPixelFormat format = engine.options->config.displayFormat;
+    const Image* composed = format == DISPLAY_RGB888 ? &gpu.softWatchUi.target : &gpu.displayImage;
+    if (!engine.options->config.softWatchUi) {
+        unsigned char* pixels = gpu.watchReadback.pixels.data();
+        if (format == DISPLAY_RGB888) {
+            glStateBindFramebuffer(gpu.watchFBO);
+            glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+        else {
+            glStateBindFramebuffer(gpu.displayFBO);
+            glPixelStorei(GL_PACK_ALIGNMENT, 2);  // Rows as tight as displayConvert writes them
+            if (format == DISPLAY_RGB565) glReadPixels(0, 0, size, size, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, pixels);
+            else glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, pixels);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        }
+        glStateBindFramebuffer(gpu.sceneFBO);
+        composed = &gpu.watchReadback;
     }
 
-    // Draw cursor when in watch view mode
-    if (watchViewMode) {
-        float normMouseX = ((float)mouseX / screenWidth) * 2 - 1;
-        float normMouseY = -(((float)mouseY / screenHeight) * 2 - 1);
-        float cursorSize = 0.04f;
-        drawScreenQuad(screenShader, normMouseX, normMouseY, cursorSize, cursorSize, 1.0f, 1.0f, 1.0f, 1.0f, heartCursorTexture);
-    }
+    DisplayLinkFrame sent = displayLinkPush(gpu.displayLink, *composed, screen);
+    profilerCount(COUNTER_DISPLAY_BYTES, sent.bytes);
+    profilerCount(COUNTER_DISPLAY_TILES, (unsigned int)sent.changedTiles);
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void renderWatchScreen(Engine& engine) {
+    WorldState& world = engine.world;
+    const InputState& input = engine.input;
+
+    WatchUiFrame frame;
+    frame.screen = world.currentScreen;
+    watchUiSetText(frame, world.hours, world.minutes, world.seconds, world.bpm, world.batteryPercent);
+    frame.bpm = world.bpm;
+    frame.ekgScale = world.ekgScale;
+    frame.ekgOffset = world.ekgOffset;
+    frame.batteryPercent = world.batteryPercent;
+    frame.showCursor = world.watchViewMode;
+    frame.cursorX = ((float)input.mouseX / engine.screenWidth) * 2 - 1;
+    frame.cursorY = -(((float)input.mouseY / engine.screenHeight) * 2 - 1);
+
+    if (frame.screen == 3) updatePerformanceScreen(engine);
+
+    profilerBeginGpuPass(GPU_PASS_WATCH_UI);
+    glDebugPushGroup("renderWatchScreen");
+    if (engine.options->config.softWatchUi) drawWatchUiCpu(engine, frame);
+    else drawWatchUiGL(engine, frame);
+    glDebugPopGroup();
+    profilerEndGpuPass(GPU_PASS_WATCH_UI);
+
+    if (engine.options->config.displayLink) pushWatchScreen(engine, frame.screen);
+
+    // Navigation arrows; the new screen is drawn from the next frame on
+    if (world.watchViewMode && input.mouseClicked) {
+        int screen = watchUiHitTest(world.currentScreen, frame.cursorX, frame.cursorY);
+        if (screen >= 0) world.currentScreen = screen;
+    }
 }
 
 // ==================== 3D SCENE RENDERING ====================
@@ -1443,9 +1247,14 @@ void renderWatchScreen() {
  * - WEAK intensity - only noticeable close to the watch
  * - This creates the "screen glow" effect on the hand/nearby objects
  *
+ * STREET LIGHTS (uPointLights)
+ * ----------------------------
+ * - Optional (--lights N), warm sodium-lamp color, attenuated with distance
+ *
  * @param watchPos - Current world position of the watch screen
+ * @param streetLights - World positions of the street lights
  */
-void setLightUniforms(unsigned int shader, const glm::vec3& watchPos) {
+void setLightUniforms(unsigned int shader, const glm::vec3& watchPos, const std::vector<glm::vec3>& streetLights) {
     // ===== LIGHT 1: SUN =====
     // Position high and to the side for dramatic shadows
     setVec3(shader, "uLight.position", glm::vec3(20.0f, 50.0f, 10.0f));
@@ -1463,6 +1272,16 @@ void setLightUniforms(unsigned int shader, const glm::vec3& watchPos) {
     setVec3(shader, "uScreenLight.ambient", glm::vec3(0.05f, 0.05f, 0.1f));
     setVec3(shader, "uScreenLight.diffuse", glm::vec3(0.1f, 0.15f, 0.2f));  // Slight blue tint
     setVec3(shader, "uScreenLight.specular", glm::vec3(0.05f, 0.05f, 0.1f));
+
+    // ===== STREET LIGHTS =====
+    setInt(shader, "uPointLightCount", (int)streetLights.size());
+    for (size_t i = 0; i < streetLights.size(); i++) {
+        int n = (int)i;
+        setVec3(shader, frameArenaPrintf("uPointLights[%d].position", n), streetLights[i]);
+        setVec3(shader, frameArenaPrintf("uPointLights[%d].ambient", n), glm::vec3(0.0f));
+        setVec3(shader, frameArenaPrintf("uPointLights[%d].diffuse", n), glm::vec3(1.0f, 0.7f, 0.4f));
+        setVec3(shader, frameArenaPrintf("uPointLights[%d].specular", n), glm::vec3(0.5f, 0.35f, 0.2f));
+    }
 }
 
 /**
@@ -1480,6 +1299,171 @@ void setMaterialUniforms(unsigned int shader, const glm::vec3& ambient, const gl
     setFloat(shader, "uMaterial.shininess", shininess);
 }
 
+// Lighting response of each entity material (EntityMaterial)
+struct SceneMaterial {
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    float shininess;
+};
+
+const SceneMaterial SCENE_MATERIALS[MATERIAL_COUNT] = {
+    { glm::vec3(0.2f), glm::vec3(0.7f), glm::vec3(0.3f), 16.0f },                     // Building: concrete/plaster
+    { glm::vec3(0.3f), glm::vec3(0.8f, 0.6f, 0.5f), glm::vec3(0.2f), 8.0f },          // Skin: slightly subsurface look
+    { glm::vec3(0.1f), glm::vec3(0.3f), glm::vec3(0.8f), 64.0f },                     // Watch frame: metallic
+    { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), 1.0f },                      // Watch screen: emissive, unused
+};
+
+void setEntityMaterial(unsigned int shader, EntityMaterial material) {
+    const SceneMaterial& m = SCENE_MATERIALS[material];
+    setMaterialUniforms(shader, m.ambient, m.diffuse, m.specular, m.shininess);
+}
+
+// Startup messages and end-of-run reports of engines running at the same
+// time are printed one at a time
+std::mutex reportMutex;
+
+// ----- Ground Surfaces -----
+/*
+ * The ground and road are shaded either from the generated textures or
+ * procedurally in basic.frag (uSurface). Which is cheaper depends on the
+ * GPU (texture bandwidth vs ALU), so ground_shading = auto draws a
+ * screen-filling ground quad both ways at startup and keeps the faster.
+ */
+
+enum GroundSurface {
+    GROUND_SURFACE_GRASS = 1,   // uSurface values
+    GROUND_SURFACE_ROAD = 2
+};
+
+/**
+ * Sets up basicShader for ground or road quads in the active shading path
+ */
+void setGroundSurface(RenderResources& gpu, GroundSurface surface) {
+    unsigned int shader = gpu.basicShader;
+    if (!gpu.proceduralGround) {
+        setInt(shader, "uSurface", 0);
+        glStateBindTexture(0, surface == GROUND_SURFACE_GRASS ? gpu.groundTexture : gpu.roadTexture);
+        setInt(shader, "uTexture", 0);  // Texture unit 0
+        return;
+    }
+
+    // Meters per texture coordinate unit; the road quad is the ground quad scaled to ROAD_WIDTH
+    float width = surface == GROUND_SURFACE_GRASS ? GROUND_WIDTH : ROAD_WIDTH;
+    setInt(shader, "uSurface", surface);
+    glUniform2f(glGetUniformLocation(shader, "uSurfaceScale"),
+        width / GROUND_TEXCOORD_SPAN.x, GROUND_SEGMENT_LENGTH / GROUND_TEXCOORD_SPAN.y);
+}
+
+/**
+ * GPU time of screen-filling ground quads (draws of them) in the current path
+ * @return Milliseconds per quad
+ */
+double timeGroundDraws(Engine& engine, int draws) {
+    RenderResources& gpu = engine.gpu;
+    unsigned int query;
+    glGenQueries(1, &query);
+
+    setGroundSurface(gpu, GROUND_SURFACE_GRASS);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);  // Warm up caches and shader variants
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    for (int i = 0; i < draws; i++) {
+        setGroundSurface(gpu, i % 2 == 0 ? GROUND_SURFACE_GRASS : GROUND_SURFACE_ROAD);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);  // Waits for the GPU
+    glDeleteQueries(1, &query);
+    return elapsedNs / 1.0e6 / draws;
+}
+
+/**
+ * Resolves ground_shading: for auto, times both paths (best of a few
+ * rounds, half grass and half road quads) and keeps the faster. Scenario
+ * and capture runs take the texture path instead, so that their frames do
+ * not depend on how the timing came out.
+ */
+void chooseGroundShading(Engine& engine) {
+    RenderResources& gpu = engine.gpu;
+    GroundShading shading = engine.options->config.groundShading;
+    if (shading == GROUND_SHADING_AUTO && (engine.options->scenario != NULL || engine.options->capturePath != NULL)) {
+        shading = GROUND_SHADING_TEXTURE;
+    }
+    if (shading != GROUND_SHADING_AUTO) {
+        gpu.proceduralGround = shading == GROUND_SHADING_PROCEDURAL;
+        return;
+    }
+
+    // Maps the ground quad (x -50..50, z -len..0) onto the whole viewport
+    glm::mat4 fill(1.0f);
+    fill[0] = glm::vec4(2.0f / GROUND_WIDTH, 0.0f, 0.0f, 0.0f);
+    fill[1] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+    fill[2] = glm::vec4(0.0f, -2.0f / GROUND_SEGMENT_LENGTH, 0.0f, 0.0f);
+    fill[3] = glm::vec4(0.0f, -1.0f, 0.0f, 1.0f);
+
+    glStateBindFramebuffer(gpu.sceneFBO);
+    glStateViewport(0, 0, engine.screenWidth, engine.screenHeight);
+    glStateSetEnabled(GL_DEPTH_TEST, false);
+    glStateSetEnabled(GL_BLEND, false);
+    glStateUseProgram(gpu.basicShader);
+    setMat4(gpu.basicShader, "uModel", fill);
+    setMat4(gpu.basicShader, "uView", glm::mat4(1.0f));
+    setMat4(gpu.basicShader, "uProjection", glm::mat4(1.0f));
+    setVec3(gpu.basicShader, "uViewPos", glm::vec3(0.0f, 1.0f, 0.0f));
+    setInt(gpu.basicShader, "uUseTexture", 1);
+    setInt(gpu.basicShader, "uIsEmissive", 0);
+    setVec4(gpu.basicShader, "uColor", glm::vec4(1.0f));
+    setInt(gpu.basicShader, "uVertexPull", 0);
+    glStateBindVertexArray(gpu.VAOground);
+
+    const int rounds = 3;
+    const int draws = 16;
+    double ms[2] = { 1.0e9, 1.0e9 };  // Texture, procedural
+    for (int round = 0; round < rounds; round++) {
+        for (int path = 0; path < 2; path++) {
+            gpu.proceduralGround = path == 1;
+            ms[path] = (std::min)(ms[path], timeGroundDraws(engine, draws));
+        }
+    }
+    setInt(gpu.basicShader, "uSurface", 0);
+    glStateSetEnabled(GL_DEPTH_TEST, true);
+
+    gpu.proceduralGround = ms[1] < ms[0];
+    std::lock_guard<std::mutex> lock(reportMutex);
+    printf("Ground shading: %s (texture %.3f ms, procedural %.3f ms per screen)\n",
+        gpu.proceduralGround ? "procedural" : "texture", ms[0], ms[1]);
+}
+
+// ----- Scene Draw Batches -----
+/**
+ * Sends the pass's instances to the instance buffer; glBufferData gives it
+ * new storage, so the draws of the previous pass are not waited for
+ */
+void uploadInstances(RenderResources& gpu) {
+    const std::vector<glm::vec4>& instances = gpu.vertexPool.instances;
+    glBindBuffer(GL_TEXTURE_BUFFER, gpu.pullInstanceBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, instances.size() * sizeof(glm::vec4), instances.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Draws a batch of instances of mesh from the pool with basicShader, as one instanced draw
+void drawBatch(RenderResources& gpu, const SceneMesh& mesh, const DrawBatch& batch) {
+    if (batch.instanceCount == 0) return;
+    glStateBindVertexArray(gpu.VAOempty);
+    setInt(gpu.basicShader, "uInstanceBase", batch.firstInstance);
+    glDrawArraysInstanced(GL_TRIANGLES, mesh.pulled.first, mesh.pulled.count, batch.instanceCount);
+}
+
+// Draws mesh once from its VAO (vertex_pull = false); the caller sets uModel, uColor and uLayer
+void drawMesh(const SceneMesh& mesh) {
+    glStateBindVertexArray(mesh.vao);
+    if (mesh.indexed) glDrawElements(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT, 0);
+    else glDrawArrays(GL_TRIANGLES, 0, mesh.count);
+}
+
 // ==================== MAIN 3D SCENE RENDERING ====================
 /*
  * PHONG LIGHTING MODEL:
@@ -1512,338 +1496,846 @@ void setMaterialUniforms(unsigned int shader, const glm::vec3& ambient, const gl
  * @param projection - Projection matrix (perspective transformation)
  * @param viewPos - Camera world position (for specular calculation)
  */
-void renderScene(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos) {
-    glUseProgram(basicShader);
+void renderScene(Engine& engine, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos) {
+    WorldState& world = engine.world;
+    RenderResources& gpu = engine.gpu;
+
+    buildSceneTransforms(world.sceneTransforms, world.sceneEntities, viewPos, world.watchViewMode, world.groundOffset, world.cameraBobOffset);
+    profilerCount(COUNTER_RIG_TRANSFORMS, world.sceneEntities.rigMatricesUpdated);
+    const EntityStore& entities = world.sceneEntities.store;
+    entityCull(world.sceneEntities.store, projection * view);
+
+    // With vertex_pull, the per-object data of the pass goes into the instance
+    // array, one batch per mesh and material. Without it, every object sets
+    // its uniforms and is drawn on its own, straight from the entity data.
+    // Buildings outside the view frustum (e.g. wrapped behind the camera) are skipped.
+    DrawBatch ground, road, buildings, hand, watchFrame, watchScreen;
+    if (gpu.vertexPull) {
+        VertexPool& pool = gpu.vertexPool;
+        vertexPoolClearInstances(pool);
+        ground = vertexPoolBeginBatch(pool);
+        for (const glm::mat4& model : world.sceneTransforms.ground) vertexPoolAddInstance(pool, ground, model, glm::vec3(1.0f));
+        road = vertexPoolBeginBatch(pool);
+        for (const glm::mat4& model : world.sceneTransforms.road) vertexPoolAddInstance(pool, road, model, glm::vec3(1.0f));
+        buildings = vertexPoolBeginBatch(pool);
+        for (int i = 0; i < world.sceneEntities.buildingCount; i++) {
+            if (!(entities.flags[i] & ENTITY_VISIBLE)) continue;
+            vertexPoolAddInstance(pool, buildings, entities.model[i], entities.color[i], (float)entities.variant[i]);
+        }
+        auto single = [&](EntityId id) {
+            DrawBatch batch = vertexPoolBeginBatch(pool);
+            vertexPoolAddInstance(pool, batch, entities.model[id], entities.color[id]);
+            return batch;
+        };
+        hand = single(world.sceneEntities.hand);
+        watchFrame = single(world.sceneEntities.watchFrame);
+        watchScreen = single(world.sceneEntities.watchScreen);
+    }
+    auto drawEntity = [&](const SceneMesh& mesh, const DrawBatch& batch, EntityId id) {
+        if (gpu.vertexPull) {
+            drawBatch(gpu, mesh, batch);
+            return;
+        }
+        setVec4(gpu.basicShader, "uColor", glm::vec4(entities.color[id], 1.0f));
+        setMat4(gpu.basicShader, "uModel", entities.model[id]);
+        drawMesh(mesh);
+    };
+
+    glDebugPushGroup("renderScene");
+    glStateUseProgram(gpu.basicShader);
+    setInt(gpu.basicShader, "uVertexPull", gpu.vertexPull ? 1 : 0);
+    if (gpu.vertexPull) {
+        uploadInstances(gpu);
+        glStateBindTextureBuffer(VERTEX_BUFFER_UNIT, gpu.pullVertexTexture);
+        glStateBindTextureBuffer(INSTANCE_BUFFER_UNIT, gpu.pullInstanceTexture);
+    }
 
     // Set camera matrices for vertex transformation
-    setMat4(basicShader, "uView", view);
-    setMat4(basicShader, "uProjection", projection);
-    setVec3(basicShader, "uViewPos", viewPos);  // Needed for specular highlights
+    setMat4(gpu.basicShader, "uView", view);
+    setMat4(gpu.basicShader, "uProjection", projection);
+    setVec3(gpu.basicShader, "uViewPos", viewPos);  // Needed for specular highlights
 
-    // Calculate watch position for the screen light source
     // The watch acts as a weak light that illuminates nearby objects
-    glm::vec3 watchWorldPos;
-    if (watchViewMode) {
-        // In front of camera when viewing watch
-        watchWorldPos = viewPos + glm::vec3(0.0f, 0.0f, -0.5f);
-    }
-    else {
-        // To the right and below when running/walking
-        watchWorldPos = viewPos + glm::vec3(0.4f, -0.3f + cameraBobOffset, -0.3f);
-    }
-    setLightUniforms(basicShader, watchWorldPos);
+    setLightUniforms(gpu.basicShader, world.sceneTransforms.watchLightPos, world.sceneTransforms.streetLights);
 
     // ===== DRAW GROUND SEGMENTS =====
+    glDebugPushGroup("ground");
     // Ground uses grass material: moderate ambient, high diffuse, low specular (not shiny)
-    setMaterialUniforms(basicShader, glm::vec3(0.3f), glm::vec3(0.8f), glm::vec3(0.1f), 8.0f);
-    setInt(basicShader, "uUseTexture", 1);    // Enable texture sampling
-    setInt(basicShader, "uIsEmissive", 0);    // Ground receives lighting (not emissive)
-    setVec4(basicShader, "uColor", glm::vec4(1.0f));  // White = use texture color directly
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, groundTexture);
-    setInt(basicShader, "uTexture", 0);  // Texture unit 0
+    setMaterialUniforms(gpu.basicShader, glm::vec3(0.3f), glm::vec3(0.8f), glm::vec3(0.1f), 8.0f);
+    setInt(gpu.basicShader, "uUseTexture", 1);    // Enable texture sampling
+    setInt(gpu.basicShader, "uIsEmissive", 0);    // Ground receives lighting (not emissive)
+    setGroundSurface(gpu, GROUND_SURFACE_GRASS);
 
     // Render multiple ground segments to create infinite scrolling effect
-    // groundOffset moves them forward, creating illusion of movement
-    glBindVertexArray(VAOground);
-    for (int i = 0; i < NUM_GROUND_SEGMENTS; i++) {
-        glm::mat4 model = glm::mat4(1.0f);
-        // Each segment is placed behind the previous one
-        model = glm::translate(model, glm::vec3(0.0f, 0.0f, groundOffset - i * GROUND_SEGMENT_LENGTH));
-        setMat4(basicShader, "uModel", model);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (gpu.vertexPull) drawBatch(gpu, gpu.groundMesh, ground);
+    else {
+        setVec4(gpu.basicShader, "uColor", glm::vec4(1.0f));  // White = use texture color directly
+        for (const glm::mat4& model : world.sceneTransforms.ground) {
+            setMat4(gpu.basicShader, "uModel", model);
+            drawMesh(gpu.groundMesh);
+        }
     }
+    glDebugPopGroup();
 
     // ===== DRAW ROAD =====
-    // Road is rendered slightly above ground (Y=0.01) to prevent z-fighting
-    glBindTexture(GL_TEXTURE_2D, roadTexture);
-    for (int i = 0; i < NUM_GROUND_SEGMENTS; i++) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(0.0f, 0.01f, groundOffset - i * GROUND_SEGMENT_LENGTH));
-        model = glm::scale(model, glm::vec3(ROAD_WIDTH / 100.0f, 1.0f, 1.0f));  // Scale width
-        setMat4(basicShader, "uModel", model);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glDebugPushGroup("road");
+    setGroundSurface(gpu, GROUND_SURFACE_ROAD);
+    if (gpu.vertexPull) drawBatch(gpu, gpu.groundMesh, road);
+    else {
+        for (const glm::mat4& model : world.sceneTransforms.road) {
+            setMat4(gpu.basicShader, "uModel", model);
+            drawMesh(gpu.groundMesh);
+        }
     }
+    setInt(gpu.basicShader, "uSurface", 0);
+    glDebugPopGroup();
 
     // ===== DRAW BUILDINGS =====
+    glDebugPushGroup("buildings");
     // Buildings use slightly shiny material (concrete/plaster look)
-    setMaterialUniforms(basicShader, glm::vec3(0.2f), glm::vec3(0.7f), glm::vec3(0.3f), 16.0f);
-    glBindTexture(GL_TEXTURE_2D, buildingTexture);
-    glBindVertexArray(VAOcube);
-
-    for (const auto& building : buildings) {
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::vec3 pos = building.position;
-        pos.z += groundOffset;  // Move with ground scrolling
-
-        // INFINITE SCROLLING: Wrap buildings when they go too far
-        // This creates the illusion of endless buildings along the road
-        while (pos.z > 10.0f) pos.z -= NUM_GROUND_SEGMENTS * GROUND_SEGMENT_LENGTH;
-        while (pos.z < -NUM_GROUND_SEGMENTS * GROUND_SEGMENT_LENGTH) pos.z += NUM_GROUND_SEGMENTS * GROUND_SEGMENT_LENGTH;
+    setEntityMaterial(gpu.basicShader, MATERIAL_BUILDING);
+    glStateBindTextureArray(TEXTURE_ARRAY_UNIT, gpu.buildingTexture);
+    setInt(gpu.basicShader, "uUseTextureArray", 1);
 
-        // Position building: Y is half-height because cube is centered at origin
-        model = glm::translate(model, glm::vec3(pos.x, building.scale.y / 2.0f, pos.z));
-        model = glm::scale(model, building.scale);
-        setMat4(basicShader, "uModel", model);
-        setVec4(basicShader, "uColor", glm::vec4(building.color, 1.0f));
-        glDrawArrays(GL_TRIANGLES, 0, 36);  // 36 vertices = 6 faces * 2 triangles * 3 vertices
+    // The facade is a layer of the one bound array, per instance: no bind between buildings
+    if (gpu.vertexPull) drawBatch(gpu, gpu.cubeMesh, buildings);
+    else {
+        for (int i = 0; i < world.sceneEntities.buildingCount; i++) {
+            if (!(entities.flags[i] & ENTITY_VISIBLE)) continue;
+            setMat4(gpu.basicShader, "uModel", entities.model[i]);
+            setVec4(gpu.basicShader, "uColor", glm::vec4(entities.color[i], 1.0f));
+            setFloat(gpu.basicShader, "uLayer", (float)entities.variant[i]);
+            drawMesh(gpu.cubeMesh);
+        }
     }
+    setInt(gpu.basicShader, "uUseTextureArray", 0);
+    glDebugPopGroup();
 
     // ===== DRAW HAND =====
+    glDebugPushGroup("hand");
     // Hand uses skin-tone color, no texture, slightly subsurface-scatter look
-    setInt(basicShader, "uUseTexture", 0);  // Disable texture, use solid color
-    setMaterialUniforms(basicShader, glm::vec3(0.3f), glm::vec3(0.8f, 0.6f, 0.5f), glm::vec3(0.2f), 8.0f);
-    setVec4(basicShader, "uColor", glm::vec4(0.9f, 0.75f, 0.65f, 1.0f));  // Skin tone
-
-    glm::mat4 handModel = glm::mat4(1.0f);
-    if (watchViewMode) {
-        // Hand raised in front of face to look at watch
-        handModel = glm::translate(handModel, viewPos + glm::vec3(0.0f, -0.3f, -0.6f));
-        handModel = glm::rotate(handModel, glm::radians(-30.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-    }
-    else {
-        // Hand at side with watch, angled naturally
-        // cameraBobOffset makes hand bob while running
-        handModel = glm::translate(handModel, viewPos + glm::vec3(0.4f, -0.4f + cameraBobOffset * 0.5f, -0.3f));
-        handModel = glm::rotate(handModel, glm::radians(-45.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        handModel = glm::rotate(handModel, glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    }
-    // Scale cube to hand/forearm proportions
-    handModel = glm::scale(handModel, glm::vec3(0.08f, 0.4f, 0.15f));
-    setMat4(basicShader, "uModel", handModel);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    setInt(gpu.basicShader, "uUseTexture", 0);  // Disable texture, use solid color
+    setEntityMaterial(gpu.basicShader, MATERIAL_SKIN);
+    drawEntity(gpu.cubeMesh, hand, world.sceneEntities.hand);
+    glDebugPopGroup();
 
     // ===== DRAW WATCH FRAME (BEZEL) =====
+    glDebugPushGroup("watch frame");
     // Dark metallic frame around the screen
-    setVec4(basicShader, "uColor", glm::vec4(0.2f, 0.2f, 0.25f, 1.0f));  // Dark gray
     // High specular, high shininess = metallic appearance
-    setMaterialUniforms(basicShader, glm::vec3(0.1f), glm::vec3(0.3f), glm::vec3(0.8f), 64.0f);
-
-    glm::mat4 watchFrameModel = glm::mat4(1.0f);
-    if (watchViewMode) {
-        watchFrameModel = glm::translate(watchFrameModel, viewPos + glm::vec3(0.0f, 0.0f, -0.5f));
-    }
-    else {
-        watchFrameModel = glm::translate(watchFrameModel, viewPos + glm::vec3(0.4f, -0.3f + cameraBobOffset, -0.3f));
-        watchFrameModel = glm::rotate(watchFrameModel, glm::radians(-45.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        watchFrameModel = glm::rotate(watchFrameModel, glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    }
-    watchFrameModel = glm::scale(watchFrameModel, glm::vec3(0.35f, 0.35f, 0.03f));
-    setMat4(basicShader, "uModel", watchFrameModel);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    setEntityMaterial(gpu.basicShader, MATERIAL_WATCH_FRAME);
+    drawEntity(gpu.cubeMesh, watchFrame, world.sceneEntities.watchFrame);
+    glDebugPopGroup();
 
     // ===== DRAW WATCH SCREEN (EMISSIVE SURFACE) =====
+    glDebugPushGroup("watch screen");
     // The watch screen is EMISSIVE - it emits light rather than receiving it
     // This makes it always fully visible regardless of lighting conditions
     // (like a real LCD/OLED screen that produces its own light)
-    setInt(basicShader, "uUseTexture", 1);
-    setInt(basicShader, "uIsEmissive", 1);  // KEY: Shader outputs texture color directly, no lighting
-    setVec4(basicShader, "uColor", glm::vec4(1.0f));
+    setInt(gpu.basicShader, "uUseTexture", 1);
+    setInt(gpu.basicShader, "uIsEmissive", 1);  // KEY: Shader outputs texture color directly, no lighting
 
     // Bind the FBO texture that contains the rendered watch UI
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, watchScreenTexture);  // This is our FBO color attachment
+    glStateBindTexture(0, watchSurfaceTexture(engine));  // FBO color attachment (or the panel format copy)
+    drawEntity(gpu.watchQuadMesh, watchScreen, world.sceneEntities.watchScreen);
 
-    glm::mat4 watchModel = glm::mat4(1.0f);
-    if (watchViewMode) {
-        // Directly in front of camera, facing viewer
-        watchModel = glm::translate(watchModel, viewPos + glm::vec3(0.0f, 0.0f, -0.48f));
-    }
-    else {
-        // On wrist at side, angled to match hand/frame orientation
-        // Z is -0.28 (slightly in front of frame at -0.3)
-        watchModel = glm::translate(watchModel, viewPos + glm::vec3(0.4f, -0.3f + cameraBobOffset, -0.28f));
-        watchModel = glm::rotate(watchModel, glm::radians(-45.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        watchModel = glm::rotate(watchModel, glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    }
-    setMat4(basicShader, "uModel", watchModel);
+    // Reset emissive flag for next frame
+    setInt(gpu.basicShader, "uIsEmissive", 0);
+    glDebugPopGroup();
+    glDebugPopGroup();  // renderScene
+}
 
-    glBindVertexArray(VAOwatchQuad);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+/**
+ * Renders the 3D scene at the --capture-size resolution, which may be far
+ * larger than any framebuffer, in tiles of the capture framebuffer's size
+ * Every tile gets the off-center slice of the full view frustum that covers
+ * its pixels, so the tiles line up exactly (and culling works per tile).
+ * A row of tiles is read back into one band and streamed to the PNG before
+ * the next row is rendered: memory is one band (width x tile height RGB)
+ * whatever the output height. The student info overlay is screen space and
+ * is left out.
+ */
+void saveTiledCapture(Engine& engine, const char* path, const glm::mat4& view) {
+    RenderResources& gpu = engine.gpu;
+    const EngineOptions& options = *engine.options;
+    int width = options.tiledWidth;
+    int height = options.tiledHeight;
+    int tileWidth = engine.screenWidth;
+    int tileHeight = engine.screenHeight;
+
+    PngWriter writer;
+    if (!writer.open(path, width, height, 3)) return;
+    std::vector<unsigned char> band((size_t)width * tileHeight * 3);
+
+    // Full frustum at the near plane; the aspect is the output's, not the tile's
+    float nearPlane = CAMERA_NEAR_PLANE;
+    float top = nearPlane * tanf(glm::radians(options.config.fovDegrees) * 0.5f);
+    float right = top * (float)width / (float)height;
+
+    glStateBindFramebuffer(gpu.sceneFBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, width);  // Tiles land side by side in the band
+
+    int tiles = 0;
+    for (int y0 = 0; y0 < height; y0 += tileHeight) {
+        int h = (std::min)(tileHeight, height - y0);
+        for (int x0 = 0; x0 < width; x0 += tileWidth) {
+            int w = (std::min)(tileWidth, width - x0);
+
+            // Image rows run top down, frustum y bottom up
+            glm::mat4 projection = glm::frustum(
+                -right + 2.0f * right * x0 / width, -right + 2.0f * right * (x0 + w) / width,
+                top - 2.0f * top * (y0 + h) / height, top - 2.0f * top * y0 / height,
+                nearPlane, options.config.farPlane);
+
+            glStateViewport(0, 0, w, h);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            renderScene(engine, view, projection, engine.world.cameraPos);
+            glStateBindFramebuffer(gpu.sceneFBO);
+            glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, band.data() + (size_t)x0 * 3);
+            tiles++;
+        }
 
-    // Reset emissive flag for next frame
-    setInt(basicShader, "uIsEmissive", 0);
-    glBindVertexArray(0);
+        // Read back bottom up
+        for (int row = h - 1; row >= 0; row--) writer.writeRow(band.data() + (size_t)row * width * 3);
+    }
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glStateViewport(0, 0, engine.screenWidth, engine.screenHeight);
+
+    if (writer.close()) {
+        std::cout << "Saved capture: " << path << " (" << width << "x" << height << ", " << tiles << " tiles)" << std::endl;
+    }
 }
 
-void renderStudentInfo() {
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void renderStudentInfo(Engine& engine) {
+    RenderResources& gpu = engine.gpu;
+
+    glDebugPushGroup("renderStudentInfo");
+    glStateSetEnabled(GL_DEPTH_TEST, false);
+    glStateSetEnabled(GL_BLEND, true);
+    glStateBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     float infoW = 0.20f;
     float infoH = 0.06f;
     float infoX = 0.79f;
     float infoY = 0.93f;
 
-    drawScreenQuad(screenShader, infoX, infoY, infoW, infoH, 1.0f, 1.0f, 1.0f, 1.0f, studentInfoTexture);
-
-    if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
+    // Not worth delaying the first frame for; shows up as soon as it is generated
+    unsigned int texture = getLazyTexture(gpu.studentInfoTexture, gpu.studentInfoJob, false);
+    if (texture != 0) drawScreenQuad(gpu, infoX, infoY, infoW, infoH, 1.0f, 1.0f, 1.0f, 1.0f, texture);
+    glDebugPopGroup();
 }
 
 // ==================== MAIN FUNCTION ====================
 
-int main()
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+/**
+ * Parses command line options
+ *   --benchmark-frames N   Run N measured frames without the frame limiter, then exit
+ *   --benchmark-out FILE   Where to write the benchmark JSON (default benchmark.json)
+ *   --no-gl-trace          Keep GL call counting off at runtime
+ *   --scenario NAME        Start from a fixed scenario with a fixed timestep
+ *   --capture FILE         Render offscreen and save the last measured frame as PNG
+ *   --size WxH             Headless/capture and windowed resolution (default 640x360)
+ *   --capture-size WxH     Capture at WxH (any size) by rendering tiles of --size
+ *   --headless             Render offscreen in a hidden window without saving a capture
+ *   --config FILE          Read runtime settings from a file (see Config.h), before all other options
+ *   --set KEY=VALUE        Set one runtime setting (target_fps, fov, far_plane, building_spacing, watch_ui, ...)
+ *   --quality NAME         Quality tier: low, medium (default) or high
+ *   --windowed             Window of --size instead of fullscreen (same as --set fullscreen=false)
+ *   --buildings N          Buildings per road side (same as --set buildings=N)
+ *   --ground-segments N    Ground/road segments (same as --set ground_segments=N)
+ *   --watch-size N         Watch screen texture resolution (same as --set watch_screen_size=N)
+ *   --lights N             Street lights, 0 to MAX_STREET_LIGHTS (same as --set lights=N)
+ *   --eager-init           Create the lazily created textures before the first frame too
+ *   --require-zero-alloc   Exit with code 3 if any measured frame made a heap allocation
+ *   --telemetry            Publish live frame stats to shared memory for TelemetryViewer
+ *   --instances N          Run N headless engines side by side, each on its own thread
+ *                          and GL context; outputs get the instance number (run.json ->
+ *                          run.0.json, run.1.json, ...)
+ */
+void parseArguments(int argc, char** argv, EngineOptions& options) {
+    // The config file comes first so every command line setting overrides it
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0) configLoadFile(options.config, argv[i + 1]);
+    }
 
-    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
-    const GLFWvidmode* mode = glfwGetVideoMode(monitor);
-    screenWidth = mode->width;
-    screenHeight = mode->height;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            i++;  // Already read
+        }
+        else if (strcmp(argv[i], "--benchmark-frames") == 0 && i + 1 < argc) {
+            options.benchmarkFrames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--benchmark-out") == 0 && i + 1 < argc) {
+            options.benchmarkOutPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--no-gl-trace") == 0) {
+            glTraceSetEnabled(false);
+        }
+        else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (const Scenario& scenario : SCENARIOS) {
+                if (strcmp(scenario.name, name) == 0) options.scenario = &scenario;
+            }
+            if (options.scenario == NULL) std::cout << "Unknown scenario: " << name << std::endl;
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            options.capturePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &options.captureWidth, &options.captureHeight) != 2) {
+                std::cout << "Invalid size: " << argv[i] << std::endl;
+            }
+        }
+        else if (strcmp(argv[i], "--capture-size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &options.tiledWidth, &options.tiledHeight) != 2 ||
+                options.tiledWidth <= 0 || options.tiledHeight <= 0) {
+                std::cout << "Invalid capture size: " << argv[i] << std::endl;
+                options.tiledWidth = options.tiledHeight = 0;
+            }
+        }
+        else if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        }
+        else if (strcmp(argv[i], "--set") == 0 && i + 1 < argc) {
+            configSetPair(options.config, argv[++i]);
+        }
+        else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            configSet(options.config, "quality", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--windowed") == 0) {
+            options.config.fullscreen = false;
+        }
+        else if (strcmp(argv[i], "--buildings") == 0 && i + 1 < argc) {
+            configSet(options.config, "buildings", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ground-segments") == 0 && i + 1 < argc) {
+            configSet(options.config, "ground_segments", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--watch-size") == 0 && i + 1 < argc) {
+            configSet(options.config, "watch_screen_size", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+            configSet(options.config, "lights", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--eager-init") == 0) {
+            options.eagerInit = true;
+        }
+        else if (strcmp(argv[i], "--require-zero-alloc") == 0) {
+            options.requireZeroAlloc = true;
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0) {
+            options.telemetry = true;
+        }
+        else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+            options.instances = (std::min)((std::max)(1, atoi(argv[++i])), MAX_INSTANCES);
+        }
+        else {
+            std::cout << "Unknown argument: " << argv[i] << std::endl;
+        }
+    }
 
-    GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "SmartWatch 3D - Nikola Bandulaja SV74/2022", monitor, NULL);
-    if (window == NULL) return endProgram("Failed to create window.");
-    glfwMakeContextCurrent(window);
+    if (options.tiledWidth > 0 && options.capturePath == NULL) {
+        std::cout << "--capture-size needs --capture" << std::endl;
+        options.tiledWidth = options.tiledHeight = 0;
+    }
 
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    // Scenarios (and captures) always run a fixed number of measured frames
+    if (options.capturePath != NULL) options.headless = true;
+    if ((options.scenario != NULL || options.capturePath != NULL) && options.benchmarkFrames == 0) {
+        options.benchmarkFrames = SCENARIO_FRAMES;
+    }
 
-    glfwSetMouseButtonCallback(window, mouse_button_callback);
-    glfwSetCursorPosCallback(window, cursor_position_callback);
-    glfwSetKeyCallback(window, key_callback);
+    // Only one window can take the screen and the keyboard
+    if (options.instances > 1 && !options.headless) {
+        std::cout << "--instances needs --headless or --capture; running one instance" << std::endl;
+        options.instances = 1;
+    }
 
-    if (glewInit() != GLEW_OK) return endProgram("Failed to initialize GLEW.");
+    configValidate(options.config);
+    configApplyScene(options.config);
+    configReport(options.config);
+}
 
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    std::cout << "Controls:" << std::endl;
-    std::cout << "  Mouse: Look up/down" << std::endl;
-    std::cout << "  SPACE: Toggle watch view mode" << std::endl;
-    std::cout << "  D (hold): Simulate running (on heart rate screen)" << std::endl;
-    std::cout << "  F1: Toggle depth testing" << std::endl;
-    std::cout << "  F2: Toggle face culling" << std::endl;
-    std::cout << "  ESC: Exit" << std::endl;
+/**
+ * Puts the simulation into the active scenario's fixed starting state
+ */
+void applyScenario(Engine& engine, const Scenario& scenario) {
+    WorldState& world = engine.world;
+    InputState& input = engine.input;
+
+    world.currentScreen = scenario.screen;
+    world.watchViewMode = scenario.watchView;
+    world.batteryPercent = scenario.battery;
+    world.hours = 10;
+    world.minutes = 8;
+    world.seconds = 30;
+    world.bpm = 70.0f;
+    world.targetBpm = 70.0f;
+    world.ekgOffset = 0.0f;
+    world.ekgScale = 1.0f;
+    world.cameraBasePitch = 0.0f;
+    // Park the heart cursor outside the watch screen
+    input.mouseX = -10000.0;
+    input.mouseY = -10000.0;
+}
+
+/**
+ * Sets the clock display to the current local time
+ */
+void initClock(WorldState& world) {
+    time_t now = time(NULL);
+    struct tm* local = localtime(&now);
+    world.hours = local->tm_hour;
+    world.minutes = local->tm_min;
+    world.seconds = local->tm_sec;
+}
+
+/**
+ * Output file of an instance: the path itself when only one engine runs,
+ * otherwise with the instance number before the extension (run.json -> run.1.json)
+ */
+std::string instancePath(const Engine& engine, const char* path) {
+    std::string result = path;
+    if (engine.options->instances <= 1) return result;
+
+    std::string suffix = "." + std::to_string(engine.instance);
+    size_t dot = result.find_last_of('.');
+    size_t slash = result.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return result + suffix;
+    return result.insert(dot, suffix);
+}
+
+/**
+ * Creates the engine's window and GL context and routes its input callbacks
+ * to the engine. GLFW only allows this on the main thread.
+ */
+bool createEngineWindow(Engine& engine) {
+    const EngineOptions& options = *engine.options;
+
+    GLFWmonitor* monitor = NULL;
+    if (options.headless) {
+        // Headless: hidden window, fixed resolution, offscreen target
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        engine.screenWidth = options.captureWidth;
+        engine.screenHeight = options.captureHeight;
+    }
+    else if (options.config.fullscreen) {
+        int monitorCount = 0;
+        GLFWmonitor** monitors = glfwGetMonitors(&monitorCount);
+        if (options.config.monitor < monitorCount) monitor = monitors[options.config.monitor];
+        else {
+            std::cout << "Monitor " << options.config.monitor << " not found, using the primary monitor" << std::endl;
+            monitor = glfwGetPrimaryMonitor();
+        }
+        const GLFWvidmode* mode = glfwGetVideoMode(monitor);
+        engine.screenWidth = mode->width;
+        engine.screenHeight = mode->height;
+    }
+    else {
+        engine.screenWidth = options.captureWidth;
+        engine.screenHeight = options.captureHeight;
+    }
+
+    engine.window = glfwCreateWindow(engine.screenWidth, engine.screenHeight, "SmartWatch 3D - Nikola Bandulaja SV74/2022", monitor, NULL);
+    if (engine.window == NULL) return false;
 
-    // Create shaders
-    basicShader = createShader("basic.vert", "basic.frag");
-    screenShader = createShader("screen.vert", "screen.frag");
-
-    // Create VAOs
-    createGroundVAO();
-    createCubeVAO();
-    createWatchQuadVAO();
-    createScreenQuadVAO();
-    createHandVAO();
-
-    // Create textures
-    groundTexture = createGroundTexture();
-    roadTexture = createRoadTexture();
-    buildingTexture = createBuildingTexture();
-    ekgTexture = createEKGTexture();
-    arrowRightTexture = createArrowTexture(true);
-    arrowLeftTexture = createArrowTexture(false);
-    heartCursorTexture = createHeartTexture();
-    studentInfoTexture = createStudentInfoTexture();
-
-    // Create framebuffer for watch screen
-    createWatchFramebuffer();
-
-    // Generate buildings
-    generateBuildings();
-
-    // Initialize timing
-    srand((unsigned)time(NULL));
+    glfwSetWindowUserPointer(engine.window, &engine);
+    if (!options.headless) glfwSetInputMode(engine.window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    glfwSetMouseButtonCallback(engine.window, mouse_button_callback);
+    glfwSetCursorPosCallback(engine.window, cursor_position_callback);
+    glfwSetKeyCallback(engine.window, key_callback);
+    return true;
+}
+
+/**
+ * Creates the engine's GL resources, runs its frame loop until the window
+ * closes (or the benchmark frames are done) and releases everything again.
+ * The engine's context must be current on the calling thread.
+ *
+ * @return Exit code of this engine (3 = heap allocations in measured frames
+ *         with --require-zero-alloc)
+ */
+int runEngine(Engine& engine) {
+    const EngineOptions& options = *engine.options;
+    WorldState& world = engine.world;
+    InputState& input = engine.input;
+    RenderResources& gpu = engine.gpu;
+    GLFWwindow* window = engine.window;
+
+    if (options.benchmarkFrames > 0) glfwSwapInterval(0);
+    glDebugInit();
+
+    // Everything the first frame needs, in dependency order. EKG, heart and
+    // student info textures are not here: they are created on first use.
+    std::vector<StartupStep> startupSteps = {
+        { "shaders", {}, [&gpu, &options]() {
+            const SamplerUnit basicSamplers[] = {
+                { "uTextureArray", TEXTURE_ARRAY_UNIT },
+                { "uVertices", VERTEX_BUFFER_UNIT },
+                { "uInstances", INSTANCE_BUFFER_UNIT },
+            };
+            gpu.basicShader = GlProgram(createShader("basic.vert", "basic.frag",
+                basicSamplers, (int)(sizeof(basicSamplers) / sizeof(basicSamplers[0]))));
+            gpu.screenShader = GlProgram(createShader("screen.vert", "screen.frag"));
+            gpuResourceSetLabel(GPU_RES_PROGRAM, gpu.basicShader, "basic");
+            gpuResourceSetLabel(GPU_RES_PROGRAM, gpu.screenShader, "screen");
+            if (options.config.displayFormat != DISPLAY_RGB888 && !options.config.softWatchUi) {
+                gpu.displayShader = GlProgram(createShader("screen.vert", "display.frag"));
+                gpuResourceSetLabel(GPU_RES_PROGRAM, gpu.displayShader, "display");
+            }
+        } },
+        { "vaos", {}, [&gpu, &options]() {
+            createGroundVAO(gpu);
+            createCubeVAO(gpu);
+            createWatchQuadVAO(gpu);
+            createScreenQuadVAO(gpu);
+            createHandVAO(gpu);
+            createVertexPullBuffers(gpu, options.config.vertexPull);
+        } },
+        { "scene_textures", {}, [&gpu]() {
+            gpu.groundTexture = finishTextureJob(gpu.groundJob);
+            gpu.roadTexture = finishTextureJob(gpu.roadJob);
+            gpu.buildingTexture = finishTextureArrayJob(gpu.buildingJob, BUILDING_FACADES);
+        } },
+        { "ui_textures", {}, [&gpu]() {
+            gpu.arrowRightTexture = finishTextureJob(gpu.arrowRightJob);
+            gpu.arrowLeftTexture = finishTextureJob(gpu.arrowLeftJob);
+            gpu.perfTextTexture = createDynamicTexture(PERF_TEXT_WIDTH, PERF_TEXT_HEIGHT, "perf_text");
+            gpu.perfGraphTexture = createDynamicTexture(PERF_GRAPH_WIDTH, PERF_GRAPH_HEIGHT, "perf_graph");
+            gpu.perfText = { PERF_TEXT_WIDTH, PERF_TEXT_HEIGHT, 4, {} };
+            gpu.perfText.pixels.resize((size_t)PERF_TEXT_WIDTH * PERF_TEXT_HEIGHT * 4);
+            gpu.perfGraph = { PERF_GRAPH_WIDTH, PERF_GRAPH_HEIGHT, 4, {} };
+            gpu.perfGraph.pixels.resize((size_t)PERF_GRAPH_WIDTH * PERF_GRAPH_HEIGHT * 4);
+            reserveDigitTextures(gpu);
+            gpu.watchUiQuads.reserve(SOFT_RASTER_MAX_QUADS);
+        } },
+        { "soft_watch_ui", {}, [&gpu, &options]() {
+            if (options.config.softWatchUi) softWatchUiInit(gpu.softWatchUi, options.config.watchUiThreads);
+        } },
+        { "display_link", {}, [&gpu, &options]() {
+            if (!options.config.displayLink) return;
+            int size = options.config.watchScreenSize;
+            int channels = options.config.displayFormat == DISPLAY_RGB888 ? 4 : 2;
+            displayLinkInit(gpu.displayLink, size, channels, options.config.displayBusMHz);
+            if (!options.config.softWatchUi) {
+                gpu.watchReadback = { size, size, channels, {} };
+                gpu.watchReadback.pixels.resize((size_t)size * size * channels);
+            }
+        } },
+        { "framebuffers", {}, [&engine, &gpu, &options]() {
+            createWatchFramebuffer(gpu, options.config.watchScreenSize);
+            if (options.config.displayFormat != DISPLAY_RGB888) {
+                createDisplayFramebuffer(gpu, options.config.watchScreenSize, options.config.displayFormat,
+                    options.config.displayDither);
+            }
+            if (options.headless) createCaptureFramebuffer(gpu, engine.screenWidth, engine.screenHeight);
+        } },
+        { "ground_shading", { "shaders", "vaos", "scene_textures", "framebuffers" }, [&engine]() {
+            chooseGroundShading(engine);
+        } },
+        // The ground/road job calls rand() on its worker; the building layout
+        // reseeds it, so it has to wait for that job
+        { "buildings", { "scene_textures" }, [&world]() {
+            generateSceneEntities(world.sceneEntities);
+        } },
+        { "profiler", {}, []() {
+            profilerInit();  // GPU timer queries for the performance screen
+            frameArenaInit(FRAME_ARENA_SIZE);
+        } },
+        { "telemetry", { "profiler" }, [&engine, &options]() {
+            // One shared memory block per process: only the first engine publishes
+            if (options.telemetry && engine.instance == 0) profilerStartTelemetry((float)(configFrameTime(options.config) * 1000.0));
+        } },
+    };
+    if (options.eagerInit) {
+        // Old behavior, for comparing time-to-first-frame
+        startupSteps.push_back({ "lazy_textures", {}, [&gpu]() { finishLazyTextures(gpu); } });
+    }
+    startupRunSteps(startupSteps);
+
+    // Initialize timing (scenarios use a fixed seed so runs are reproducible)
+    if (options.scenario != NULL) {
+        applyScenario(engine, *options.scenario);
+        srand(1);
+    }
+    else {
+        srand((unsigned)time(NULL));
+    }
     double lastTime = glfwGetTime();
-    lastSecondTime = lastTime;
-    lastBatteryDrain = lastTime;
+    world.lastSecondTime = lastTime;
+    world.lastBatteryDrain = lastTime;
 
     glClearColor(0.4f, 0.6f, 0.9f, 1.0f);
 
+    int frameCount = 0;
+    const double frameTime = configFrameTime(options.config);  // Frame limiter and scenario timestep
+
     while (!glfwWindowShouldClose(window))
     {
         double currentTime = glfwGetTime();
         double deltaTime = currentTime - lastTime;
 
-        // Frame limiter
-        if (deltaTime < TARGET_FRAME_TIME) {
-            double sleepTime = TARGET_FRAME_TIME - deltaTime;
+        // Scenarios advance simulated time by exactly one frame budget
+        if (options.scenario != NULL) {
+            currentTime = lastTime + frameTime;
+            deltaTime = frameTime;
+        }
+
+        // Benchmark runs record a fixed number of frames after the warmup
+        if (options.benchmarkFrames > 0) {
+            if (frameCount == BENCHMARK_WARMUP_FRAMES) {
+                // Measured frames and captures must not depend on worker timing
+                finishLazyTextures(gpu);
+                displayLinkResetStats(gpu.displayLink);
+                gpu.softWatchUiMs = 0.0;
+                gpu.softWatchUiFrames = 0;
+                profilerSetRecording(true);
+            }
+            if (frameCount == BENCHMARK_WARMUP_FRAMES + options.benchmarkFrames) {
+                profilerSetRecording(false);
+                glfwSetWindowShouldClose(window, true);
+                continue;
+            }
+        }
+        frameCount++;
+
+        // Frame limiter (off while benchmarking so frame time reflects the work)
+        if (options.benchmarkFrames == 0 && deltaTime < frameTime) {
+            double sleepTime = frameTime - deltaTime;
             std::this_thread::sleep_for(std::chrono::microseconds((int)(sleepTime * 1000000)));
             currentTime = glfwGetTime();
             deltaTime = currentTime - lastTime;
         }
         lastTime = currentTime;
 
-        // Check running state
-        isRunning = (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) && (currentScreen == 1);
+        profilerBeginFrame();
+        frameArenaBeginFrame();
+        unsigned int heapAllocsAtFrameStart = heapAllocationCount();
+
+        // Check running state (GLFW only lets the main thread read the keyboard)
+        bool runKeyHeld = engine.mainThread && glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+        if (options.scenario != NULL && options.scenario->running) runKeyHeld = true;
+        world.isRunning = runKeyHeld && (world.currentScreen == 1);
 
         // Update state
-        updateClock(currentTime);
-        updateHeartRate(deltaTime);
-        updateBattery(currentTime);
-        updateRunning(deltaTime);
+        updateClock(world, currentTime);
+        updateHeartRate(world, deltaTime);
+        updateBattery(world, currentTime);
+        updateRunning(world, deltaTime);
 
         // Update camera
-        cameraPitch = cameraBasePitch + cameraBobOffset * 100.0f;
-        cameraPos.y = 1.6f + cameraBobOffset;
+        world.cameraPitch = world.cameraBasePitch + world.cameraBobOffset * 100.0f;
+        world.cameraPos.y = 1.6f + world.cameraBobOffset;
 
         // Render watch screen to FBO
-        renderWatchScreen();
+        renderWatchScreen(engine);
 
         // Render 3D scene
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, screenWidth, screenHeight);
-
-        if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
-        else glDisable(GL_DEPTH_TEST);
+        glStateBindFramebuffer(gpu.sceneFBO);
+        glStateViewport(0, 0, engine.screenWidth, engine.screenHeight);
 
-        if (faceCullingEnabled) {
-            glEnable(GL_CULL_FACE);
-            glFrontFace(GL_CCW);
-            glCullFace(GL_BACK);
-        }
-        else {
-            glDisable(GL_CULL_FACE);
-        }
+        // Only changes reach GL: these are no-ops unless F1/F2 were pressed
+        glStateSetEnabled(GL_DEPTH_TEST, input.depthTestEnabled);
+        glStateSetEnabled(GL_CULL_FACE, input.faceCullingEnabled);
+        glStateFrontFace(GL_CCW);
+        glStateCullFace(GL_BACK);
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // Camera matrices
         glm::vec3 cameraFront;
-        cameraFront.x = cos(glm::radians(cameraYaw)) * cos(glm::radians(cameraPitch));
-        cameraFront.y = sin(glm::radians(cameraPitch));
-        cameraFront.z = sin(glm::radians(cameraYaw)) * cos(glm::radians(cameraPitch));
+        cameraFront.x = cos(glm::radians(world.cameraYaw)) * cos(glm::radians(world.cameraPitch));
+        cameraFront.y = sin(glm::radians(world.cameraPitch));
+        cameraFront.z = sin(glm::radians(world.cameraYaw)) * cos(glm::radians(world.cameraPitch));
         cameraFront = glm::normalize(cameraFront);
 
-        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 projection = glm::perspective(glm::radians(60.0f), (float)screenWidth / (float)screenHeight, 0.1f, 200.0f);
+        glm::mat4 view = glm::lookAt(world.cameraPos, world.cameraPos + cameraFront, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(options.config.fovDegrees), (float)engine.screenWidth / (float)engine.screenHeight,
+            CAMERA_NEAR_PLANE, options.config.farPlane);
 
-        renderScene(view, projection, cameraPos);
+        profilerBeginGpuPass(GPU_PASS_SCENE);
+        renderScene(engine, view, projection, world.cameraPos);
+        profilerEndGpuPass(GPU_PASS_SCENE);
 
         // Render student info overlay
-        glViewport(0, 0, screenWidth, screenHeight);
-        renderStudentInfo();
+        profilerBeginGpuPass(GPU_PASS_OVERLAY);
+        glStateViewport(0, 0, engine.screenWidth, engine.screenHeight);
+        renderStudentInfo(engine);
+        profilerEndGpuPass(GPU_PASS_OVERLAY);
+
+        input.mouseClicked = false;
 
-        mouseClicked = false;
+        profilerCount(COUNTER_HEAP_ALLOCS, heapAllocationCount() - heapAllocsAtFrameStart);
+        profilerEndFrame();
+
+        // Read back outside the measured frame
+        if (options.capturePath != NULL && frameCount == BENCHMARK_WARMUP_FRAMES + options.benchmarkFrames) {
+            std::string path = instancePath(engine, options.capturePath);
+            if (options.tiledWidth > 0) saveTiledCapture(engine, path.c_str(), view);
+            else saveCapture(engine, path.c_str());
+        }
 
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (engine.mainThread) glfwPollEvents();
+
+        if (frameCount == 1) {
+            startupMark("first_frame");
+            engine.startupMs = startupTotalMs();
+            std::lock_guard<std::mutex> lock(reportMutex);
+            startupReport();
+        }
+    }
+
+    if (options.benchmarkFrames > 0) {
+        BenchmarkRunInfo info;
+        info.scenario = options.scenario != NULL ? options.scenario->name : "default";
+        info.renderer = (const char*)glGetString(GL_RENDERER);
+        info.startupMs = engine.startupMs;
+        info.config = &options.config;
+        info.display = options.config.displayLink ? &gpu.displayLink : NULL;
+        info.groundShading = gpu.proceduralGround ? "procedural" : "texture";
+        info.watchUiCpuMs = gpu.softWatchUiFrames > 0 ? gpu.softWatchUiMs / gpu.softWatchUiFrames : -1.0;
+        writeBenchmarkJson(instancePath(engine, options.benchmarkOutPath).c_str(), info, profilerRecordedFrames());
+    }
+
+    // Zero-allocation check: steady-state frames must not touch the general heap
+    int exitCode = 0;
+    if (options.requireZeroAlloc) {
+        int allocatingFrames = 0;
+        unsigned int mostAllocs = 0;
+        for (const FrameStats& frame : profilerRecordedFrames()) {
+            unsigned int allocs = frame.counters[COUNTER_HEAP_ALLOCS];
+            if (allocs > 0) allocatingFrames++;
+            mostAllocs = (std::max)(mostAllocs, allocs);
+        }
+        if (allocatingFrames > 0) {
+            std::cout << "Heap allocations in " << allocatingFrames << " of " << profilerRecordedFrames().size()
+                << " measured frames (at most " << mostAllocs << " in one frame)" << std::endl;
+            exitCode = 3;
+        }
+        else {
+            std::cout << "No heap allocations in measured frames." << std::endl;
+        }
+    }
+
+    // Cleanup (jobs still running write into their images, so let them finish)
+    waitTextureJobs(gpu);
+    for (GlTexture* texture : { &gpu.groundTexture, &gpu.roadTexture, &gpu.buildingTexture, &gpu.ekgTexture,
+        &gpu.arrowRightTexture, &gpu.arrowLeftTexture, &gpu.heartCursorTexture, &gpu.studentInfoTexture,
+        &gpu.perfTextTexture, &gpu.perfGraphTexture, &gpu.watchScreenTexture, &gpu.timeTexture, &gpu.bpmTexture, &gpu.percTexture,
+        &gpu.displayTexture, &gpu.ditherTexture, &gpu.pullVertexTexture, &gpu.pullInstanceTexture }) {
+        texture->reset();
+    }
+
+    gpu.watchFBO.reset();
+    gpu.displayFBO.reset();
+    gpu.sceneFBO.reset();
+    gpu.sceneColorRBO.reset();
+    gpu.sceneDepthRBO.reset();
+
+    for (GlVertexArray* vao : { &gpu.VAOground, &gpu.VAOcube, &gpu.VAOwatchQuad, &gpu.VAOscreenQuad, &gpu.VAOempty }) vao->reset();
+    for (GlBuffer* buffer : { &gpu.VBOground, &gpu.EBOground, &gpu.VBOcube, &gpu.VBOwatchQuad, &gpu.EBOwatchQuad,
+        &gpu.VBOscreenQuad, &gpu.EBOscreenQuad, &gpu.pullVertexBuffer, &gpu.pullInstanceBuffer }) {
+        buffer->reset();
     }
 
-    // Cleanup
-    glDeleteTextures(1, &groundTexture);
-    glDeleteTextures(1, &roadTexture);
-    glDeleteTextures(1, &buildingTexture);
-    glDeleteTextures(1, &ekgTexture);
-    glDeleteTextures(1, &arrowRightTexture);
-    glDeleteTextures(1, &arrowLeftTexture);
-    glDeleteTextures(1, &heartCursorTexture);
-    glDeleteTextures(1, &studentInfoTexture);
-    glDeleteTextures(1, &watchScreenTexture);
+    gpu.basicShader.reset();
+    gpu.screenShader.reset();
+    gpu.displayShader.reset();
+    glHandlesShutdown();  // Deletes the textures parked in the pool
+
+    profilerShutdown();  // Deletes the timer queries
+    frameArenaShutdown();
+
+    // Everything above should have released all GL objects
+    std::lock_guard<std::mutex> lock(reportMutex);
+    if (options.instances > 1) std::cout << "Instance " << engine.instance << ":" << std::endl;
+    gpuResourceReport();
+    texturePoolReport();
+    if (options.config.displayLink) displayLinkReport(gpu.displayLink);
+    gpuResourceReportLeaks();
+    return exitCode;
+}
+
+int main(int argc, char** argv)
+{
+    startupBegin();
+    heapTrackThisThread();  // Only the render threads; texture jobs allocate freely
+    EngineOptions options;
+    parseArguments(argc, argv, options);
+
+    // Engines are large and the windows point at them, so each is allocated once and never moves
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (int i = 0; i < options.instances; i++) {
+        engines.push_back(std::unique_ptr<Engine>(new Engine()));
+        Engine& engine = *engines.back();
+        engine.instance = i;
+        engine.options = &options;
+        engine.mainThread = options.instances == 1;
+        initClock(engine.world);
+
+        // CPU texture generation runs while the window and context are created
+        startTextureJobs(engine.gpu);
+    }
+    startupMark("texture_jobs");
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef SW_GL_DEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);  // Drivers only report KHR_debug messages on debug contexts
+#endif
+
+    for (const std::unique_ptr<Engine>& engine : engines) {
+        if (!createEngineWindow(*engine)) return endProgram("Failed to create window.");
+    }
+    glfwMakeContextCurrent(engines[0]->window);
+    startupMark("window");
 
-    glDeleteFramebuffers(1, &watchFBO);
+    // Every context comes from the same driver, so one set of entry points serves them all
+    if (glewInit() != GLEW_OK) return endProgram("Failed to initialize GLEW.");
+    startupMark("glew");
 
-    glDeleteVertexArrays(1, &VAOground);
-    glDeleteVertexArrays(1, &VAOcube);
-    glDeleteVertexArrays(1, &VAOwatchQuad);
-    glDeleteVertexArrays(1, &VAOscreenQuad);
+    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+    std::cout << "Controls:" << std::endl;
+    std::cout << "  Mouse: Look up/down" << std::endl;
+    std::cout << "  SPACE: Toggle watch view mode" << std::endl;
+    std::cout << "  D (hold): Simulate running (on heart rate screen)" << std::endl;
+    std::cout << "  F1: Toggle depth testing" << std::endl;
+    std::cout << "  F2: Toggle face culling" << std::endl;
+    std::cout << "  ESC: Exit" << std::endl;
 
-    glDeleteProgram(basicShader);
-    glDeleteProgram(screenShader);
+    int exitCode = 0;
+    if (options.instances == 1) {
+        exitCode = runEngine(*engines[0]);
+    }
+    else {
+        // One thread per engine; each context moves to its engine's thread.
+        // The main thread keeps pumping window events until they are all done.
+        glfwMakeContextCurrent(NULL);
+        std::vector<int> exitCodes(engines.size(), 0);
+        std::atomic<int> running((int)engines.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < engines.size(); i++) {
+            threads.emplace_back([&engines, &exitCodes, &running, i]() {
+                startupBegin();
+                heapTrackThisThread();
+                glfwMakeContextCurrent(engines[i]->window);
+                exitCodes[i] = runEngine(*engines[i]);
+                glfwMakeContextCurrent(NULL);
+                running--;
+                glfwPostEmptyEvent();
+            });
+        }
+        while (running > 0) glfwWaitEventsTimeout(0.1);
+        for (std::thread& thread : threads) thread.join();
+        for (int code : exitCodes) exitCode = (std::max)(exitCode, code);
+    }
 
-    glfwDestroyWindow(window);
+    for (const std::unique_ptr<Engine>& engine : engines) glfwDestroyWindow(engine->window);
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,263 @@
+#include "Profiler.h"
+#include "Telemetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Timer query results are read this many frames after they were issued,
+// so resolving them never stalls the pipeline
+const int QUERY_LATENCY = 3;
+
+// One profiler per render thread: engine instances running side by side
+// (--instances) each measure their own frames and their own GL context
+static thread_local GLuint gpuQueries[GPU_PASS_COUNT][QUERY_LATENCY];
+static thread_local bool gpuQueryIssued[GPU_PASS_COUNT][QUERY_LATENCY];
+static thread_local float gpuPassMs[GPU_PASS_COUNT];
+static thread_local int activeGpuPass = -1;  // Pass whose query is open (-1 = none)
+
+static thread_local FrameStats history[PROFILER_HISTORY_SIZE];
+static thread_local std::atomic<unsigned int> publishedFrames(0);
+
+static thread_local std::vector<FrameStats> recordedFrames;
+static thread_local bool recording = false;
+
+static thread_local FrameStats current;
+static thread_local unsigned int frameNumber = 0;
+static thread_local bool initialized = false;
+
+static thread_local char logLines[PROFILER_LOG_SIZE][PROFILER_LOG_LINE];
+static thread_local unsigned int logCount = 0;    // Messages logged so far
+static thread_local unsigned int logPrinted = 0;  // Of those, printed (or dropped from the ring)
+static thread_local TelemetryBlock* telemetry = NULL;
+
+static thread_local std::chrono::steady_clock::time_point frameStart;
+static thread_local std::chrono::steady_clock::time_point lastFrameStart;
+
+static float millisecondsBetween(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<float, std::milli>(b - a).count();
+}
+
+// Prints the messages logged since the last flush (outside the measured frame)
+static void flushLog() {
+    if (logCount - logPrinted > (unsigned int)PROFILER_LOG_SIZE) {
+        printf("Profiler: %u messages dropped\n", logCount - logPrinted - PROFILER_LOG_SIZE);
+        logPrinted = logCount - PROFILER_LOG_SIZE;
+    }
+    if (logPrinted == logCount) return;
+    for (; logPrinted < logCount; logPrinted++) printf("Profiler: %s\n", logLines[logPrinted % PROFILER_LOG_SIZE]);
+    fflush(stdout);
+}
+
+void profilerInit() {
+    glGenQueries(GPU_PASS_COUNT * QUERY_LATENCY, &gpuQueries[0][0]);
+    memset(gpuQueryIssued, 0, sizeof(gpuQueryIssued));
+    memset(gpuPassMs, 0, sizeof(gpuPassMs));
+    activeGpuPass = -1;
+    memset(&current, 0, sizeof(current));
+    lastFrameStart = std::chrono::steady_clock::now();
+    initialized = true;
+}
+
+void profilerShutdown() {
+    if (!initialized) return;
+    glDeleteQueries(GPU_PASS_COUNT * QUERY_LATENCY, &gpuQueries[0][0]);
+    initialized = false;
+    flushLog();
+
+    if (telemetry != NULL) {
+        telemetry->magic = 0;  // Tells attached viewers the run is over
+        telemetryClose();
+        telemetry = NULL;
+    }
+}
+
+bool profilerStartTelemetry(float targetFrameMs) {
+    static_assert(COUNTER_COUNT <= TELEMETRY_MAX_COUNTERS && GPU_PASS_COUNT <= TELEMETRY_MAX_PASSES,
+        "Telemetry frame too small for the profiler counters");
+
+    TelemetryBlock* block = telemetryCreate();
+    if (block == NULL) return false;
+
+    block->counterCount = COUNTER_COUNT;
+    block->passCount = GPU_PASS_COUNT;
+    block->targetFrameMs = targetFrameMs;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        strncpy(block->counterNames[c], profilerCounterName((ProfilerCounter)c), TELEMETRY_NAME_LENGTH - 1);
+    }
+    for (int p = 0; p < GPU_PASS_COUNT; p++) {
+        strncpy(block->passNames[p], profilerGpuPassName((ProfilerGpuPass)p), TELEMETRY_NAME_LENGTH - 1);
+    }
+
+    // Readers check the magic, so it goes in last
+    std::atomic_thread_fence(std::memory_order_release);
+    block->magic = TELEMETRY_MAGIC;
+    telemetry = block;
+    std::cout << "Telemetry: publishing frames for TelemetryViewer" << std::endl;
+    return true;
+}
+
+void profilerBeginFrame() {
+    frameStart = std::chrono::steady_clock::now();
+    memset(&current, 0, sizeof(current));
+    current.frameTimeMs = millisecondsBetween(lastFrameStart, frameStart);
+    lastFrameStart = frameStart;
+}
+
+void profilerEndFrame() {
+    current.cpuTimeMs = millisecondsBetween(frameStart, std::chrono::steady_clock::now());
+    memcpy(current.gpuPassMs, gpuPassMs, sizeof(gpuPassMs));
+
+    // Publish: fill the slot first, then advance the counter readers look at
+    unsigned int n = publishedFrames.load(std::memory_order_relaxed);
+    history[n % PROFILER_HISTORY_SIZE] = current;
+    publishedFrames.store(n + 1, std::memory_order_release);
+
+    if (recording) recordedFrames.push_back(current);
+
+    if (telemetry != NULL) {
+        TelemetryFrame frame = {};
+        frame.frameNumber = frameNumber;
+        frame.frameTimeMs = current.frameTimeMs;
+        frame.cpuTimeMs = current.cpuTimeMs;
+        memcpy(frame.gpuPassMs, current.gpuPassMs, sizeof(current.gpuPassMs));
+        memcpy(frame.counters, current.counters, sizeof(current.counters));
+        telemetryPublish(telemetry, frame);
+    }
+
+    frameNumber++;
+    flushLog();
+}
+
+void profilerSetRecording(bool enabled) {
+    if (enabled && !recording) recordedFrames.clear();
+    recording = enabled;
+}
+
+const std::vector<FrameStats>& profilerRecordedFrames() {
+    return recordedFrames;
+}
+
+void profilerLog(const char* format, ...) {
+    char* line = logLines[logCount % PROFILER_LOG_SIZE];
+    int prefix = snprintf(line, PROFILER_LOG_LINE, "[frame %u] ", frameNumber);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line + prefix, PROFILER_LOG_LINE - prefix, format, args);
+    va_end(args);
+    logCount++;
+}
+
+int profilerLogMessages(const char** outLines, int maxCount) {
+    int count = (int)(logCount < (unsigned int)PROFILER_LOG_SIZE ? logCount : PROFILER_LOG_SIZE);
+    if (count > maxCount) count = maxCount;
+
+    for (int i = 0; i < count; i++) outLines[i] = logLines[(logCount - count + i) % PROFILER_LOG_SIZE];
+    return count;
+}
+
+void profilerCount(ProfilerCounter counter, unsigned int amount) {
+    unsigned int& value = current.counters[counter];
+    value = amount > UINT_MAX - value ? UINT_MAX : value + amount;  // Saturates instead of wrapping
+}
+
+void profilerBeginGpuPass(ProfilerGpuPass pass) {
+    if (!initialized) return;
+    if (activeGpuPass >= 0) {
+        // GL allows one GL_TIME_ELAPSED query at a time
+        std::cout << "Profiler: GPU pass " << profilerGpuPassName(pass) << " begun inside "
+            << profilerGpuPassName((ProfilerGpuPass)activeGpuPass) << std::endl;
+        return;
+    }
+    int slot = frameNumber % QUERY_LATENCY;
+    GLuint query = gpuQueries[pass][slot];
+
+    // Collect the result issued QUERY_LATENCY frames ago; if the GPU is
+    // still behind, drop it instead of waiting
+    if (gpuQueryIssued[pass][slot]) {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+            gpuPassMs[pass] = (float)(elapsedNs / 1.0e6);
+        }
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    gpuQueryIssued[pass][slot] = true;
+    activeGpuPass = pass;
+}
+
+void profilerEndGpuPass(ProfilerGpuPass pass) {
+    if (!initialized) return;
+    if (pass != activeGpuPass) {
+        std::cout << "Profiler: GPU pass " << profilerGpuPassName(pass) << " ended but not begun" << std::endl;
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    activeGpuPass = -1;
+}
+
+FrameStats profilerLastFrame() {
+    unsigned int n = publishedFrames.load(std::memory_order_acquire);
+    if (n == 0) {
+        FrameStats empty;
+        memset(&empty, 0, sizeof(empty));
+        return empty;
+    }
+    return history[(n - 1) % PROFILER_HISTORY_SIZE];
+}
+
+int profilerFrameTimes(float* outMs, int maxCount) {
+    unsigned int n = publishedFrames.load(std::memory_order_acquire);
+    int count = (int)(n < (unsigned int)PROFILER_HISTORY_SIZE ? n : PROFILER_HISTORY_SIZE);
+    if (count > maxCount) count = maxCount;
+
+    for (int i = 0; i < count; i++) {
+        outMs[i] = history[(n - count + i) % PROFILER_HISTORY_SIZE].frameTimeMs;
+    }
+    return count;
+}
+
+float profilerAverageFps() {
+    float times[60];
+    int count = profilerFrameTimes(times, 60);
+    float total = 0.0f;
+    for (int i = 0; i < count; i++) total += times[i];
+    return total > 0.0f ? count * 1000.0f / total : 0.0f;
+}
+
+const char* profilerCounterName(ProfilerCounter counter) {
+    switch (counter) {
+    case COUNTER_DRAW_CALLS: return "draw_calls";
+    case COUNTER_VERTICES: return "vertices";
+    case COUNTER_PROGRAM_BINDS: return "program_binds";
+    case COUNTER_TEXTURE_BINDS: return "texture_binds";
+    case COUNTER_UNIFORM_UPLOADS: return "uniform_uploads";
+    case COUNTER_BUFFER_UPLOADS: return "buffer_uploads";
+    case COUNTER_BUFFER_BYTES: return "buffer_bytes";
+    case COUNTER_TEXTURE_UPLOADS: return "texture_uploads";
+    case COUNTER_STATE_CHANGES: return "state_changes";
+    case COUNTER_HEAP_ALLOCS: return "heap_allocs";
+    case COUNTER_RIG_TRANSFORMS: return "rig_transforms";
+    case COUNTER_STATE_ISSUED: return "state_issued";
+    case COUNTER_STATE_FILTERED: return "state_filtered";
+    case COUNTER_DISPLAY_BYTES: return "display_bytes";
+    case COUNTER_DISPLAY_TILES: return "display_tiles";
+    default: return "?";
+    }
+}
+
+const char* profilerGpuPassName(ProfilerGpuPass pass) {
+    switch (pass) {
+    case GPU_PASS_WATCH_UI: return "watch_ui";
+    case GPU_PASS_SCENE: return "scene";
+    case GPU_PASS_OVERLAY: return "overlay";
+    default: return "?";
+    }
+}
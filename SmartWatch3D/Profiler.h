@@ -0,0 +1,89 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/*
+ * Frame profiler
+ * --------------
+ * Collects per-frame CPU time, GPU pass times (GL_TIME_ELAPSED queries) and
+ * simple event counters. Completed frames are published into a fixed ring
+ * buffer; readers (the performance screen) only copy from that ring, so a
+ * read never takes a lock or touches the GL.
+ */
+
+// Per-frame event counters (filled by the GL interception layer, GLTrace.h)
+enum ProfilerCounter {
+    COUNTER_DRAW_CALLS,       // glDraw* calls
+    COUNTER_VERTICES,         // Vertices/indices submitted (times instances)
+    COUNTER_PROGRAM_BINDS,    // glUseProgram
+    COUNTER_TEXTURE_BINDS,    // glBindTexture
+    COUNTER_UNIFORM_UPLOADS,  // glUniform*
+    COUNTER_BUFFER_UPLOADS,   // glBufferData / glBufferSubData
+    COUNTER_BUFFER_BYTES,     // Bytes passed to the buffer uploads
+    COUNTER_TEXTURE_UPLOADS,  // glTexImage2D with data / glTexSubImage2D
+    COUNTER_STATE_CHANGES,    // glEnable/glDisable, blend, cull, viewport, VAO/FBO binds
+    COUNTER_HEAP_ALLOCS,      // operator new calls on the render thread (see FrameArena.h)
+    COUNTER_RIG_TRANSFORMS,   // Watch rig world matrices recomputed (see Hierarchy.h)
+    COUNTER_STATE_ISSUED,     // State cache requests that reached GL (see GLState.h)
+    COUNTER_STATE_FILTERED,   // State cache requests dropped as no-ops
+    COUNTER_DISPLAY_BYTES,    // Bytes sent to the watch panel (see DisplayLink.h)
+    COUNTER_DISPLAY_TILES,    // Changed tiles sent to the watch panel
+    COUNTER_COUNT
+};
+
+// GPU passes timed with timer queries (must not overlap)
+enum ProfilerGpuPass {
+    GPU_PASS_WATCH_UI,  // Watch UI rendered into watchFBO
+    GPU_PASS_SCENE,     // 3D scene
+    GPU_PASS_OVERLAY,   // Student info overlay
+    GPU_PASS_COUNT
+};
+
+struct FrameStats {
+    float frameTimeMs;                   // Time since the previous frame started
+    float cpuTimeMs;                     // Begin -> end of frame on the CPU
+    float gpuPassMs[GPU_PASS_COUNT];     // Latest resolved GPU time per pass
+    unsigned int counters[COUNTER_COUNT];
+};
+
+const int PROFILER_HISTORY_SIZE = 128;  // Frames kept for the frame-time graph
+
+// Lifetime (needs a current GL context for the timer queries)
+void profilerInit();
+void profilerShutdown();
+
+// Frame boundaries
+void profilerBeginFrame();
+void profilerEndFrame();
+
+// Counters are plain increments on the render thread, saturating at UINT_MAX
+void profilerCount(ProfilerCounter counter, unsigned int amount = 1);
+
+// GPU pass timing; a nested begin or an end of another pass is reported and ignored
+void profilerBeginGpuPass(ProfilerGpuPass pass);
+void profilerEndGpuPass(ProfilerGpuPass pass);
+
+// Recording keeps every completed frame (used by benchmark runs)
+void profilerSetRecording(bool recording);
+const std::vector<FrameStats>& profilerRecordedFrames();
+
+// Live telemetry: also publish every frame to shared memory for TelemetryViewer
+// (see Telemetry.h); returns false if the shared block could not be created
+bool profilerStartTelemetry(float targetFrameMs);
+
+// Event log (GL debug performance warnings and similar): the latest
+// PROFILER_LOG_SIZE messages are kept in fixed buffers, each tagged with its
+// frame number, and printed at the end of the frame, so logging inside a
+// frame neither allocates nor waits for the console
+const int PROFILER_LOG_SIZE = 64;
+const int PROFILER_LOG_LINE = 256;  // Bytes per message, longer ones are cut
+void profilerLog(const char* format, ...);
+int profilerLogMessages(const char** outLines, int maxCount);  // Oldest first, returns count
+
+// Lock-free readers
+FrameStats profilerLastFrame();
+int profilerFrameTimes(float* outMs, int maxCount);  // Oldest first, returns count
+float profilerAverageFps();
+const char* profilerCounterName(ProfilerCounter counter);
+const char* profilerGpuPassName(ProfilerGpuPass pass);
@@ -0,0 +1,171 @@
+#include "Scene.h"
+
+#include <cstdlib>
+#include <glm/gtc/matrix_transform.hpp>
+
+int groundSegmentCount = NUM_GROUND_SEGMENTS;
+int buildingsPerSide = NUM_BUILDINGS_PER_SIDE;
+float buildingSpacing = BUILDING_SPACING;
+int streetLightCount = 0;
+
+float sceneWrapLength() {
+    float groundLength = groundSegmentCount * GROUND_SEGMENT_LENGTH;
+    float buildingLength = buildingsPerSide * buildingSpacing + 10.0f;
+    return groundLength > buildingLength ? groundLength : buildingLength;
+}
+
+// ==================== BUILDING GENERATION ====================
+/*
+ * Buildings are procedurally generated with random variations in:
+ * - Position: slight offset from the road edge
+ * - Size: varying width, height, and depth
+ * - Color: brownish/beige tones typical of urban buildings
+ *
+ * Using a fixed seed (42) ensures the same buildings are generated
+ * every time the program runs, providing consistent visuals.
+ */
+
+/**
+ * Generates buildings on both sides of the road, then adds the watch rig
+ * Called once at startup to populate the entity store
+ */
+void generateSceneEntities(SceneEntities& scene) {
+    EntityStore& store = scene.store;
+    entityClear(store);
+    srand(42);  // Fixed seed for reproducible results
+
+    for (int side = 0; side < 2; side++) {
+        // Left side (side=0) is at negative X, right side (side=1) is at positive X
+        float sideX = (side == 0) ? -(ROAD_WIDTH + 5.0f) : (ROAD_WIDTH + 5.0f);
+
+        for (int i = 0; i < buildingsPerSide; i++) {
+            // Position with slight random offset for natural look
+            glm::vec3 position(
+                sideX + (rand() % 10 - 5) * 0.5f,    // X: road edge + random offset
+                0.0f,                                  // Y: set from the height below
+                -10.0f - i * buildingSpacing - (rand() % 10) * 0.5f  // Z: spaced along road
+            );
+
+            // Random size within reasonable bounds
+            glm::vec3 scale(
+                4.0f + (rand() % 40) * 0.1f,   // Width: 4-8 meters
+                6.0f + (rand() % 100) * 0.1f,  // Height: 6-16 meters
+                4.0f + (rand() % 40) * 0.1f    // Depth: 4-8 meters
+            );
+
+            // Brownish/beige color with slight variation
+            glm::vec3 color(
+                0.5f + (rand() % 30) * 0.01f,   // Red: 0.5-0.8
+                0.45f + (rand() % 30) * 0.01f,  // Green: 0.45-0.75
+                0.4f + (rand() % 30) * 0.01f    // Blue: 0.4-0.7
+            );
+
+            // Y is half-height because the cube is centered at the origin
+            position.y = scale.y / 2.0f;
+            EntityId id = entityCreate(store, position, scale, color, MATERIAL_BUILDING, ENTITY_SCROLLS);
+
+            // Facades by index rather than rand(), so the layout sequence stays as it was
+            store.variant[id] = (unsigned char)((i * 3 + side) % BUILDING_FACADES);
+        }
+    }
+    scene.buildingCount = (int)entityCount(store);
+
+    // Watch rig, posed every frame by buildSceneTransforms
+    scene.hand = entityCreate(store, glm::vec3(0.0f), glm::vec3(0.08f, 0.4f, 0.15f),
+        glm::vec3(0.9f, 0.75f, 0.65f), MATERIAL_SKIN, ENTITY_PARENTED);           // Skin tone
+    scene.watchFrame = entityCreate(store, glm::vec3(0.0f), glm::vec3(0.35f, 0.35f, 0.03f),
+        glm::vec3(0.2f, 0.2f, 0.25f), MATERIAL_WATCH_FRAME, ENTITY_PARENTED);     // Dark gray
+    scene.watchScreen = entityCreate(store, glm::vec3(0.0f), glm::vec3(1.0f),
+        glm::vec3(1.0f), MATERIAL_WATCH_SCREEN, ENTITY_PARENTED);
+
+    // Parents before children (the hierarchy requires it)
+    TransformHierarchy& rig = scene.rig;
+    transformClear(rig);
+    scene.cameraNode = transformCreate(rig, -1, -1);
+    scene.wristNode = transformCreate(rig, scene.cameraNode, -1);
+    scene.handNode = transformCreate(rig, scene.wristNode, scene.hand);
+    scene.watchNode = transformCreate(rig, scene.wristNode, scene.watchFrame);
+    scene.screenNode = transformCreate(rig, scene.watchNode, scene.watchScreen);
+    scene.lightNode = transformCreate(rig, scene.watchNode, -1);
+    scene.rigMatricesUpdated = 0;
+}
+
+// ==================== FRAME TRANSFORMS ====================
+
+// Wrist view rotation (degrees, X then Y), shared by the hand, frame and screen
+const float WRIST_ROT_X = -45.0f;
+const float WRIST_ROT_Y = 30.0f;
+
+/**
+ * Local offset under the wrist that places a child at offset (camera space)
+ * from the wrist: the hand and screen are positioned by camera-space
+ * offsets but rotate with the wrist, so the offset is un-rotated
+ */
+static glm::vec3 wristLocalOffset(const glm::vec3& offset) {
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(WRIST_ROT_X), glm::vec3(1.0f, 0.0f, 0.0f));
+    rotation = glm::rotate(rotation, glm::radians(WRIST_ROT_Y), glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::transpose(glm::mat3(rotation)) * offset;
+}
+
+/**
+ * Sets the local transforms of the rig nodes that move
+ * Only nodes whose values change are recomputed by transformUpdate, so a
+ * still camera in watch view recomputes nothing. The world matrices are the
+ * per-entity poses the rig had before the hierarchy (to float rounding;
+ * BM_RigTransforms checks them).
+ */
+static void poseWatchRig(SceneEntities& scene, const glm::vec3& viewPos, bool watchViewMode, float cameraBobOffset) {
+    TransformHierarchy& rig = scene.rig;
+    transformSetLocal(rig, scene.cameraNode, viewPos, 0.0f, 0.0f);
+
+    if (watchViewMode) {
+        // Watch directly in front of camera facing the viewer, hand raised below it,
+        // the screen 0.02 in front of the frame
+        transformSetLocal(rig, scene.wristNode, glm::vec3(0.0f, 0.0f, -0.5f), 0.0f, 0.0f);
+        transformSetLocal(rig, scene.handNode, glm::vec3(0.0f, -0.3f, -0.1f), -30.0f, 0.0f);
+        transformSetLocal(rig, scene.screenNode, glm::vec3(0.0f, 0.0f, 0.02f), 0.0f, 0.0f);
+    }
+    else {
+        // Wrist at the side, angled naturally; cameraBobOffset makes it bob while running.
+        // The hand hangs 0.1 below the watch and bobs half as much; the screen is 0.02
+        // nearer the camera than the frame (camera-space offsets, like the frame's)
+        static const glm::vec3 screenOffset = wristLocalOffset(glm::vec3(0.0f, 0.0f, 0.02f));
+        transformSetLocal(rig, scene.wristNode, glm::vec3(0.4f, -0.3f + cameraBobOffset, -0.3f), WRIST_ROT_X, WRIST_ROT_Y);
+        transformSetLocal(rig, scene.handNode, wristLocalOffset(glm::vec3(0.0f, -0.1f - cameraBobOffset * 0.5f, 0.0f)), 0.0f, 0.0f);
+        transformSetLocal(rig, scene.screenNode, screenOffset, 0.0f, 0.0f);
+    }
+}
+
+void buildSceneTransforms(SceneTransforms& out, SceneEntities& scene,
+    const glm::vec3& viewPos, bool watchViewMode, float groundOffset, float cameraBobOffset) {
+
+    // Watch rig; the watch acts as a weak light that illuminates nearby objects
+    poseWatchRig(scene, viewPos, watchViewMode, cameraBobOffset);
+    scene.rigMatricesUpdated = transformUpdate(scene.rig, scene.store);
+    out.watchLightPos = transformWorldPosition(scene.rig, scene.lightNode);
+
+    // Ground segments: each one is placed behind the previous one,
+    // groundOffset moves them forward, creating illusion of movement
+    out.ground.resize(groundSegmentCount);
+    out.road.resize(groundSegmentCount);
+    for (int i = 0; i < groundSegmentCount; i++) {
+        out.ground[i] = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, groundOffset - i * GROUND_SEGMENT_LENGTH));
+
+        // Road is slightly above ground (Y=0.01) to prevent z-fighting
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.01f, groundOffset - i * GROUND_SEGMENT_LENGTH));
+        out.road[i] = glm::scale(model, glm::vec3(ROAD_WIDTH / 100.0f, 1.0f, 1.0f));  // Scale width
+    }
+
+    // Buildings scroll with the ground and wrap around
+    float wrapLength = sceneWrapLength();
+    entityUpdateTransforms(scene.store, groundOffset, wrapLength);
+
+    // Street lights: evenly spaced, alternating road sides, scrolling with the ground
+    out.streetLights.resize(streetLightCount);
+    for (int i = 0; i < streetLightCount; i++) {
+        float side = (i % 2 == 0) ? -1.0f : 1.0f;
+        float z = 10.0f - (i + 0.5f) * wrapLength / streetLightCount + groundOffset;
+        while (z > 10.0f) z -= wrapLength;
+        out.streetLights[i] = glm::vec3(side * (ROAD_WIDTH / 2.0f + 1.0f), STREET_LIGHT_HEIGHT, z);
+    }
+}
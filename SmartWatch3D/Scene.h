@@ -0,0 +1,85 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Entities.h"
+#include "Hierarchy.h"
+
+/*
+ * Scene layout
+ * ------------
+ * Everything about the 3D scene that is pure math: the procedurally placed
+ * buildings, the watch rig and the model matrices of every object for the
+ * current frame. Buildings and the rig live in an entity store (Entities.h);
+ * the rig is posed through a transform hierarchy (Hierarchy.h).
+ * renderScene only binds state and issues draws for what is computed here,
+ * which keeps the CPU cost of a frame measurable without a GL context.
+ */
+
+// Ground/road configuration for infinite scrolling effect
+const float GROUND_SEGMENT_LENGTH = 20.0f;  // Length of one ground segment
+const int NUM_GROUND_SEGMENTS = 5;          // Number of segments to tile
+const float ROAD_WIDTH = 8.0f;              // Width of the road
+
+// Building configuration
+const int NUM_BUILDINGS_PER_SIDE = 6;       // Buildings on each side of road
+const float BUILDING_SPACING = 15.0f;       // Distance between buildings
+const int BUILDING_FACADES = 4;             // Facade variants (layers of the building texture array)
+
+// Street lights along the road (point lights in basic.frag, none by default)
+const int MAX_STREET_LIGHTS = 32;           // Must match MAX_POINT_LIGHTS in basic.frag
+const float STREET_LIGHT_HEIGHT = 5.0f;
+
+// Scene size used at runtime. Defaults are the constants above; the runtime
+// config (Config.h) overrides them before the scene is built.
+extern int groundSegmentCount;
+extern int buildingsPerSide;
+extern float buildingSpacing;
+extern int streetLightCount;
+
+// Scene objects: the buildings (entities 0 .. buildingCount - 1) followed by the watch rig
+struct SceneEntities {
+    EntityStore store;
+    int buildingCount;
+    EntityId hand;
+    EntityId watchFrame;
+    EntityId watchScreen;
+
+    // Watch rig: camera -> wrist -> { hand, watch -> { screen, light } }
+    TransformHierarchy rig;
+    TransformNode cameraNode;
+    TransformNode wristNode;
+    TransformNode handNode;
+    TransformNode watchNode;
+    TransformNode screenNode;
+    TransformNode lightNode;
+    int rigMatricesUpdated;   // World matrices recomputed by the last buildSceneTransforms
+};
+
+// Per-frame data of the objects that are not entities
+struct SceneTransforms {
+    std::vector<glm::mat4> ground;     // One per ground segment
+    std::vector<glm::mat4> road;       // One per ground segment
+    glm::vec3 watchLightPos;           // World position of the screen light
+    std::vector<glm::vec3> streetLights;  // World positions, streetLightCount of them
+};
+
+/**
+ * Length of road after which ground, buildings and street lights wrap around
+ * Covers all ground segments and all buildings, whichever is longer
+ */
+float sceneWrapLength();
+
+/**
+ * Fills the scene with both rows of buildings along the road (fixed seed)
+ * and the watch rig (hand, watch frame, watch screen)
+ */
+void generateSceneEntities(SceneEntities& scene);
+
+/**
+ * Poses the watch rig and computes all model matrices for the current
+ * camera and animation state (entity matrices go to the store's model column)
+ * The vectors are reused, so after the first frame this never allocates
+ */
+void buildSceneTransforms(SceneTransforms& out, SceneEntities& scene,
+    const glm::vec3& viewPos, bool watchViewMode, float groundOffset, float cameraBobOffset);
@@ -0,0 +1,333 @@
+#include "SoftRaster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFT_RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ==================== SPAN OPERATIONS ====================
+/*
+ * Both passes work on 8-bit channels widened to 16 bits, 4 pixels per
+ * 16-byte load. a * b / 255 is rounded like the GL conversion does:
+ * x = a * b + 128, then (x + (x >> 8)) >> 8, which never exceeds 16 bits.
+ * Blending applies the same factors to alpha, as GL_SRC_ALPHA /
+ * GL_ONE_MINUS_SRC_ALPHA does with no separate alpha function.
+ */
+
+static inline unsigned char mul255(int a, int b) {
+    int x = a * b + 128;
+    return (unsigned char)((x + (x >> 8)) >> 8);
+}
+
+// Multiplies each pixel of a span by color (texel * uColor)
+static void modulateSpan(unsigned char* px, int count, CanvasColor color) {
+    int i = 0;
+#ifdef SOFT_RASTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i factor = _mm_setr_epi16(color.r, color.g, color.b, color.a, color.r, color.g, color.b, color.a);
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(px + i * 4));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), factor), bias);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), factor), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(px + i * 4), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        unsigned char* p = px + i * 4;
+        p[0] = mul255(p[0], color.r);
+        p[1] = mul255(p[1], color.g);
+        p[2] = mul255(p[2], color.b);
+        p[3] = mul255(p[3], color.a);
+    }
+}
+
+#ifdef SOFT_RASTER_SSE2
+// Blends 2 widened pixels: src * a + dst * (255 - a), a = src alpha broadcast over the pixel
+static inline __m128i blendPair(__m128i src, __m128i dst) {
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, 0xFF), 0xFF);
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, _mm_sub_epi16(full, alpha)));
+    x = _mm_add_epi16(x, bias);
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+// Blends a span of source pixels over the destination row
+static void blendSpan(unsigned char* dst, const unsigned char* src, int count) {
+    int i = 0;
+#ifdef SOFT_RASTER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+        __m128i lo = blendPair(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+        __m128i hi = blendPair(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        const unsigned char* s = src + i * 4;
+        unsigned char* d = dst + i * 4;
+        int a = s[3];
+        for (int c = 0; c < 4; c++) {
+            int x = s[c] * a + d[c] * (255 - a) + 128;
+            d[c] = (unsigned char)((x + (x >> 8)) >> 8);
+        }
+    }
+}
+
+// ==================== TILES ====================
+
+static void drawQuadInTile(const Canvas& canvas, const SoftRasterQuad& q, int x0, int y0, int x1, int y1) {
+    alignas(16) unsigned char span[SOFT_RASTER_TILE * 4];
+    int count = x1 - x0;
+    size_t stride = (size_t)canvas.width * 4;
+
+    if (q.image == NULL) {
+        if (q.color.a == 255) {
+            canvasFillRect(canvas, x0, y0, count, y1 - y0, q.color);
+            return;
+        }
+        for (int i = 0; i < count; i++) memcpy(span + i * 4, &q.color, 4);
+        for (int y = y0; y < y1; y++) blendSpan(canvas.pixels + y * stride + (size_t)x0 * 4, span, count);
+        return;
+    }
+
+    // Texel columns are the same on every row
+    const Image& image = *q.image;
+    int texelX[SOFT_RASTER_TILE];
+    for (int i = 0; i < count; i++) {
+        float u = ((float)(x0 + i) + 0.5f - q.left) * q.invWidth * q.texScaleX + q.texOffsetX;
+        u -= floorf(u);
+        texelX[i] = (std::min)((int)(u * image.width), image.width - 1);
+    }
+
+    bool white = q.color.r == 255 && q.color.g == 255 && q.color.b == 255 && q.color.a == 255;
+    for (int y = y0; y < y1; y++) {
+        float v = ((float)y + 0.5f - q.bottom) * q.invHeight;
+        int texelY = (std::min)((std::max)((int)(v * image.height), 0), image.height - 1);
+        const unsigned char* texRow = image.pixels.data() + (size_t)texelY * image.width * 4;
+
+        for (int i = 0; i < count; i++) memcpy(span + i * 4, texRow + texelX[i] * 4, 4);
+        if (!white) modulateSpan(span, count, q.color);
+        blendSpan(canvas.pixels + y * stride + (size_t)x0 * 4, span, count);
+    }
+}
+
+static void drawTile(const SoftRasterJob& job, int tile) {
+    const Canvas& canvas = job.canvas;
+    int tx0 = (tile % job.tilesX) * SOFT_RASTER_TILE;
+    int ty0 = (tile / job.tilesX) * SOFT_RASTER_TILE;
+    int tx1 = (std::min)(tx0 + SOFT_RASTER_TILE, canvas.width);
+    int ty1 = (std::min)(ty0 + SOFT_RASTER_TILE, canvas.height);
+
+    canvasFillRect(canvas, tx0, ty0, tx1 - tx0, ty1 - ty0, job.clear);
+
+    for (int i = 0; i < job.quadCount; i++) {
+        const SoftRasterQuad& q = job.quads[i];
+        int x0 = (std::max)(q.x0, tx0);
+        int y0 = (std::max)(q.y0, ty0);
+        int x1 = (std::min)(q.x1, tx1);
+        int y1 = (std::min)(q.y1, ty1);
+        if (x0 < x1 && y0 < y1) drawQuadInTile(canvas, q, x0, y0, x1, y1);
+    }
+}
+
+static void runTiles(SoftRasterJob& job) {
+    for (;;) {
+        int tile = job.nextTile.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= job.tileCount) return;
+        drawTile(job, tile);
+    }
+}
+
+// ==================== POOL ====================
+
+// seen is the generation at start: a job may be posted before the thread first runs
+static void workerLoop(SoftRasterPool* pool, unsigned long long seen) {
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    for (;;) {
+        pool->wake.wait(lock, [&]() { return pool->stopping || pool->generation != seen; });
+        if (pool->stopping) return;
+        seen = pool->generation;
+        SoftRasterJob* job = pool->job;
+
+        lock.unlock();
+        runTiles(*job);
+        lock.lock();
+
+        if (--pool->running == 0) pool->done.notify_one();
+    }
+}
+
+void softRasterPoolStart(SoftRasterPool& pool, int threads) {
+    softRasterPoolStop(pool);
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    threads = (std::max)(threads, 1);
+
+    for (int i = 1; i < threads; i++) pool.workers.emplace_back(workerLoop, &pool, pool.generation);
+}
+
+void softRasterPoolStop(SoftRasterPool& pool) {
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stopping = true;
+    }
+    pool.wake.notify_all();
+    for (std::thread& worker : pool.workers) worker.join();
+    pool.workers.clear();
+    pool.stopping = false;
+}
+
+SoftRasterPool::~SoftRasterPool() {
+    softRasterPoolStop(*this);
+}
+
+// ==================== FRAME ====================
+
+static unsigned char toByte(float value) {
+    return (unsigned char)((std::min)((std::max)(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// First pixel whose center is at or right of edge, kept near the target so it converts safely
+static int coveredFrom(float edge, int size) {
+    float first = ceilf(edge - 0.5f);
+    return (int)(std::min)((std::max)(first, -1.0f), (float)size + 1.0f);
+}
+
+void softRasterWatchUi(Image& target, int size, CanvasColor clear,
+    const std::vector<WatchUiQuad>& quads, const WatchUiImages& images, SoftRasterPool* pool) {
+    size_t bytes = (size_t)size * size * 4;
+    if (target.pixels.size() != bytes) {
+        target.pixels.resize(bytes);
+    }
+    target.width = size;
+    target.height = size;
+    target.channels = 4;
+
+    SoftRasterJob job;
+    job.canvas = makeCanvas(target.pixels.data(), size, size, 4);
+    job.clear = clear;
+    job.tilesX = (size + SOFT_RASTER_TILE - 1) / SOFT_RASTER_TILE;
+    job.tileCount = job.tilesX * job.tilesX;
+    job.quadCount = 0;
+
+    // Watch screen space (-1..1) to pixels
+    float half = size * 0.5f;
+    for (const WatchUiQuad& quad : quads) {
+        if (job.quadCount == SOFT_RASTER_MAX_QUADS) break;
+
+        const Image* image = NULL;
+        if (quad.image != UI_IMAGE_NONE) {
+            image = images.images[quad.image];
+            if (image == NULL || image->pixels.empty() || image->channels != 4) continue;
+        }
+
+        float left = (quad.x - quad.w + 1.0f) * half;
+        float right = (quad.x + quad.w + 1.0f) * half;
+        float bottom = (quad.y - quad.h + 1.0f) * half;
+        float top = (quad.y + quad.h + 1.0f) * half;
+        if (right <= left || top <= bottom) continue;
+
+        SoftRasterQuad& q = job.quads[job.quadCount];
+        q.x0 = coveredFrom(left, size);
+        q.x1 = coveredFrom(right, size);
+        q.y0 = coveredFrom(bottom, size);
+        q.y1 = coveredFrom(top, size);
+        if (q.x0 >= q.x1 || q.y0 >= q.y1) continue;
+
+        q.left = left;
+        q.bottom = bottom;
+        q.invWidth = 1.0f / (right - left);
+        q.invHeight = 1.0f / (top - bottom);
+        q.texScaleX = quad.texScaleX;
+        q.texOffsetX = quad.texOffsetX;
+        q.color.r = toByte(quad.r);
+        q.color.g = toByte(quad.g);
+        q.color.b = toByte(quad.b);
+        q.color.a = toByte(quad.a);
+        q.image = image;
+        job.quadCount++;
+    }
+    job.nextTile.store(0, std::memory_order_relaxed);
+
+    if (pool == NULL || pool->workers.empty()) {
+        runTiles(job);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->job = &job;
+        pool->running = (int)pool->workers.size();
+        pool->generation++;
+    }
+    pool->wake.notify_all();
+    runTiles(job);
+
+    // The job lives on this stack frame, so every worker has to be done with it
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->done.wait(lock, [pool]() { return pool->running == 0; });
+    pool->job = NULL;
+}
+
+// ==================== WATCH SCREEN ====================
+
+void softWatchUiInit(SoftWatchUi& ui, int threads) {
+    generateArrowImage(ui.arrowLeft, false);
+    generateArrowImage(ui.arrowRight, true);
+    generateEKGImage(ui.ekg);
+    generateHeartImage(ui.heart);
+
+    // Digit images are regenerated in place, so reserve their largest size now
+    ui.time.pixels.reserve((size_t)DIGIT_CHAR_WIDTH * 8 * DIGIT_CHAR_HEIGHT * 4);
+    ui.bpm.pixels.reserve((size_t)DIGIT_CHAR_WIDTH * 3 * DIGIT_CHAR_HEIGHT * 4);
+    ui.percent.pixels.reserve((size_t)DIGIT_CHAR_WIDTH * 3 * DIGIT_CHAR_HEIGHT * 4);
+    ui.quads.reserve(SOFT_RASTER_MAX_QUADS);
+
+    softRasterPoolStart(ui.pool, threads);
+}
+
+static void updateDigitImage(Image& image, char* shown, size_t shownSize, const char* text) {
+    if (strcmp(shown, text) == 0) return;
+    generateDigitImage(image, text);
+    snprintf(shown, shownSize, "%s", text);
+}
+
+const Image& softWatchUiRender(SoftWatchUi& ui, const WatchUiFrame& frame, int size,
+    const Image* perfText, const Image* perfGraph) {
+    watchUiBuild(frame, ui.quads);
+
+    // Like the GL digit textures, only the text on screen is kept current
+    switch (frame.screen) {
+    case 0: updateDigitImage(ui.time, ui.timeText, sizeof(ui.timeText), frame.timeText); break;
+    case 1: updateDigitImage(ui.bpm, ui.bpmText, sizeof(ui.bpmText), frame.bpmText); break;
+    case 2: updateDigitImage(ui.percent, ui.percentText, sizeof(ui.percentText), frame.percentText); break;
+    }
+
+    WatchUiImages images = {};
+    images.images[UI_IMAGE_ARROW_LEFT] = &ui.arrowLeft;
+    images.images[UI_IMAGE_ARROW_RIGHT] = &ui.arrowRight;
+    images.images[UI_IMAGE_EKG] = &ui.ekg;
+    images.images[UI_IMAGE_HEART] = &ui.heart;
+    images.images[UI_IMAGE_TIME] = &ui.time;
+    images.images[UI_IMAGE_BPM] = &ui.bpm;
+    images.images[UI_IMAGE_PERCENT] = &ui.percent;
+    images.images[UI_IMAGE_PERF_TEXT] = perfText;
+    images.images[UI_IMAGE_PERF_GRAPH] = perfGraph;
+
+    CanvasColor clear = { toByte(WATCH_UI_CLEAR_COLOR[0]), toByte(WATCH_UI_CLEAR_COLOR[1]),
+        toByte(WATCH_UI_CLEAR_COLOR[2]), toByte(WATCH_UI_CLEAR_COLOR[3]) };
+    softRasterWatchUi(ui.target, size, clear, ui.quads, images, &ui.pool);
+    return ui.target;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Canvas.h"
+#include "TextureGen.h"
+#include "WatchUi.h"
+
+/*
+ * Software watch UI rasterizer
+ * ----------------------------
+ * Draws the watch UI quad list (WatchUi.h) into an RGBA Image on the CPU,
+ * with the same result as the screen shader drawing it into watchFBO:
+ * texel * color, blended with src alpha / one minus src alpha (alpha
+ * included). It needs no GL context, so the microbenchmarks time it on its
+ * own and the simulator can use it instead of the GL pass (watch_ui = cpu),
+ * uploading the finished screen into the watch screen texture.
+ *
+ * The target is cut into SOFT_RASTER_TILE square tiles. Every tile is
+ * cleared and drawn independently (all quads clipped to it, in order), so
+ * tiles are handed out to a pool of worker threads with no locking beyond
+ * a shared tile counter. Within a tile each quad row is a span: opaque
+ * solid spans are Canvas fills, the others are texel gathers followed by
+ * SSE2 modulate and blend passes over up to a tile's width of pixels.
+ *
+ * Pixels are covered when their center is inside the quad (GL's rule), and
+ * images are sampled nearest-texel: U repeats, V is clamped. The GL path
+ * filters linearly, so magnified images differ in their edges only.
+ */
+
+const int SOFT_RASTER_TILE = 64;        // Tile edge in pixels
+const int SOFT_RASTER_MAX_QUADS = 64;   // Quads past this are not drawn
+
+// Image of each WatchUiImage (RGBA, rows upwards); NULL or empty images are not drawn
+struct WatchUiImages {
+    const Image* images[UI_IMAGE_COUNT];
+};
+
+// Quad converted to pixels once per frame, shared by the tiles
+struct SoftRasterQuad {
+    int x0, y0, x1, y1;        // Covered pixels x0 <= x < x1, y0 <= y < y1 (unclipped)
+    float left, bottom;        // Quad edges in pixels
+    float invWidth, invHeight; // 1 / quad size in pixels
+    float texScaleX, texOffsetX;
+    CanvasColor color;
+    const Image* image;        // NULL = solid color
+};
+
+// One frame of work for the pool
+struct SoftRasterJob {
+    Canvas canvas;
+    CanvasColor clear;
+    int tilesX;
+    int tileCount;
+    int quadCount;
+    SoftRasterQuad quads[SOFT_RASTER_MAX_QUADS];
+    std::atomic<int> nextTile;
+};
+
+/*
+ * Worker threads that stay alive between frames and sleep on a condition
+ * variable in between, so a frame starts no threads and allocates nothing.
+ * The thread calling softRasterWatchUi works on tiles too.
+ */
+struct SoftRasterPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    SoftRasterJob* job = NULL;
+    unsigned long long generation = 0;   // Incremented for each job
+    int running = 0;                     // Workers still on the current job
+    bool stopping = false;
+
+    SoftRasterPool() = default;
+    SoftRasterPool(const SoftRasterPool&) = delete;
+    SoftRasterPool& operator=(const SoftRasterPool&) = delete;
+    ~SoftRasterPool();
+};
+
+/**
+ * Starts the workers, replacing any already running
+ * @param threads Threads drawing tiles including the caller (0 = one per core)
+ */
+void softRasterPoolStart(SoftRasterPool& pool, int threads);
+
+// Joins the workers
+void softRasterPoolStop(SoftRasterPool& pool);
+
+/**
+ * Clears target to size x size RGBA pixels of clear and draws quads over it
+ * target is only resized when its size changes
+ *
+ * @param pool Workers to share the tiles with, or NULL to draw them all on this thread
+ */
+void softRasterWatchUi(Image& target, int size, CanvasColor clear,
+    const std::vector<WatchUiQuad>& quads, const WatchUiImages& images, SoftRasterPool* pool);
+
+// ==================== WATCH SCREEN ====================
+
+/*
+ * Everything the CPU path keeps between frames: its own copies of the
+ * fixed UI images (the GL path frees its copies after uploading), digit
+ * images regenerated when their text changes, and the quad list.
+ */
+struct SoftWatchUi {
+    Image target;
+    Image arrowLeft, arrowRight, ekg, heart;
+    Image time, bpm, percent;
+    char timeText[16] = "";
+    char bpmText[16] = "";
+    char percentText[8] = "";
+    std::vector<WatchUiQuad> quads;
+    SoftRasterPool pool;
+};
+
+/**
+ * Generates the fixed images and starts the pool
+ * @param threads As for softRasterPoolStart
+ */
+void softWatchUiInit(SoftWatchUi& ui, int threads);
+
+/**
+ * Draws the frame's screen at size x size pixels
+ * perfText and perfGraph are the performance screen images (may be NULL on other screens)
+ *
+ * @return ui.target
+ */
+const Image& softWatchUiRender(SoftWatchUi& ui, const WatchUiFrame& frame, int size,
+    const Image* perfText, const Image* perfGraph);
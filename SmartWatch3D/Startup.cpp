@@ -0,0 +1,87 @@
+#include "Startup.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Each engine thread times its own startup
+static thread_local std::chrono::steady_clock::time_point beginTime;
+static thread_local std::chrono::steady_clock::time_point lastMark;
+static thread_local std::vector<StartupPhase> phases;
+
+void startupBegin() {
+    beginTime = std::chrono::steady_clock::now();
+    lastMark = beginTime;
+    phases.clear();
+}
+
+void startupMark(const char* phase) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    StartupPhase p = { phase, std::chrono::duration<double, std::milli>(now - lastMark).count() };
+    phases.push_back(p);
+    lastMark = now;
+}
+
+// ==================== DEPENDENCY GRAPH ====================
+
+static int findStep(const std::vector<StartupStep>& steps, const char* name) {
+    for (size_t i = 0; i < steps.size(); i++) {
+        if (strcmp(steps[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+bool startupRunSteps(const std::vector<StartupStep>& steps) {
+    std::vector<bool> done(steps.size(), false);
+    size_t remaining = steps.size();
+
+    // Each pass runs the first step whose dependencies are all done, so the
+    // list order is kept wherever the dependencies allow it
+    while (remaining > 0) {
+        int next = -1;
+        for (size_t i = 0; i < steps.size() && next < 0; i++) {
+            if (done[i]) continue;
+            bool ready = true;
+            for (const char* dependency : steps[i].dependsOn) {
+                int d = findStep(steps, dependency);
+                if (d < 0 || !done[d]) ready = false;
+            }
+            if (ready) next = (int)i;
+        }
+
+        if (next < 0) {
+            std::cout << "Startup: unknown or circular dependency, skipped:";
+            for (size_t i = 0; i < steps.size(); i++) {
+                if (!done[i]) std::cout << " " << steps[i].name;
+            }
+            std::cout << std::endl;
+            return false;
+        }
+
+        steps[next].run();
+        startupMark(steps[next].name);
+        done[next] = true;
+        remaining--;
+    }
+    return true;
+}
+
+// ==================== REPORT ====================
+
+double startupTotalMs() {
+    return std::chrono::duration<double, std::milli>(lastMark - beginTime).count();
+}
+
+const std::vector<StartupPhase>& startupPhases() {
+    return phases;
+}
+
+void startupReport() {
+    double total = startupTotalMs();
+    printf("Startup phase         ms        %%\n");
+    for (const StartupPhase& p : phases) {
+        printf("  %-16s %8.2f %7.1f\n", p.name, p.ms, total > 0.0 ? p.ms * 100.0 / total : 0.0);
+    }
+    printf("  Time to first frame: %.2f ms\n", total);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+/*
+ * Startup sequence
+ * ----------------
+ * Times everything between main() entry and the first presented frame
+ * (time-to-first-frame) as a list of named phases, and runs the GL
+ * initialization as a small dependency graph: each step names the steps it
+ * needs, and steps run in list order unless a dependency forces otherwise.
+ * Work that the first frame does not need is not in the graph at all; it
+ * is generated in the background and created on first use (see the
+ * TextureJob section in Main.cpp).
+ */
+
+struct StartupPhase {
+    const char* name;
+    double ms;
+};
+
+struct StartupStep {
+    const char* name;
+    std::vector<const char*> dependsOn;  // Names of steps that must run first
+    std::function<void()> run;
+};
+
+// Starts the clock; call first thing in main()
+void startupBegin();
+
+// Ends a phase: records the time since the previous mark under this name
+void startupMark(const char* phase);
+
+/**
+ * Runs every step after the steps it depends on (otherwise in list order)
+ * and marks each one as a phase. Returns false if a dependency is unknown
+ * or circular; the steps that could run have run.
+ */
+bool startupRunSteps(const std::vector<StartupStep>& steps);
+
+// Time from startupBegin() to the last mark
+double startupTotalMs();
+const std::vector<StartupPhase>& startupPhases();
+
+// Prints the phase table and the time-to-first-frame
+void startupReport();
@@ -0,0 +1,119 @@
+#include "Telemetry.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+static const char* SHARED_NAME = "Local\\SmartWatch3DTelemetry";
+static HANDLE mapping = NULL;
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+static const char* SHARED_NAME = "/smartwatch3d_telemetry";
+#endif
+
+static void* view = NULL;
+static bool isWriter = false;
+
+// ==================== MAPPING ====================
+
+static void* mapShared(bool create) {
+    size_t size = sizeof(TelemetryBlock);
+#ifdef _WIN32
+    if (create) {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, SHARED_NAME);
+    }
+    else {
+        mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, SHARED_NAME);
+    }
+    if (mapping == NULL) return NULL;
+    void* p = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (p == NULL) {
+        CloseHandle(mapping);
+        mapping = NULL;
+    }
+    return p;
+#else
+    int fd = create ? shm_open(SHARED_NAME, O_CREAT | O_RDWR, 0644) : shm_open(SHARED_NAME, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    if (create && ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return NULL;
+    }
+    void* p = mmap(NULL, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping keeps the memory alive
+    return p == MAP_FAILED ? NULL : p;
+#endif
+}
+
+TelemetryBlock* telemetryCreate() {
+    view = mapShared(true);
+    if (view == NULL) {
+        std::cout << "Telemetry: could not create shared memory" << std::endl;
+        return NULL;
+    }
+    isWriter = true;
+
+    TelemetryBlock* block = (TelemetryBlock*)view;
+    // Invalidate first so an attached viewer drops the previous run
+    block->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(block->counterNames, 0, sizeof(block->counterNames));
+    memset(block->passNames, 0, sizeof(block->passNames));
+    block->publishedFrames.store(0, std::memory_order_relaxed);
+    block->version = TELEMETRY_VERSION;
+    return block;
+}
+
+const TelemetryBlock* telemetryAttach() {
+    view = mapShared(false);
+    isWriter = false;
+    return (const TelemetryBlock*)view;
+}
+
+void telemetryClose() {
+    if (view == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    mapping = NULL;
+#else
+    munmap(view, sizeof(TelemetryBlock));
+    if (isWriter) shm_unlink(SHARED_NAME);
+#endif
+    view = NULL;
+}
+
+// ==================== RING BUFFER ====================
+
+void telemetryPublish(TelemetryBlock* block, const TelemetryFrame& frame) {
+    unsigned int n = block->publishedFrames.load(std::memory_order_relaxed);
+    block->frames[n % TELEMETRY_RING_SIZE] = frame;
+    block->publishedFrames.store(n + 1, std::memory_order_release);
+}
+
+int telemetryReadLatest(const TelemetryBlock* block, TelemetryFrame* out, int maxCount) {
+    if (maxCount > TELEMETRY_RING_SIZE) maxCount = TELEMETRY_RING_SIZE;
+    unsigned int end = block->publishedFrames.load(std::memory_order_acquire);
+    unsigned int count = end < (unsigned int)maxCount ? end : (unsigned int)maxCount;
+    unsigned int begin = end - count;
+
+    for (unsigned int i = 0; i < count; i++) {
+        out[i] = block->frames[(begin + i) % TELEMETRY_RING_SIZE];
+    }
+
+    // Frames older than this may have been overwritten while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned int after = block->publishedFrames.load(std::memory_order_relaxed);
+    unsigned int firstValid = after > (unsigned int)TELEMETRY_RING_SIZE - 1 ? after - (TELEMETRY_RING_SIZE - 1) : 0;
+    if (firstValid <= begin) return (int)count;
+
+    unsigned int skip = firstValid - begin;
+    if (skip >= count) return 0;
+    memmove(out, out + skip, (count - skip) * sizeof(TelemetryFrame));
+    return (int)(count - skip);
+}
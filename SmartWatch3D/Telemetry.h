@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+
+/*
+ * Live telemetry channel
+ * ----------------------
+ * The profiler publishes every finished frame (frame/CPU time, GPU pass
+ * times, GL counters) into a ring buffer in shared memory, where an
+ * external viewer (TelemetryViewer) can read it while the app runs.
+ * Publishing is a struct copy plus one atomic store; the app never waits
+ * for, or even knows about, readers.
+ *
+ * Protocol: the writer fills frames[n % TELEMETRY_RING_SIZE] and then
+ * stores n + 1 into publishedFrames (release). A reader loads
+ * publishedFrames (acquire), copies the frames it wants and loads the
+ * counter again; frames that the writer may have overwritten meanwhile
+ * (older than the new count minus the ring size) are discarded.
+ *
+ * POSIX shared memory (shm_open) on Linux/macOS, a named file mapping on
+ * Windows. This header has no GL dependency so the viewer builds without it.
+ */
+
+const unsigned int TELEMETRY_MAGIC = 0x44335753;  // "SW3D"
+const unsigned int TELEMETRY_VERSION = 1;
+const int TELEMETRY_RING_SIZE = 256;
+const int TELEMETRY_MAX_COUNTERS = 16;
+const int TELEMETRY_MAX_PASSES = 8;
+const int TELEMETRY_NAME_LENGTH = 24;
+
+struct TelemetryFrame {
+    unsigned int frameNumber;
+    float frameTimeMs;
+    float cpuTimeMs;
+    float gpuPassMs[TELEMETRY_MAX_PASSES];
+    unsigned int counters[TELEMETRY_MAX_COUNTERS];
+};
+
+struct TelemetryBlock {
+    unsigned int magic;       // Written last when the block is set up
+    unsigned int version;
+    unsigned int counterCount;
+    unsigned int passCount;
+    float targetFrameMs;      // Frame budget, for the viewer's graph scale
+    char counterNames[TELEMETRY_MAX_COUNTERS][TELEMETRY_NAME_LENGTH];
+    char passNames[TELEMETRY_MAX_PASSES][TELEMETRY_NAME_LENGTH];
+    // Lock-free 32-bit atomics are address-free, so they work across processes
+    std::atomic<unsigned int> publishedFrames;
+    TelemetryFrame frames[TELEMETRY_RING_SIZE];
+};
+
+// Writer side: creates the shared block (zeroed, magic not yet set)
+TelemetryBlock* telemetryCreate();
+// Reader side: maps an existing block read-only, NULL if no app is running
+const TelemetryBlock* telemetryAttach();
+// Unmaps; the writer also removes the shared memory name
+void telemetryClose();
+
+// Writer: copies one frame into the ring and publishes it
+void telemetryPublish(TelemetryBlock* block, const TelemetryFrame& frame);
+
+// Reader: copies up to maxCount of the newest frames (oldest first) that
+// were not overwritten during the copy; returns how many were copied
+int telemetryReadLatest(const TelemetryBlock* block, TelemetryFrame* out, int maxCount);
@@ -0,0 +1,420 @@
+#define _USE_MATH_DEFINES
+#include "TextureGen.h"
+#include "Canvas.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// ==================== FONT ====================
+
+const unsigned char FONT_DATA[128][7] = {
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 0-3
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 4-7
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 8-11
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 12-15
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 16-19
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 20-23
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 24-27
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 28-31
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // 32 space
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 33-36
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 37-40
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 41-44
+    {0,0,0,0,0,0,0}, // 45
+    {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}, // 46 .
+    {0x01,0x01,0x02,0x04,0x08,0x10,0x10}, // 47 /
+    {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, // 48 0
+    {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // 49 1
+    {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, // 50 2
+    {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // 51 3
+    {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, // 52 4
+    {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // 53 5
+    {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, // 54 6
+    {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // 55 7
+    {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, // 56 8
+    {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // 57 9
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 58-61
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 62-64
+    {0x0E,0x11,0x11,0x1F,0x11,0x11,0x11}, // 65 A
+    {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, // 66 B
+    {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // 67 C
+    {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, // 68 D
+    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // 69 E
+    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, // 70 F
+    {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // 71 G
+    {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, // 72 H
+    {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // 73 I
+    {0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, // 74 J
+    {0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // 75 K
+    {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, // 76 L
+    {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // 77 M
+    {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, // 78 N
+    {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // 79 O
+    {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, // 80 P
+    {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // 81 Q
+    {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, // 82 R
+    {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // 83 S
+    {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, // 84 T
+    {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // 85 U
+    {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, // 86 V
+    {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // 87 W
+    {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, // 88 X
+    {0x11,0x11,0x11,0x0A,0x04,0x04,0x04}, // 89 Y
+    {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, // 90 Z
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 91-94
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 95-96
+    {0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // 97 a
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, // 98 b
+    {0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // 99 c
+    {0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, // 100 d
+    {0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // 101 e
+    {0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, // 102 f
+    {0x00,0x00,0x0F,0x11,0x0F,0x01,0x0E}, // 103 g
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, // 104 h
+    {0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // 105 i
+    {0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, // 106 j
+    {0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // 107 k
+    {0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, // 108 l
+    {0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // 109 m
+    {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, // 110 n
+    {0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // 111 o
+    {0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, // 112 p
+    {0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // 113 q
+    {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, // 114 r
+    {0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // 115 s
+    {0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, // 116 t
+    {0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // 117 u
+    {0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, // 118 v
+    {0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // 119 w
+    {0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, // 120 x
+    {0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // 121 y
+    {0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, // 122 z
+    {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, {0,0,0,0,0,0,0}, // 123-126
+    {0,0,0,0,0,0,0}  // 127
+};
+
+int blitString(unsigned char* data, int width, int height, const char* str,
+    int startX, int startY, int scale,
+    unsigned char r, unsigned char g, unsigned char b) {
+    CanvasColor color = { r, g, b, 255 };
+    return canvasDrawString(makeCanvas(data, width, height, 4), str, startX, startY, scale, color);
+}
+
+// ==================== PROCEDURAL IMAGES ====================
+
+static Canvas resizeImage(Image& image, int width, int height, int channels) {
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels.resize((size_t)width * height * channels);
+    return makeCanvas(image.pixels.data(), width, height, channels);
+}
+
+static const CanvasColor BLANK = { 0, 0, 0, 0 };
+
+/**
+ * Creates the EKG (electrocardiogram) waveform texture
+ * The waveform shows the characteristic PQRST pattern of a heartbeat:
+ * - P wave: small bump (atrial depolarization)
+ * - QRS complex: large spike (ventricular depolarization)
+ * - T wave: medium bump (ventricular repolarization)
+ *
+ * This texture is tiled horizontally to create a scrolling EKG display
+ */
+void generateEKGImage(Image& out) {
+    const int width = 256;
+    const int height = 128;
+    Canvas canvas = resizeImage(out, width, height, 4);
+    canvasClear(canvas, BLANK);
+
+    const CanvasColor green = { 0, 255, 0, 255 };
+    int baseline = height / 2;
+    int lastY = baseline;
+
+    for (int x = 0; x < width; x++) {
+        int y = baseline;
+        float t = (float)x / width;
+
+        if (t < 0.1f) {
+            y = baseline;
+        }
+        else if (t < 0.15f) {
+            float local = (t - 0.1f) / 0.05f;
+            y = baseline - (int)(10 * sin(local * M_PI));
+        }
+        else if (t < 0.25f) {
+            y = baseline;
+        }
+        else if (t < 0.30f) {
+            float local = (t - 0.25f) / 0.05f;
+            y = baseline + (int)(8 * sin(local * M_PI));
+        }
+        else if (t < 0.40f) {
+            float local = (t - 0.30f) / 0.10f;
+            if (local < 0.5f) {
+                y = baseline - (int)(50 * (local * 2));
+            }
+            else {
+                y = baseline - (int)(50 * (1.0f - (local - 0.5f) * 2));
+            }
+        }
+        else if (t < 0.48f) {
+            float local = (t - 0.40f) / 0.08f;
+            y = baseline + (int)(15 * sin(local * M_PI));
+        }
+        else if (t < 0.65f) {
+            float local = (t - 0.48f) / 0.17f;
+            y = baseline - (int)(15 * sin(local * M_PI));
+        }
+        else {
+            y = baseline;
+        }
+
+        // 5 pixel wide column joining the previous sample to this one
+        int minY = (std::min)(lastY, y);
+        int maxY = (std::max)(lastY, y);
+        canvasFillRect(canvas, x - 2, minY, 5, maxY - minY + 1, green);
+        lastY = y;
+    }
+}
+
+void generateArrowImage(Image& out, bool pointRight) {
+    const int size = 64;
+    Canvas canvas = resizeImage(out, size, size, 4);
+    canvasClear(canvas, BLANK);
+
+    const CanvasColor white = { 255, 255, 255, 255 };
+    const int thickness = 7;
+    int cy = size / 2;
+    int tipX = pointRight ? 49 : 15;
+    int headX = pointRight ? 35 : 29;
+
+    canvasDrawLine(canvas, 15, cy, 49, cy, thickness, white);
+    canvasDrawLine(canvas, tipX, cy, headX, cy - 14, thickness, white);
+    canvasDrawLine(canvas, tipX, cy, headX, cy + 14, thickness, white);
+}
+
+void generateHeartImage(Image& out) {
+    const int size = 32;
+    Canvas canvas = resizeImage(out, size, size, 4);
+    canvasClear(canvas, BLANK);
+
+    const CanvasColor red = { 255, 50, 80, 255 };
+    int cx = size / 2;
+    int cy = size / 2;
+
+    // Fill each row's runs of pixels inside the implicit heart curve
+    for (int y = 0; y < size; y++) {
+        int runStart = -1;
+        for (int x = 0; x <= size; x++) {
+            bool inside = false;
+            if (x < size) {
+                float fx = (x - cx) / (float)(size / 2);
+                float fy = (y - cy) / (float)(size / 2);
+                float val = pow(fx * fx + fy * fy - 0.5f, 3) - fx * fx * fy * fy * fy;
+                inside = val < 0;
+            }
+
+            if (inside && runStart < 0) {
+                runStart = x;
+            }
+            else if (!inside && runStart >= 0) {
+                canvasFillSpan(canvas, runStart, x, y, red);
+                runStart = -1;
+            }
+        }
+    }
+}
+
+void generateStudentInfoImage(Image& out) {
+    const int width = 256;
+    const int height = 64;
+    Canvas canvas = resizeImage(out, width, height, 4);
+
+    const CanvasColor background = { 30, 30, 50, 180 };
+    const CanvasColor name = { 255, 255, 255, 255 };
+    const CanvasColor index = { 200, 200, 220, 255 };
+    canvasClear(canvas, background);
+
+    int scale = 2;
+    canvasDrawString(canvas, "Nikola Bandulaja", 10, 50, scale, name);
+    canvasDrawString(canvas, "SV74/2022", 55, 22, scale, index);
+}
+
+void generateDigitImage(Image& out, const char* digitStr) {
+    const int charWidth = DIGIT_CHAR_WIDTH;
+    const int charHeight = DIGIT_CHAR_HEIGHT;
+    int len = (int)strlen(digitStr);
+    int width = charWidth * len;
+    int height = charHeight;
+
+    Canvas canvas = resizeImage(out, width, height, 4);
+    canvasClear(canvas, BLANK);
+
+    const bool segments[12][7] = {
+        {1,1,1,0,1,1,1},
+        {0,0,1,0,0,1,0},
+        {1,0,1,1,1,0,1},
+        {1,0,1,1,0,1,1},
+        {0,1,1,1,0,1,0},
+        {1,1,0,1,0,1,1},
+        {1,1,0,1,1,1,1},
+        {1,0,1,0,0,1,0},
+        {1,1,1,1,1,1,1},
+        {1,1,1,1,0,1,1},
+        {0,0,0,0,0,0,0},
+        {0,0,0,0,0,0,0},
+    };
+
+    const CanvasColor color = { 200, 230, 255, 255 };
+    const int thick = 4;
+    const int margin = 3;
+    const int segW = charWidth - 2 * margin;
+    const int upperY = height / 2 + margin / 2;    // Bottom of the upper vertical segments
+    const int lowerTop = height / 2 - margin / 2;  // Top (exclusive) of the lower vertical segments
+    const int leftX = margin;
+    const int rightX = charWidth - margin - thick + 1;
+
+    // Segment rectangles relative to the character: x, y, w, h
+    const int segmentRects[7][4] = {
+        { leftX,  height - margin - thick + 1, segW,  thick },                       // top
+        { leftX,  upperY,                      thick, height - margin - upperY },    // upper left
+        { rightX, upperY,                      thick, height - margin - upperY },    // upper right
+        { leftX,  height / 2 - thick / 2,      segW,  thick },                       // middle
+        { leftX,  margin,                      thick, lowerTop - margin },           // lower left
+        { rightX, margin,                      thick, lowerTop - margin },           // lower right
+        { leftX,  margin,                      segW,  thick },                       // bottom
+    };
+
+    for (int i = 0; i < len; i++) {
+        char c = digitStr[i];
+        int offsetX = i * charWidth;
+
+        if (c == ':') {
+            int dotSize = 4;
+            int cx = offsetX + charWidth / 2;
+            int extent = dotSize / 2 * 2 + 1;
+            canvasFillRect(canvas, cx - dotSize / 2, height * 3 / 4 - dotSize / 2, extent, extent, color);
+            canvasFillRect(canvas, cx - dotSize / 2, height * 1 / 4 - dotSize / 2, extent, extent, color);
+        }
+        else if (c >= '0' && c <= '9') {
+            int digit = c - '0';
+            for (int s = 0; s < 7; s++) {
+                if (segments[digit][s]) {
+                    const int* r = segmentRects[s];
+                    canvasFillRect(canvas, offsetX + r[0], r[1], r[2], r[3], color);
+                }
+            }
+        }
+    }
+}
+
+void generateGroundImage(Image& out) {
+    const int size = 256;
+    unsigned char* data = resizeImage(out, size, size, 3).pixels;
+
+    srand(12345);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int idx = (y * size + x) * 3;
+            int base = 60 + rand() % 30;
+            data[idx] = base;
+            data[idx + 1] = base + 20 + rand() % 20;
+            data[idx + 2] = base - 20;
+        }
+    }
+}
+
+/**
+ * Continues the rand() sequence seeded by generateGroundImage, so call it right after
+ */
+void generateRoadImage(Image& out) {
+    const int width = 256;
+    const int height = 256;
+    Canvas canvas = resizeImage(out, width, height, 3);
+    unsigned char* data = canvas.pixels;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * 3;
+            int base = 50 + rand() % 15;
+            data[idx] = base;
+            data[idx + 1] = base;
+            data[idx + 2] = base;
+        }
+    }
+
+    // Center line, dashed every 32 rows
+    const CanvasColor paint = { 255, 255, 200, 255 };
+    for (int y = 0; y < height; y += 64) {
+        canvasFillRect(canvas, width / 2 - 4, y, 8, 32, paint);
+    }
+}
+
+const int FACADE_SIZE = 128;
+const int FACADE_STYLES = 4;
+
+/**
+ * Draws one facade style into a FACADE_SIZE square canvas
+ * 0 = punched windows, 1 = glass ribbons, 2 = brick with framed windows, 3 = concrete grid
+ */
+static void drawFacade(const Canvas& canvas, int style) {
+    switch (style) {
+    case 0: {
+        const CanvasColor wall = { 120, 110, 100, 255 };
+        const CanvasColor glass = { 180, 200, 220, 255 };
+        canvasClear(canvas, wall);
+        for (int wy = 0; wy < 4; wy++) {
+            for (int wx = 0; wx < 4; wx++) {
+                canvasFillRect(canvas, 8 + wx * 30, 8 + wy * 30, 18, 20, glass);
+            }
+        }
+        break;
+    }
+    case 1: {
+        const CanvasColor spandrel = { 90, 95, 105, 255 };
+        const CanvasColor glass = { 120, 160, 200, 255 };
+        const CanvasColor mullion = { 70, 75, 85, 255 };
+        canvasClear(canvas, spandrel);
+        for (int band = 0; band < 4; band++) canvasFillRect(canvas, 0, 6 + band * 32, FACADE_SIZE, 20, glass);
+        for (int x = 0; x < FACADE_SIZE; x += 16) canvasFillRect(canvas, x, 0, 2, FACADE_SIZE, mullion);
+        break;
+    }
+    case 2: {
+        const CanvasColor brick = { 140, 80, 60, 255 };
+        const CanvasColor mortar = { 150, 135, 120, 255 };
+        const CanvasColor frame = { 220, 215, 200, 255 };
+        const CanvasColor glass = { 90, 110, 130, 255 };
+        canvasClear(canvas, brick);
+        for (int y = 0; y < FACADE_SIZE; y += 8) canvasFillRect(canvas, 0, y, FACADE_SIZE, 1, mortar);
+        for (int wy = 0; wy < 3; wy++) {
+            for (int wx = 0; wx < 3; wx++) {
+                canvasFillRect(canvas, 12 + wx * 40, 10 + wy * 40, 24, 30, frame);
+                canvasFillRect(canvas, 15 + wx * 40, 13 + wy * 40, 18, 24, glass);
+            }
+        }
+        break;
+    }
+    default: {
+        const CanvasColor concrete = { 165, 162, 150, 255 };
+        const CanvasColor glass = { 60, 70, 90, 255 };
+        canvasClear(canvas, concrete);
+        for (int wy = 0; wy < 6; wy++) {
+            for (int wx = 0; wx < 6; wx++) {
+                canvasFillRect(canvas, 6 + wx * 20, 6 + wy * 20, 10, 12, glass);
+            }
+        }
+        break;
+    }
+    }
+}
+
+void generateBuildingFacades(Image& out, int count) {
+    Canvas canvas = resizeImage(out, FACADE_SIZE, FACADE_SIZE * count, 3);
+    size_t layerBytes = (size_t)FACADE_SIZE * FACADE_SIZE * 3;
+    for (int layer = 0; layer < count; layer++) {
+        drawFacade(makeCanvas(canvas.pixels + layer * layerBytes, FACADE_SIZE, FACADE_SIZE, 3), layer % FACADE_STYLES);
+    }
+}
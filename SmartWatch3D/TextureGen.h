@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+/*
+ * Procedural texture images
+ * -------------------------
+ * CPU half of the procedural textures. Every generator only fills an Image
+ * and never calls OpenGL, so the simulator uploads the result while the
+ * microbenchmarks time the pixel work on its own. Generators resize the
+ * Image they are given, so reusing one Image avoids reallocating.
+ */
+
+struct Image {
+    int width;
+    int height;
+    int channels;   // 3 = RGB, 4 = RGBA, 8 bits each
+    std::vector<unsigned char> pixels;
+};
+
+// Character cell of generateDigitImage
+const int DIGIT_CHAR_WIDTH = 30;
+const int DIGIT_CHAR_HEIGHT = 50;
+
+// 5x7 bitmap font indexed by ASCII code, one byte per row (bit 4 = leftmost column)
+extern const unsigned char FONT_DATA[128][7];
+
+/**
+ * Blits a string into an RGBA buffer using the 5x7 FONT_DATA glyphs
+ * startY is the top row of the text (rows grow upwards in texture space)
+ * Pixels outside the buffer are clipped
+ *
+ * @return X position just after the last character
+ */
+int blitString(unsigned char* data, int width, int height, const char* str,
+    int startX, int startY, int scale,
+    unsigned char r, unsigned char g, unsigned char b);
+
+void generateEKGImage(Image& out);                          // 256x128 RGBA, tiles horizontally
+void generateArrowImage(Image& out, bool pointRight);       // 64x64 RGBA
+void generateHeartImage(Image& out);                        // 32x32 RGBA
+void generateStudentInfoImage(Image& out);                  // 256x64 RGBA
+void generateDigitImage(Image& out, const char* digitStr);  // DIGIT_CHAR_WIDTH x DIGIT_CHAR_HEIGHT RGBA per character (digits and ':')
+void generateGroundImage(Image& out);                       // 256x256 RGB grass, seeds rand()
+void generateRoadImage(Image& out);                         // 256x256 RGB asphalt, call after generateGroundImage
+void generateBuildingFacades(Image& out, int count);        // count 128x128 RGB facades stacked top to bottom (texture array layers)
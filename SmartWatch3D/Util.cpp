@@ -1,4 +1,6 @@
 #include "Util.h"
+#include "GLState.h"
+#include "GLTrace.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -50,7 +52,8 @@ unsigned int compileShader(GLenum type, const char* source)
     return shader;
 }
 
-unsigned int createShader(const char* vsSource, const char* fsSource)
+unsigned int createShader(const char* vsSource, const char* fsSource,
+    const SamplerUnit* samplers, int samplerCount)
 {
     unsigned int program;
     unsigned int vertexShader;
@@ -65,6 +68,14 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     glAttachShader(program, fragmentShader);
 
     glLinkProgram(program);
+
+    // Samplers of different types sharing a unit fail validation
+    if (samplerCount > 0) {
+        glStateUseProgram(program);
+        for (int i = 0; i < samplerCount; i++) {
+            glUniform1i(glGetUniformLocation(program, samplers[i].name), samplers[i].unit);
+        }
+    }
     glValidateProgram(program);
 
     int success;
@@ -97,7 +108,7 @@ unsigned int loadImageToTexture(const char* filePath)
 
     unsigned int texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    glStateBindTexture(0, texture);
 
     GLenum format = GL_RGB;
     if (textureChannels == 1)
@@ -122,22 +133,22 @@ unsigned int loadImageToTexture(const char* filePath)
     return texture;
 }
 
-void setMat4(unsigned int shader, const std::string& name, const glm::mat4& mat) {
-    glUniformMatrix4fv(glGetUniformLocation(shader, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+void setMat4(unsigned int shader, const char* name, const glm::mat4& mat) {
+    glUniformMatrix4fv(glGetUniformLocation(shader, name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
-void setVec3(unsigned int shader, const std::string& name, const glm::vec3& vec) {
-    glUniform3fv(glGetUniformLocation(shader, name.c_str()), 1, glm::value_ptr(vec));
+void setVec3(unsigned int shader, const char* name, const glm::vec3& vec) {
+    glUniform3fv(glGetUniformLocation(shader, name), 1, glm::value_ptr(vec));
 }
 
-void setVec4(unsigned int shader, const std::string& name, const glm::vec4& vec) {
-    glUniform4fv(glGetUniformLocation(shader, name.c_str()), 1, glm::value_ptr(vec));
+void setVec4(unsigned int shader, const char* name, const glm::vec4& vec) {
+    glUniform4fv(glGetUniformLocation(shader, name), 1, glm::value_ptr(vec));
 }
 
-void setFloat(unsigned int shader, const std::string& name, float value) {
-    glUniform1f(glGetUniformLocation(shader, name.c_str()), value);
+void setFloat(unsigned int shader, const char* name, float value) {
+    glUniform1f(glGetUniformLocation(shader, name), value);
 }
 
-void setInt(unsigned int shader, const std::string& name, int value) {
-    glUniform1i(glGetUniformLocation(shader, name.c_str()), value);
+void setInt(unsigned int shader, const char* name, int value) {
+    glUniform1i(glGetUniformLocation(shader, name), value);
 }
@@ -5,16 +5,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
 
+// Texture unit of a sampler uniform, set by createShader
+struct SamplerUnit {
+    const char* name;
+    int unit;
+};
+
 // Shader utility functions
 unsigned int compileShader(GLenum type, const char* source);
-unsigned int createShader(const char* vsSource, const char* fsSource);
+// Samplers not listed keep unit 0; the units are set before the program is validated
+unsigned int createShader(const char* vsSource, const char* fsSource,
+    const SamplerUnit* samplers = NULL, int samplerCount = 0);
 
 // Texture loading
 unsigned int loadImageToTexture(const char* filePath);
 
-// Shader uniform helpers
-void setMat4(unsigned int shader, const std::string& name, const glm::mat4& mat);
-void setVec3(unsigned int shader, const std::string& name, const glm::vec3& vec);
-void setVec4(unsigned int shader, const std::string& name, const glm::vec4& vec);
-void setFloat(unsigned int shader, const std::string& name, float value);
-void setInt(unsigned int shader, const std::string& name, int value);
+// Shader uniform helpers (names are C strings so literals never build a std::string)
+void setMat4(unsigned int shader, const char* name, const glm::mat4& mat);
+void setVec3(unsigned int shader, const char* name, const glm::vec3& vec);
+void setVec4(unsigned int shader, const char* name, const glm::vec4& vec);
+void setFloat(unsigned int shader, const char* name, float value);
+void setInt(unsigned int shader, const char* name, int value);
@@ -0,0 +1,42 @@
+#include "VertexPull.h"
+
+#include <cstddef>
+
+PulledMesh vertexPoolAddMesh(VertexPool& pool, const float* vertices, const VertexLayout& layout,
+    const unsigned int* indices, int count) {
+    PulledMesh mesh;
+    mesh.first = (int)(pool.vertices.size() / PULL_TEXELS_PER_VERTEX);
+    mesh.count = count;
+    pool.vertices.reserve(pool.vertices.size() + (size_t)count * PULL_TEXELS_PER_VERTEX);
+
+    for (int i = 0; i < count; i++) {
+        const float* v = vertices + (size_t)(indices != NULL ? indices[i] : i) * layout.stride;
+        glm::vec3 position(v[0], v[1], layout.positionSize == 3 ? v[2] : 0.0f);
+        glm::vec3 normal(0.0f, 0.0f, 1.0f);
+        glm::vec2 texCoord(0.0f);
+        if (layout.normalOffset >= 0) normal = glm::vec3(v[layout.normalOffset], v[layout.normalOffset + 1], v[layout.normalOffset + 2]);
+        if (layout.texCoordOffset >= 0) texCoord = glm::vec2(v[layout.texCoordOffset], v[layout.texCoordOffset + 1]);
+
+        pool.vertices.push_back(glm::vec4(position, texCoord.x));
+        pool.vertices.push_back(glm::vec4(normal, texCoord.y));
+    }
+    return mesh;
+}
+
+void vertexPoolClearInstances(VertexPool& pool) {
+    pool.instances.clear();
+}
+
+DrawBatch vertexPoolBeginBatch(const VertexPool& pool) {
+    DrawBatch batch;
+    batch.firstInstance = (int)(pool.instances.size() / PULL_TEXELS_PER_INSTANCE);
+    return batch;
+}
+
+void vertexPoolAddInstance(VertexPool& pool, DrawBatch& batch, const glm::mat4& model, const glm::vec3& color,
+    float layer) {
+    // glm is column major: row r is (m[0][r], m[1][r], m[2][r], m[3][r])
+    for (int r = 0; r < 3; r++) pool.instances.push_back(glm::vec4(model[0][r], model[1][r], model[2][r], model[3][r]));
+    pool.instances.push_back(glm::vec4(color, layer));
+    batch.instanceCount++;
+}
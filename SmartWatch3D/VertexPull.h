@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+ * Programmable vertex pulling
+ * ---------------------------
+ * Instead of a VAO per mesh describing its attribute layout, every scene
+ * mesh is converted into one pool of vertices in a common layout, and the
+ * per-object data (model matrix, color, texture layer) goes into an
+ * instance array refilled every pass. Both live in buffer textures
+ * (GL_TEXTURE_BUFFER, core since 3.1), and basic.vert fetches them with
+ * texelFetch by gl_VertexID and uInstanceBase + gl_InstanceID. Nothing is
+ * bound per mesh, so one empty VAO draws every mesh, and all instances of a
+ * mesh that share a material are one glDrawArraysInstanced.
+ *
+ * Layouts, in RGBA32F texels:
+ *   vertex:   (position, u), (normal, v)                   2 texels
+ *   instance: model rows 0..2 (affine), (color rgb, layer)  4 texels
+ *
+ * Meshes are added with their own layout (stride, which attributes exist)
+ * and indexed meshes are expanded to triangle lists, so meshes of mixed
+ * formats share the pool. GL 3.3 guarantees 65536 texels per buffer
+ * texture: 32768 vertices or 16384 instances per pass.
+ */
+
+const int PULL_TEXELS_PER_VERTEX = 2;
+const int PULL_TEXELS_PER_INSTANCE = 4;
+
+// Where the attributes are in a source vertex, in floats (-1 = absent)
+struct VertexLayout {
+    int stride;
+    int positionSize;     // 2 or 3 (z = 0)
+    int normalOffset;     // Absent: (0, 0, 1)
+    int texCoordOffset;   // Absent: (0, 0)
+};
+
+// The layout every VAO mesh uses: position(3) normal(3) texcoord(2)
+const VertexLayout VERTEX_LAYOUT_PNT = { 8, 3, 3, 6 };
+
+// A mesh's vertex range in the pool, drawn as GL_TRIANGLES
+struct PulledMesh {
+    int first = 0;
+    int count = 0;
+};
+
+// Instances drawn together (one mesh, one material), consecutive in the instance array
+struct DrawBatch {
+    int firstInstance = 0;
+    int instanceCount = 0;
+};
+
+struct VertexPool {
+    std::vector<glm::vec4> vertices;    // PULL_TEXELS_PER_VERTEX texels per vertex
+    std::vector<glm::vec4> instances;   // PULL_TEXELS_PER_INSTANCE texels per instance
+};
+
+/**
+ * Appends a mesh to the pool
+ * @param indices Triangle list indices, or NULL when the vertices already are one
+ * @param count Number of indices (or of vertices when indices is NULL)
+ */
+PulledMesh vertexPoolAddMesh(VertexPool& pool, const float* vertices, const VertexLayout& layout,
+    const unsigned int* indices, int count);
+
+// Empties the instance array for the next pass (keeps its capacity)
+void vertexPoolClearInstances(VertexPool& pool);
+
+// Starts a batch at the end of the instance array
+DrawBatch vertexPoolBeginBatch(const VertexPool& pool);
+
+/**
+ * Appends an instance to the batch (which must be the last one begun)
+ * model has to be affine: its bottom row is not stored
+ */
+void vertexPoolAddInstance(VertexPool& pool, DrawBatch& batch, const glm::mat4& model, const glm::vec3& color,
+    float layer = 0.0f);
@@ -0,0 +1,130 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "WatchUi.h"
+
+#include <cstdio>
+
+const char* const WATCH_UI_SCREEN_NAMES[WATCH_UI_SCREEN_COUNT] = { "clock", "heart_rate", "battery", "performance" };
+const float WATCH_UI_CLEAR_COLOR[4] = { 0.05f, 0.05f, 0.1f, 1.0f };
+
+// Navigation arrows, vertically centered at the screen edges
+const float ARROW_SIZE = 0.1f;
+const float ARROW_X = 0.8f;
+
+static void addQuad(std::vector<WatchUiQuad>& out, float x, float y, float w, float h,
+    float r, float g, float b, float a, int image = UI_IMAGE_NONE,
+    float texScaleX = 1.0f, float texOffsetX = 0.0f) {
+    WatchUiQuad quad = { x, y, w, h, r, g, b, a, image, texScaleX, texOffsetX };
+    out.push_back(quad);
+}
+
+static void addArrow(std::vector<WatchUiQuad>& out, bool right) {
+    addQuad(out, right ? ARROW_X : -ARROW_X, 0.0f, ARROW_SIZE, ARROW_SIZE, 1.0f, 1.0f, 1.0f, 1.0f,
+        right ? UI_IMAGE_ARROW_RIGHT : UI_IMAGE_ARROW_LEFT);
+}
+
+void watchUiSetText(WatchUiFrame& frame, int hours, int minutes, int seconds, float bpm, int batteryPercent) {
+    snprintf(frame.timeText, sizeof(frame.timeText), "%02d:%02d:%02d", hours, minutes, seconds);
+    snprintf(frame.bpmText, sizeof(frame.bpmText), "%03d", (int)bpm);
+    snprintf(frame.percentText, sizeof(frame.percentText), "%03d", batteryPercent);
+}
+
+// ==================== SCREENS ====================
+
+static void buildClockScreen(std::vector<WatchUiQuad>& out) {
+    addQuad(out, 0.0f, 0.0f, 0.6f, 0.15f, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_TIME);
+    addArrow(out, true);
+}
+
+static void buildHeartRateScreen(const WatchUiFrame& frame, std::vector<WatchUiQuad>& out) {
+    addArrow(out, false);
+    addArrow(out, true);
+
+    // EKG background and wave
+    addQuad(out, 0.0f, -0.1f, 0.5f, 0.2f, 0.1f, 0.1f, 0.15f, 1.0f);
+    float numRepeats = 3.0f / frame.ekgScale;
+    addQuad(out, 0.0f, -0.1f, 0.48f, 0.18f, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_EKG, numRepeats, frame.ekgOffset);
+
+    // BPM display
+    addQuad(out, 0.0f, 0.25f, 0.2f, 0.1f, 0.0f, 1.0f, 0.4f, 1.0f, UI_IMAGE_BPM);
+
+    // Warning overlay if BPM > 200
+    if (frame.bpm > 200) {
+        addQuad(out, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.3f);
+    }
+}
+
+static void buildBatteryScreen(const WatchUiFrame& frame, std::vector<WatchUiQuad>& out) {
+    addArrow(out, false);
+    addArrow(out, true);
+
+    // Battery outline
+    float battW = 0.3f;
+    float battH = 0.15f;
+    addQuad(out, 0.0f, 0.0f, battW, battH, 0.8f, 0.8f, 0.8f, 1.0f);
+    addQuad(out, 0.0f, 0.0f, battW - 0.02f, battH - 0.02f, 0.1f, 0.1f, 0.15f, 1.0f);
+
+    // Battery cap
+    addQuad(out, battW + 0.02f, 0.0f, 0.02f, 0.06f, 0.8f, 0.8f, 0.8f, 1.0f);
+
+    // Battery fill
+    float fillPercent = frame.batteryPercent / 100.0f;
+    float maxFillW = battW - 0.04f;
+    float fillW = maxFillW * fillPercent;
+    float fillX = -(maxFillW - fillW);
+
+    float r, g, b;
+    if (frame.batteryPercent <= 10) {
+        r = 1.0f; g = 0.2f; b = 0.2f;
+    }
+    else if (frame.batteryPercent <= 20) {
+        r = 1.0f; g = 0.8f; b = 0.0f;
+    }
+    else {
+        r = 0.2f; g = 0.9f; b = 0.3f;
+    }
+
+    if (frame.batteryPercent > 0) {
+        addQuad(out, fillX, 0.0f, fillW, battH - 0.04f, r, g, b, 1.0f);
+    }
+
+    // Percentage display
+    addQuad(out, 0.0f, 0.3f, 0.15f, 0.08f, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_PERCENT);
+}
+
+static void buildPerformanceScreen(std::vector<WatchUiQuad>& out) {
+    addArrow(out, false);
+    addQuad(out, 0.05f, 0.35f, 0.65f, 0.406f, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_PERF_TEXT);
+    addQuad(out, 0.05f, -0.45f, 0.65f, 0.25f, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_PERF_GRAPH);
+}
+
+void watchUiBuild(const WatchUiFrame& frame, std::vector<WatchUiQuad>& out) {
+    out.clear();
+    switch (frame.screen) {
+    case 0: buildClockScreen(out); break;
+    case 1: buildHeartRateScreen(frame, out); break;
+    case 2: buildBatteryScreen(frame, out); break;
+    case 3: buildPerformanceScreen(out); break;
+    }
+
+    // Cursor when in watch view mode
+    if (frame.showCursor) {
+        float cursorSize = 0.04f;
+        addQuad(out, frame.cursorX, frame.cursorY, cursorSize, cursorSize, 1.0f, 1.0f, 1.0f, 1.0f, UI_IMAGE_HEART);
+    }
+}
+
+// ==================== NAVIGATION ====================
+
+static bool isPointInRect(float px, float py, float rx, float ry, float rw, float rh) {
+    return px >= rx - rw && px <= rx + rw && py >= ry - rh && py <= ry + rh;
+}
+
+int watchUiHitTest(int screen, float x, float y) {
+    bool left = isPointInRect(x, y, -ARROW_X, 0.0f, ARROW_SIZE, ARROW_SIZE);
+    bool right = isPointInRect(x, y, ARROW_X, 0.0f, ARROW_SIZE, ARROW_SIZE);
+
+    // The clock has no left arrow, the performance screen no right arrow
+    if (left && screen > 0) return screen - 1;
+    if (right && screen < WATCH_UI_SCREEN_COUNT - 1) return screen + 1;
+    return -1;
+}
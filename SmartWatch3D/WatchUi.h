@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+
+/*
+ * Watch UI layout
+ * ---------------
+ * The watch screens as a list of quads in watch screen space (-1..1, y up),
+ * drawn in list order with alpha blending (src alpha, 1 - src alpha). The GL
+ * path (renderWatchScreen in Main.cpp) and the software rasterizer
+ * (SoftRaster.h) both draw this list, so they always compose the same
+ * screen. Neither knows the layout, and the layout never calls OpenGL.
+ */
+
+const int WATCH_UI_SCREEN_COUNT = 4;
+
+// Screen names for reports, indexed by WatchUiFrame::screen
+extern const char* const WATCH_UI_SCREEN_NAMES[WATCH_UI_SCREEN_COUNT];
+
+// Background of every screen (RGBA)
+extern const float WATCH_UI_CLEAR_COLOR[4];
+
+// Images a quad can be textured with; each renderer maps them to its own texture or Image
+enum WatchUiImage {
+    UI_IMAGE_NONE = -1,      // Solid color
+    UI_IMAGE_ARROW_LEFT,
+    UI_IMAGE_ARROW_RIGHT,
+    UI_IMAGE_EKG,            // Repeats horizontally
+    UI_IMAGE_HEART,          // Cursor
+    UI_IMAGE_TIME,           // Digit image of WatchUiFrame::timeText
+    UI_IMAGE_BPM,            // Digit image of WatchUiFrame::bpmText
+    UI_IMAGE_PERCENT,        // Digit image of WatchUiFrame::percentText
+    UI_IMAGE_PERF_TEXT,      // Performance screen text
+    UI_IMAGE_PERF_GRAPH,     // Performance screen frame-time graph
+    UI_IMAGE_COUNT
+};
+
+struct WatchUiQuad {
+    float x, y;          // Center
+    float w, h;          // Half extents
+    float r, g, b, a;    // Color, multiplied with the image
+    int image;           // WatchUiImage
+    float texScaleX;     // Horizontal image repeats across the quad
+    float texOffsetX;    // Horizontal image scroll
+};
+
+// What the screens show, taken from the simulation each frame
+struct WatchUiFrame {
+    int screen;              // 0 = clock, 1 = heart rate, 2 = battery, 3 = performance
+    char timeText[16];       // HH:MM:SS
+    char bpmText[16];        // Three digits
+    char percentText[8];     // Three digits
+    float bpm;
+    float ekgScale;          // EKG animation speed (more repeats when slower)
+    float ekgOffset;         // EKG scroll
+    int batteryPercent;
+    bool showCursor;
+    float cursorX, cursorY;  // Watch screen space
+};
+
+/**
+ * Fills the frame's text fields from the displayed values
+ */
+void watchUiSetText(WatchUiFrame& frame, int hours, int minutes, int seconds, float bpm, int batteryPercent);
+
+/**
+ * Replaces out with the quads of the frame's screen, in drawing order
+ * out keeps its capacity, so after the first frame this does not allocate
+ */
+void watchUiBuild(const WatchUiFrame& frame, std::vector<WatchUiQuad>& out);
+
+/**
+ * Screen that a click at (x, y) on the given screen navigates to
+ * @return -1 if the click hit no navigation arrow
+ */
+int watchUiHitTest(int screen, float x, float y);
@@ -4,6 +4,8 @@
  * This shader implements the Phong lighting model with two light sources:
  * 1. Main sun light (uLight) - primary scene illumination
  * 2. Watch screen light (uScreenLight) - weak emissive glow from watch
+ * plus optional street lights (uPointLights), off by default and used by
+ * the scaling sweep to measure how cost grows with the light count.
  *
  * PHONG MODEL COMPONENTS:
  * -----------------------
@@ -18,6 +20,14 @@
  *           Depends on view direction and reflected light direction
  *           Formula: pow(max(dot(viewDir, reflectDir), 0.0), shininess)
  *
+ * PROCEDURAL GROUND AND ROAD:
+ * ---------------------------
+ * With uSurface = 1 (grass) or 2 (road) the base color is computed from the
+ * surface position instead of sampled (ground_shading = procedural): value
+ * noise for grass and asphalt, and an analytic dashed center line. Every
+ * octave and the line are filtered over the pixel footprint (fwidth), so
+ * nothing shimmers in the distance without a mip chain.
+ *
  * EMISSIVE MODE:
  * --------------
  * When uIsEmissive=1, the object emits light (like a screen).
@@ -26,6 +36,8 @@
 
 #version 330 core
 
+#define MAX_POINT_LIGHTS 32   // Must match MAX_STREET_LIGHTS in Scene.h
+
 // Light source properties
 struct Light {
     vec3 position;   // World-space position of the light
@@ -46,6 +58,8 @@ struct Material {
 in vec3 fragPos;    // Fragment position in world space
 in vec3 normal;     // Surface normal in world space
 in vec2 texCoord;   // Texture coordinates
+flat in vec4 color; // Solid color (or texture multiplier) of the object
+flat in float layer; // uTextureArray layer of the object
 
 // Output color
 out vec4 outColor;
@@ -53,12 +67,23 @@ out vec4 outColor;
 // Uniforms set from CPU
 uniform Light uLight;         // Main sun light
 uniform Light uScreenLight;   // Watch screen light (weak)
+uniform Light uPointLights[MAX_POINT_LIGHTS];  // Street lights
+uniform int uPointLightCount; // How many of uPointLights are used
 uniform Material uMaterial;   // Current surface material
 uniform vec3 uViewPos;        // Camera position (for specular calculation)
 uniform sampler2D uTexture;   // Texture sampler
 uniform int uUseTexture;      // 1 = sample texture, 0 = use solid color
-uniform vec4 uColor;          // Solid color (or texture multiplier)
+uniform sampler2DArray uTextureArray;  // Building facades (own unit: one unit cannot serve two sampler types)
+uniform int uUseTextureArray; // 1 = sample layer 'layer' of uTextureArray instead of uTexture
 uniform int uIsEmissive;      // 1 = emit light, 0 = receive light
+uniform int uSurface;         // 0 = texture/solid color, 1 = procedural grass, 2 = procedural road
+uniform vec2 uSurfaceScale;   // Meters per texture coordinate unit (procedural surfaces)
+
+const float SEGMENT_LENGTH = 20.0;   // Must match GROUND_SEGMENT_LENGTH in Scene.h
+const float ROAD_CENTER_U = 5.0;     // The ground quad spans u 0..10 (createGroundVAO)
+const float LINE_HALF_WIDTH = 0.075; // Center line, meters
+const float DASH_PERIOD = 5.0;       // Dash + gap, meters (divides SEGMENT_LENGTH)
+const float DASH_DUTY = 0.5;         // Dash share of the period
 
 /**
  * Calculates the contribution of a single light source
@@ -92,6 +117,68 @@ vec3 calculateLight(Light light, vec3 norm, vec3 viewDir, vec3 baseColor) {
     return ambient + diffuse + specular;
 }
 
+// ===== PROCEDURAL SURFACES =====
+
+float hash(ivec2 cell) {
+    uint h = uint(cell.x) * 1664525u ^ uint(cell.y) * 2246822519u;
+    h ^= h >> 15;
+    h *= 2654435769u;
+    h ^= h >> 13;
+    return float(h & 0xFFFFu) / 65535.0;
+}
+
+/**
+ * Value noise in 0..1 on a lattice of cell meters, faded to its mean 0.5
+ * once a cell gets smaller than the pixel footprint
+ * The lattice wraps every SEGMENT_LENGTH along y: the ground segments
+ * repeat there, and their seams would show otherwise.
+ */
+float valueNoise(vec2 p, float cell, float footprint) {
+    vec2 g = p / cell;
+    vec2 i = floor(g);
+    vec2 f = g - i;
+    f = f * f * (3.0 - 2.0 * f);
+
+    int period = int(SEGMENT_LENGTH / cell + 0.5);
+    int x = int(i.x);
+    int y0 = int(mod(i.y, float(period)));
+    int y1 = (y0 + 1) % period;
+    float n = mix(mix(hash(ivec2(x, y0)), hash(ivec2(x + 1, y0)), f.x),
+                  mix(hash(ivec2(x, y1)), hash(ivec2(x + 1, y1)), f.x), f.y);
+    return mix(n, 0.5, smoothstep(0.5 * cell, cell, footprint));
+}
+
+// Share of [x - w/2, x + w/2] inside |x| < halfWidth (box-filtered stripe)
+float filteredStripe(float x, float halfWidth, float w) {
+    return clamp(min(x + 0.5 * w, halfWidth) - max(x - 0.5 * w, -halfWidth), 0.0, w) / w;
+}
+
+// Integral of a pulse train that is 1 for fract(x) < duty
+float pulseIntegral(float x, float duty) {
+    return floor(x) * duty + min(fract(x), duty);
+}
+
+// Same colors as generateGroundImage: r = base, g = base + 20..40, b = base - 20
+vec3 grassColor(vec2 p, float footprint) {
+    float n = 0.5 * valueNoise(p, 2.0, footprint) + 0.3 * valueNoise(p, 0.5, footprint) + 0.2 * valueNoise(p, 0.1, footprint);
+    float base = (60.0 + 30.0 * n) / 255.0;
+    float green = (20.0 + 20.0 * valueNoise(p + vec2(37.0, 0.0), 0.1, footprint)) / 255.0;
+    return vec3(base, base + green, base - 20.0 / 255.0);
+}
+
+// Asphalt as in generateRoadImage (gray 50..65) with a dashed center line
+vec3 roadColor(vec2 p, float footprint) {
+    float n = 0.6 * valueNoise(p, 0.5, footprint) + 0.4 * valueNoise(p, 0.1, footprint);
+    vec3 asphalt = vec3((50.0 + 15.0 * n) / 255.0);
+
+    vec2 w = max(fwidth(p), vec2(1.0e-4));
+    float across = filteredStripe(p.x - ROAD_CENTER_U * uSurfaceScale.x, LINE_HALF_WIDTH, w.x);
+    float y = p.y / DASH_PERIOD;
+    float wy = w.y / DASH_PERIOD;
+    float along = (pulseIntegral(y + 0.5 * wy, DASH_DUTY) - pulseIntegral(y - 0.5 * wy, DASH_DUTY)) / wy;
+    return mix(asphalt, vec3(1.0, 1.0, 200.0 / 255.0), across * along);
+}
+
 void main()
 {
     // Normalize the interpolated normal (interpolation can denormalize it)
@@ -102,10 +189,18 @@ void main()
 
     // Determine base color from texture or solid color
     vec3 baseColor;
-    if (uUseTexture == 1) {
+    if (uSurface != 0) {
+        // Position on the quad in meters; it moves with the scrolling segments, unlike fragPos
+        vec2 p = texCoord * uSurfaceScale;
+        vec2 w = fwidth(p);
+        float footprint = max(w.x, w.y);
+        baseColor = uSurface == 1 ? grassColor(p, footprint) : roadColor(p, footprint);
+    } else if (uUseTextureArray == 1) {
+        baseColor = texture(uTextureArray, vec3(texCoord, layer)).rgb;
+    } else if (uUseTexture == 1) {
         baseColor = texture(uTexture, texCoord).rgb;
     } else {
-        baseColor = uColor.rgb;
+        baseColor = color.rgb;
     }
 
     // Check if this is an emissive surface (like the watch screen)
@@ -113,7 +208,7 @@ void main()
         // EMISSIVE: Object produces its own light
         // Output texture color directly, slightly brightened (1.2x)
         // No lighting calculations - screen is always fully visible
-        outColor = vec4(baseColor * 1.2, uColor.a);
+        outColor = vec4(baseColor * 1.2, color.a);
     } else {
         // NORMAL: Object receives light from light sources
 
@@ -124,6 +219,13 @@ void main()
         // This creates the subtle screen glow effect on nearby surfaces
         result += calculateLight(uScreenLight, norm, viewDir, baseColor) * 0.3;
 
-        outColor = vec4(result, uColor.a);
+        // Street lights fade with distance (constant-linear-quadratic attenuation)
+        for (int i = 0; i < uPointLightCount; i++) {
+            float distance = length(uPointLights[i].position - fragPos);
+            float attenuation = 1.0 / (1.0 + 0.09 * distance + 0.032 * distance * distance);
+            result += calculateLight(uPointLights[i], norm, viewDir, baseColor) * attenuation;
+        }
+
+        outColor = vec4(result, color.a);
     }
 }
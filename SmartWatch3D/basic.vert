@@ -1,3 +1,10 @@
+/*
+ * With uVertexPull = 1 the attributes are not used (an empty VAO is bound):
+ * the vertex and the object's data are fetched from buffer textures by
+ * gl_VertexID and uInstanceBase + gl_InstanceID (see VertexPull.h for the
+ * layouts). Otherwise they come from the mesh's VAO and the uniforms below.
+ */
+
 #version 330 core
 
 layout(location = 0) in vec3 inPos;
@@ -7,15 +14,45 @@ layout(location = 2) in vec2 inTexCoord;
 out vec3 fragPos;
 out vec3 normal;
 out vec2 texCoord;
+flat out vec4 color;
+flat out float layer;
 
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
+uniform vec4 uColor;          // Solid color (or texture multiplier)
+uniform float uLayer;         // Layer of uTextureArray (basic.frag)
+
+uniform int uVertexPull;           // 1 = fetch from uVertices / uInstances
+uniform samplerBuffer uVertices;   // 2 texels per vertex: (position, u), (normal, v)
+uniform samplerBuffer uInstances;  // 4 texels per instance: model rows 0..2, (color, layer)
+uniform int uInstanceBase;         // First instance of the draw
 
 void main()
 {
-    fragPos = vec3(uModel * vec4(inPos, 1.0));
-    normal = mat3(transpose(inverse(uModel))) * inNormal;
+    mat4 model = uModel;
+    vec3 position = inPos;
+    vec3 vertexNormal = inNormal;
     texCoord = inTexCoord;
+    color = uColor;
+    layer = uLayer;
+
+    if (uVertexPull == 1) {
+        vec4 a = texelFetch(uVertices, gl_VertexID * 2);
+        vec4 b = texelFetch(uVertices, gl_VertexID * 2 + 1);
+        position = a.xyz;
+        vertexNormal = b.xyz;
+        texCoord = vec2(a.w, b.w);
+
+        int instance = (uInstanceBase + gl_InstanceID) * 4;
+        model = transpose(mat4(texelFetch(uInstances, instance), texelFetch(uInstances, instance + 1),
+            texelFetch(uInstances, instance + 2), vec4(0.0, 0.0, 0.0, 1.0)));
+        vec4 c = texelFetch(uInstances, instance + 3);
+        color = vec4(c.rgb, 1.0);
+        layer = c.w;
+    }
+
+    fragPos = vec3(model * vec4(position, 1.0));
+    normal = mat3(transpose(inverse(model))) * vertexNormal;
     gl_Position = uProjection * uView * vec4(fragPos, 1.0);
 }
@@ -0,0 +1,22 @@
+#version 330 core
+
+// Converts the watch screen to the panel format (see DisplayFormat.h):
+// q = floor((c * levels + threshold) / 255) with 8-bit c and threshold
+
+out vec4 outColor;
+
+uniform sampler2D uTexture;      // Watch screen (RGBA8)
+uniform sampler2D uThreshold;    // Dither matrix (R8), uThresholdSize texels square
+uniform int uThresholdSize;
+uniform vec3 uLevels;            // 2^bits - 1 per channel
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec3 c = texelFetch(uTexture, pixel, 0).rgb;
+    float t = texelFetch(uThreshold, pixel % uThresholdSize, 0).r;
+
+    // Half a step of margin so float rounding cannot drop a value that is exactly a level
+    vec3 q = floor(c * uLevels + t + 0.5 / 255.0);
+    outColor = vec4(q / uLevels, 1.0);
+}
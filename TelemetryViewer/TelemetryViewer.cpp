@@ -0,0 +1,231 @@
+/*
+ * ============================================================================
+ * SmartWatch 3D - Live Telemetry Viewer
+ * ============================================================================
+ * Attaches to the shared-memory telemetry block published by a running
+ * SmartWatch3D (started with --telemetry) and draws live graphs in the
+ * terminal: a frame-time graph against the frame budget, CPU time, GPU pass
+ * times and the GL counters of the newest frame.
+ *
+ * The viewer only reads; the app never waits for it. It can be started
+ * before or after the app and survives the app restarting.
+ *
+ * USAGE:
+ *   TelemetryViewer [--interval MS] [--width COLUMNS]
+ * ============================================================================
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+const int GRAPH_HEIGHT = 8;
+const int BAR_WIDTH = 40;
+const double STALE_SECONDS = 2.0;   // No new frames for this long = app paused or gone
+
+int refreshIntervalMs = 100;
+int graphWidth = 100;
+
+// ==================== TERMINAL ====================
+
+static void setupTerminal() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(out, &mode)) SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+    printf("\x1b[?25l");  // Hide the cursor
+}
+
+static void restoreTerminal() {
+    printf("\x1b[?25h\n");
+}
+
+static void clearScreen(std::string& out) {
+    out += "\x1b[H\x1b[2J";
+}
+
+static void appendf(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    out += line;
+}
+
+// ==================== GRAPHS ====================
+
+// Eighth-height block characters, index 0 = empty
+static const char* BLOCKS[9] = {
+    " ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"
+};
+
+/**
+ * Column graph of frame times, newest on the right. The scale is at least
+ * twice the frame budget so the budget line sits in the middle; frames over
+ * budget are drawn red.
+ */
+static void drawFrameGraph(std::string& out, const std::vector<TelemetryFrame>& frames, float budgetMs) {
+    int first = std::max(0, (int)frames.size() - graphWidth);
+    float maxMs = budgetMs * 2.0f;
+    for (int i = first; i < (int)frames.size(); i++) maxMs = std::max(maxMs, frames[i].frameTimeMs);
+
+    // Row labels are the top of each row, so the budget sits in the row labeled at or above it
+    int budgetRow = (int)ceil(budgetMs / maxMs * GRAPH_HEIGHT) - 1;
+    for (int row = GRAPH_HEIGHT - 1; row >= 0; row--) {
+        appendf(out, "%7.1f |", maxMs * (row + 1) / GRAPH_HEIGHT);
+        for (int i = first; i < (int)frames.size(); i++) {
+            float height = frames[i].frameTimeMs / maxMs * GRAPH_HEIGHT - row;
+            int eighths = (int)(std::min(std::max(height, 0.0f), 1.0f) * 8.0f + 0.5f);
+            bool over = frames[i].frameTimeMs > budgetMs;
+            if (over) out += "\x1b[31m";
+            out += eighths == 0 && row == budgetRow ? "-" : BLOCKS[eighths];
+            if (over) out += "\x1b[0m";
+        }
+        out += "\n";
+    }
+    appendf(out, "     ms +%s\n", std::string(frames.size() - first, '-').c_str());
+}
+
+static void drawBar(std::string& out, const char* name, float ms, float scaleMs) {
+    int filled = scaleMs > 0.0f ? (int)(std::min(ms / scaleMs, 1.0f) * BAR_WIDTH) : 0;
+    appendf(out, "  %-18s %7.3f ms ", name, ms);
+    for (int i = 0; i < BAR_WIDTH; i++) out += i < filled ? BLOCKS[8] : "·";
+    out += "\n";
+}
+
+static float percentile(std::vector<float> values, float p) {
+    if (values.empty()) return 0.0f;
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p * (values.size() - 1) + 0.5f);
+    return values[index];
+}
+
+// ==================== DISPLAY ====================
+
+static void drawTelemetry(const TelemetryBlock* block, const std::vector<TelemetryFrame>& frames, bool stale) {
+    std::string out;
+    clearScreen(out);
+
+    std::vector<float> frameTimes, cpuTimes;
+    float totalMs = 0.0f;
+    for (const TelemetryFrame& f : frames) {
+        frameTimes.push_back(f.frameTimeMs);
+        cpuTimes.push_back(f.cpuTimeMs);
+        totalMs += f.frameTimeMs;
+    }
+    const TelemetryFrame& last = frames.back();
+    float fps = totalMs > 0.0f ? frames.size() * 1000.0f / totalMs : 0.0f;
+
+    appendf(out, "SmartWatch3D telemetry   frame %u   %s\n\n", last.frameNumber,
+        stale ? "\x1b[33m(no new frames - paused or closed)\x1b[0m" : "\x1b[32m(live)\x1b[0m");
+    appendf(out, "  FPS %6.1f   frame p50 %6.2f  p99 %6.2f ms   cpu p50 %6.2f  p99 %6.2f ms   budget %.2f ms\n\n",
+        fps, percentile(frameTimes, 0.5f), percentile(frameTimes, 0.99f),
+        percentile(cpuTimes, 0.5f), percentile(cpuTimes, 0.99f), block->targetFrameMs);
+
+    drawFrameGraph(out, frames, block->targetFrameMs);
+
+    out += "\nCPU / GPU (newest frame)\n";
+    drawBar(out, "cpu", last.cpuTimeMs, block->targetFrameMs);
+    unsigned int passCount = std::min(block->passCount, (unsigned int)TELEMETRY_MAX_PASSES);
+    for (unsigned int p = 0; p < passCount; p++) {
+        drawBar(out, block->passNames[p], last.gpuPassMs[p], block->targetFrameMs);
+    }
+
+    out += "\nGL counters (newest frame)\n";
+    unsigned int counterCount = std::min(block->counterCount, (unsigned int)TELEMETRY_MAX_COUNTERS);
+    for (unsigned int c = 0; c < counterCount; c++) {
+        appendf(out, "  %-18s %10u\n", block->counterNames[c], last.counters[c]);
+    }
+
+    fputs(out.c_str(), stdout);
+    fflush(stdout);
+}
+
+static void drawWaiting(const char* reason) {
+    std::string out;
+    clearScreen(out);
+    appendf(out, "SmartWatch3D telemetry\n\n  %s\n  Start SmartWatch3D with --telemetry.\n", reason);
+    fputs(out.c_str(), stdout);
+    fflush(stdout);
+}
+
+// ==================== MAIN ====================
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            refreshIntervalMs = std::max(10, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            graphWidth = std::min(std::max(10, atoi(argv[++i])), TELEMETRY_RING_SIZE);
+        }
+        else {
+            printf("Usage: TelemetryViewer [--interval MS] [--width COLUMNS]\n");
+            return 2;
+        }
+    }
+
+    setupTerminal();
+    std::atexit(restoreTerminal);
+
+    const TelemetryBlock* block = NULL;
+    std::vector<TelemetryFrame> frames(TELEMETRY_RING_SIZE);
+    unsigned int lastPublished = 0;
+    auto lastChange = std::chrono::steady_clock::now();
+
+    while (true) {
+        if (block == NULL) {
+            block = telemetryAttach();
+            lastPublished = 0;
+            lastChange = std::chrono::steady_clock::now();
+        }
+
+        if (block == NULL) {
+            drawWaiting("Waiting for a running app...");
+        }
+        else if (block->magic != TELEMETRY_MAGIC || block->version != TELEMETRY_VERSION) {
+            // Not set up yet, or the app shut down: reattach so a new run is found
+            drawWaiting(block->magic == TELEMETRY_MAGIC ? "Telemetry version mismatch." : "Waiting for a running app...");
+            telemetryClose();
+            block = NULL;
+        }
+        else {
+            std::atomic_thread_fence(std::memory_order_acquire);  // Names were written before the magic
+            unsigned int published = block->publishedFrames.load(std::memory_order_acquire);
+            if (published != lastPublished) lastChange = std::chrono::steady_clock::now();
+            lastPublished = published;
+            double idle = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastChange).count();
+
+            int count = telemetryReadLatest(block, frames.data(), TELEMETRY_RING_SIZE);
+            if (count == 0) {
+                drawWaiting("Attached, waiting for the first frame...");
+            }
+            else {
+                std::vector<TelemetryFrame> latest(frames.begin(), frames.begin() + count);
+                drawTelemetry(block, latest, idle > STALE_SECONDS);
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(refreshIntervalMs));
+    }
+}